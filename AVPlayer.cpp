@@ -20,8 +20,18 @@
 #include<QCheckBox>
 #include<QTimer>
 #include<QLabel>
+#include<QSlider>
+#include<QMouseEvent>
+#include<QImage>
+#include<QPixmap>
+#include<QDir>
+#include<QFileInfo>
 
 #include"CppPlayer.h"
+#include"ThumbnailService.h"
+#include"AudioAnalyzer.h"
+#include"AudioMixer.h"
+#include"ClipExporter.h"
 
 
 
@@ -42,8 +52,23 @@ AVPlayer::AVPlayer(QWidget* parent):QWidget(parent){
     pushButton_advance = new QPushButton;
     pushButton_pause = new QPushButton;
     pushButton_restart = new QPushButton;
+    pushButton_export = new QPushButton;
+    checkBox_exact = new QCheckBox;
     checkBox_loop = new QCheckBox;
+    checkBox_live = new QCheckBox;
+    checkBox_fast = new QCheckBox;
+    checkBox_normalize = new QCheckBox;
     label_av = new QLabel;
+    label_waveform = new QLabel;
+    slider_progress = new QSlider(Qt::Horizontal);
+    label_preview = new QLabel(this);
+    thumbnails = new ThumbnailService;
+    previewPts = -1;
+    analyzer = new MediaUse::AudioAnalyzer;
+    waveformWidth = 0;
+    waveformDone = false;
+    exporter = new MediaUse::ClipExporter;
+    exportPending = false;
     hLayout_path = new QHBoxLayout;
     hLayout_operate = new QHBoxLayout;
     vLayout_main = new QVBoxLayout;
@@ -55,20 +80,39 @@ AVPlayer::AVPlayer(QWidget* parent):QWidget(parent){
     pushButton_advance->setText("Advance");
     pushButton_pause->setText("Pause");
     pushButton_restart->setText("Restart");
+    pushButton_export->setText("Export");
+    checkBox_exact->setText("Exact");
     checkBox_loop->setText("Loop");
+    checkBox_live->setText("Live");
+    checkBox_fast->setText("Fast start");
+    checkBox_normalize->setText("Normalize");
     label_av->setText("A/V:");
     label_av->setMaximumHeight(20);
+    label_waveform->setFixedHeight(32);
+    label_waveform->setMinimumWidth(1);
+    slider_progress->setRange(0, 1000);
+    slider_progress->setMouseTracking(true);
+    slider_progress->installEventFilter(this);
+    label_preview->setWindowFlags(Qt::ToolTip);
+    label_preview->hide();
 
     hLayout_path->addWidget(lineEdit_path, 4);
     hLayout_path->addWidget(pushButton_open, 2);
     hLayout_path->addWidget(pushButton_browse, 2);
     hLayout_path->addWidget(checkBox_loop, 1);
+    hLayout_path->addWidget(checkBox_live, 1);
+    hLayout_path->addWidget(checkBox_fast, 1);
+    hLayout_path->addWidget(checkBox_normalize, 1);
     hLayout_operate->addWidget(pushButton_back, 2);
     hLayout_operate->addWidget(pushButton_pause, 2);
     hLayout_operate->addWidget(pushButton_advance, 2);
     hLayout_operate->addWidget(pushButton_restart, 2);
+    hLayout_operate->addWidget(pushButton_export, 2);
+    hLayout_operate->addWidget(checkBox_exact, 1);
     hLayout_operate->addWidget(label_av, 1);
     vLayout_main->addWidget(glWidget, 8);
+    vLayout_main->addWidget(label_waveform, 0);
+    vLayout_main->addWidget(slider_progress, 0);
     vLayout_main->addLayout(hLayout_path, 1);
     vLayout_main->addLayout(hLayout_operate, 1);
     vLayout_main->setMargin(0);
@@ -93,9 +137,12 @@ AVPlayer::AVPlayer(QWidget* parent):QWidget(parent){
 * @Return:       void
 **/
 AVPlayer::~AVPlayer(){
-    if(this->glWidget->isRunning()){
-        this->glWidget->avStop();
+    if(this->glWidget->getEngine().isRunning()){
+        this->glWidget->getEngine().avStop();
     }
+    delete this->thumbnails;
+    delete this->analyzer;
+    delete this->exporter;
 }
 
 
@@ -115,6 +162,10 @@ void AVPlayer::make_connections(){
     connect(pushButton_advance, &QPushButton::clicked, this, &AVPlayer::pushButton_advance_clicked);
     connect(pushButton_pause, &QPushButton::clicked, this, &AVPlayer::pushButton_pause_clicked);
     connect(pushButton_restart, &QPushButton::clicked, this, &AVPlayer::pushButton_restart_clicked);
+    connect(slider_progress, &QSlider::sliderReleased, this, &AVPlayer::slider_progress_released);
+    connect(checkBox_loop, &QCheckBox::toggled, this, &AVPlayer::checkBox_loop_toggled);
+    connect(checkBox_normalize, &QCheckBox::toggled, this, &AVPlayer::checkBox_normalize_toggled);
+    connect(pushButton_export, &QPushButton::clicked, this, &AVPlayer::pushButton_export_clicked);
 
     connect(glWidget, &CppPlayer::toggleFullscreen, this, &AVPlayer::toggleFullscreen);
     connect(glWidget, &CppPlayer::needResize, this, &AVPlayer::updateGL);
@@ -136,12 +187,35 @@ void AVPlayer::pushButton_open_clicked(){
         QMessageBox::information(this,"info","path is empty",QMessageBox::Ok);
         return;
     }
-    if(this->glWidget->isRunning()){
-        this->glWidget->avStop();
+    if(this->glWidget->getEngine().isRunning()){
+        this->glWidget->getEngine().avStop();
     }
-    this->glWidget->setPath(this->lineEdit_path->text().toStdString());
-    if(this->glWidget->avOpen()){
-        this->glWidget->avStart();
+    this->glWidget->getEngine().setPath(this->lineEdit_path->text().toStdString());
+    this->glWidget->getEngine().setLiveMode(this->checkBox_live->isChecked());
+    this->glWidget->getEngine().setFastStart(this->checkBox_fast->isChecked());
+    if(this->glWidget->getEngine().avOpen()){
+        this->glWidget->getEngine().avStart();
+        //缩略图和音频预分析都要另开一个解封装器，直播流和网络地址（没有终点、再次连接代价大）只用于本地文件
+        bool localFile = !this->checkBox_live->isChecked() && QFileInfo(this->lineEdit_path->text()).isFile();
+        //缩略图使用独立解码器，在服务的工作线程中打开，失败（如纯音频）不影响播放
+        if(localFile){
+            QDir().mkpath(QDir::tempPath() + "/CppPlayerThumbnails");
+            this->thumbnails->open(this->lineEdit_path->text().toStdString(), THUMBNAIL_DEFAULT_WIDTH, THUMBNAIL_DEFAULT_MEMORY,
+                (QDir::tempPath() + "/CppPlayerThumbnails").toStdString());
+        }else{
+            this->thumbnails->close();
+        }
+        //音频预分析同样使用独立解码器，缓存命中时立即完成，归一化音量在分析完成后才设置
+        if(localFile){
+            QDir().mkpath(QDir::tempPath() + "/CppPlayerAnalysis");
+            this->analyzer->open(this->lineEdit_path->text().toStdString(), (QDir::tempPath() + "/CppPlayerAnalysis").toStdString());
+        }else{
+            this->analyzer->close();
+        }
+        this->waveformWidth = 0;
+        this->waveformDone = false;
+        this->label_waveform->clear();
+        this->applyNormalizeGain();
     }else{
         QMessageBox::information(this,"info","can not open media",QMessageBox::Ok);
     }
@@ -174,8 +248,8 @@ void AVPlayer::pushButton_browse_clicked(){
 * @Return:       void
 **/
 void AVPlayer::pushButton_back_clicked(){
-    if(this->glWidget->playerCouldBeOperate()){
-        this->glWidget->avBack();
+    if(this->glWidget->getEngine().playerCouldBeOperate()){
+        this->glWidget->getEngine().avBack();
     }
 }
 
@@ -189,8 +263,8 @@ void AVPlayer::pushButton_back_clicked(){
 * @Return:       void
 **/
 void AVPlayer::pushButton_advance_clicked(){
-    if(this->glWidget->playerCouldBeOperate()){
-        this->glWidget->avAdvance();
+    if(this->glWidget->getEngine().playerCouldBeOperate()){
+        this->glWidget->getEngine().avAdvance();
     }
 }
 
@@ -204,8 +278,8 @@ void AVPlayer::pushButton_advance_clicked(){
 * @Return:       void
 **/
 void AVPlayer::pushButton_pause_clicked(){
-    if(!this->glWidget->avPause()){
-        this->glWidget->avResume();
+    if(!this->glWidget->getEngine().avPause()){
+        this->glWidget->getEngine().avResume();
     }
 }
 
@@ -219,7 +293,7 @@ void AVPlayer::pushButton_pause_clicked(){
 * @Return:       void
 **/
 void AVPlayer::pushButton_restart_clicked(){
-    this->glWidget->avRestart();
+    this->glWidget->getEngine().avRestart();
 }
 
 
@@ -227,12 +301,241 @@ void AVPlayer::pushButton_restart_clicked(){
 * @Author:       Li
 * @Date:         2025-03-26
 * @Version:      1.0
-* @Brief:        label_av更新槽函数，每200ms更新当前文件播放时间
+* @Brief:        label_av更新槽函数，每200ms更新当前文件播放时间，直播模式下同时显示延迟，导出中显示进度，并更新波形和归一化音量
 * @Param:        void
 * @Return:       void
 **/
 void AVPlayer::label_av_update(){
-    this->label_av->setText(QString("A/V: ")+QString::number(this->glWidget->getCurrentPts().first / 1000000.0f,'f',2));
+    QString text = QString("A/V: ")+QString::number(this->glWidget->getEngine().getCurrentPts().first / 1000000.0f,'f',2);
+    if(this->glWidget->getEngine().isLiveMode()){
+        //附加延迟只是第一个packet到达之后增加的滞后，源提供发送端时钟时同时显示端到端延迟
+        text += QString("  added: ")+QString::number(this->glWidget->getEngine().getLiveAddedLatency() / 1000.0f,'f',0)+QString("ms");
+        if(this->glWidget->getEngine().getLiveEndToEndLatency() >= 0){
+            text += QString("  e2e: ")+QString::number(this->glWidget->getEngine().getLiveEndToEndLatency() / 1000.0f,'f',0)+QString("ms");
+        }
+    }
+    if(this->exporter->isRunning()){
+        text += QString("  export: ")+QString::number(this->exporter->getProgress() * 100.0f,'f',0)+QString("%");
+    }else if(this->exportPending){
+        this->exportPending = false;
+        this->pushButton_export->setText("Export");
+        if(this->exporter->getResult() == CLIPEXPORTER_OK){
+            QMessageBox::information(this,"info",this->exporter->wasExact() ? "export finished" : "export finished (cut at keyframe)",QMessageBox::Ok);
+        }else if(this->exporter->getResult() != CLIPEXPORTER_ERROR_CANCELED){
+            QMessageBox::information(this,"info","export failed",QMessageBox::Ok);
+        }
+    }
+    this->label_av->setText(text);
+    if(!this->slider_progress->isSliderDown() && this->glWidget->getEngine().getDuration().first > 0){
+        this->slider_progress->setValue((int)(this->glWidget->getEngine().getCurrentPts().first * 1000 / this->glWidget->getEngine().getDuration().first));
+    }
+    if(this->previewPts >= 0){//缩略图可能在悬停后才解码完成
+        this->label_preview_update();
+    }
+    this->label_waveform_update();
+    this->applyNormalizeGain();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        进度条释放槽函数，跳转到进度条对应的时间
+* @Param:        void
+* @Return:       void
+**/
+void AVPlayer::slider_progress_released(){
+    int64_t pts = this->glWidget->getEngine().getDuration().first * this->slider_progress->value() / 1000;
+    this->glWidget->getEngine().setCurrentPts(std::pair<int64_t, AVRational>(pts, AVRational{ 1,AV_TIME_BASE }));
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        进度条事件过滤，鼠标悬停时请求并显示缩略图，离开时隐藏
+* @Param:        @obj (QObject *) 事件对象
+*                @e (QEvent *) 事件
+* @Return:       bool 是否拦截事件（始终不拦截）
+**/
+bool AVPlayer::eventFilter(QObject* obj, QEvent* e){
+    if(obj == this->slider_progress && this->thumbnails->getDuration() > 0){
+        if(e->type() == QEvent::MouseMove){
+            int x = static_cast<QMouseEvent*>(e)->pos().x();
+            int w = this->slider_progress->width() > 0 ? this->slider_progress->width() : 1;
+            if(x < 0) x = 0;
+            if(x > w) x = w;
+            this->previewPts = this->thumbnails->getDuration() * x / w;
+            this->label_preview_update();
+        }else if(e->type() == QEvent::Leave){
+            this->previewPts = -1;
+            this->label_preview->hide();
+        }
+    }
+    return QWidget::eventFilter(obj, e);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        按previewPts更新缩略图预览窗口，缩略图还没有生成时只发出请求
+* @Param:        void
+* @Return:       void
+**/
+void AVPlayer::label_preview_update(){
+    std::vector<unsigned char> rgb;
+    int w = this->thumbnails->getWidth();
+    int h = this->thumbnails->getHeight();
+    int x = 0;
+    if(!this->thumbnails->getThumbnail(this->previewPts, rgb)){
+        return;
+    }
+    QImage img(rgb.data(), w, h, w * 3, QImage::Format_RGB888);
+    this->label_preview->setPixmap(QPixmap::fromImage(img.copy()));
+    this->label_preview->setFixedSize(w, h);
+    x = (int)(this->previewPts * this->slider_progress->width() / this->thumbnails->getDuration());
+    this->label_preview->move(this->slider_progress->mapToGlobal(QPoint(x - w / 2, -h - 4)));
+    this->label_preview->show();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        绘制整个文件的波形（浅色为峰值，深色为RMS），分析中随进度增长，分析完成或宽度变化后重绘一次即不再更新
+* @Param:        void
+* @Return:       void
+**/
+void AVPlayer::label_waveform_update(){
+    std::vector<float> peak;
+    std::vector<float> rms;
+    std::vector<unsigned char> rgb;
+    int w = this->label_waveform->width();
+    int h = this->label_waveform->height();
+    int half = h / 2;
+    int p = 0;
+    int r = 0;
+    int d = 0;
+    unsigned char* pixel = nullptr;
+    bool done = this->analyzer->isDone();
+    if(w <= 1 || h <= 1 || (w == this->waveformWidth && this->waveformDone)){
+        return;
+    }
+    if(!this->analyzer->getWaveform(0, this->analyzer->getDuration(), w, peak, rms)){
+        return;
+    }
+    rgb.resize((size_t)w * h * 3);
+    for(int x = 0; x < w; x++){
+        p = std::min(half, (int)(peak[x] * half + 0.5f));
+        r = std::min(half, (int)(rms[x] * half + 0.5f));
+        for(int y = 0; y < h; y++){
+            pixel = rgb.data() + ((size_t)y * w + x) * 3;
+            d = y < half ? half - y : y - half + 1;//到中线的距离
+            if(d <= r){
+                pixel[0] = 0x40; pixel[1] = 0x90; pixel[2] = 0xe0;
+            }else if(d <= p){
+                pixel[0] = 0x90; pixel[1] = 0xc0; pixel[2] = 0xf0;
+            }else{
+                pixel[0] = 0x20; pixel[1] = 0x20; pixel[2] = 0x20;
+            }
+        }
+    }
+    QImage img(rgb.data(), w, h, w * 3, QImage::Format_RGB888);
+    this->label_waveform->setPixmap(QPixmap::fromImage(img.copy()));
+    this->waveformWidth = w;
+    this->waveformDone = done;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        按复选框和分析结果设置本播放器通道的归一化音量（OpenAL source的AL_GAIN），分析未完成或未勾选时为1
+* @Param:        void
+* @Return:       void
+**/
+void AVPlayer::applyNormalizeGain(){
+    int channel = this->glWidget->getMixerChannel();
+    float gain = this->checkBox_normalize->isChecked() ? this->analyzer->getNormalizeGain() : 1.0f;
+    if(gain != MediaUse::AudioMixer::global().getNormalizeGain(channel)){
+        MediaUse::AudioMixer::global().setNormalizeGain(channel, gain);
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        响度归一化复选框槽函数，勾选后按预分析的积分响度把音量调整到-23LUFS
+* @Param:        @checked bool
+* @Return:       void
+**/
+void AVPlayer::checkBox_normalize_toggled(bool checked){
+    (void)checked;
+    this->applyNormalizeGain();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        导出按键槽函数，把A键标记的入点到B键标记的出点（没有出点时到文件末尾）之间的片段复制到新文件，
+*                使用独立的解封装器，不影响播放；导出中再次按下取消
+* @Param:        void
+* @Return:       void
+**/
+void AVPlayer::pushButton_export_clicked(){
+    std::string path = this->glWidget->getEngine().getPath();
+    int64_t in = this->glWidget->getEngine().getLoopStart();
+    int64_t out = this->glWidget->getEngine().getLoopEnd();
+    size_t dot = path.find_last_of('.');
+    QString output;
+    if(this->exporter->isRunning()){
+        this->exporter->cancel();
+        return;
+    }
+    if(path.empty() || this->glWidget->getEngine().isLiveMode()){
+        QMessageBox::information(this,"info","no file to export",QMessageBox::Ok);
+        return;
+    }
+    if(in < 0){
+        QMessageBox::information(this,"info","mark the in point with A (and the out point with B) first",QMessageBox::Ok);
+        return;
+    }
+    if(out < 0){
+        out = this->glWidget->getEngine().getDuration().first;
+    }
+    //默认输出为 原文件名_clip.原扩展名，容器格式由扩展名决定
+    output = QFileDialog::getSaveFileName(nullptr,"export clip",
+        QString::fromStdString(dot == std::string::npos ? path + "_clip.mp4" : path.substr(0, dot) + "_clip" + path.substr(dot)),"all files(*.*)");
+    if(output.isEmpty()){
+        return;
+    }
+    if(this->exporter->start(path, output.toStdString(), in, out, this->checkBox_exact->isChecked())){
+        this->exportPending = true;
+        this->pushButton_export->setText("Cancel");
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        循环复选框槽函数，勾选时引擎无缝循环（文件末尾直接接上开头），引擎无法衔接时仍由shouldLoop重播
+* @Param:        @checked bool
+* @Return:       void
+**/
+void AVPlayer::checkBox_loop_toggled(bool checked){
+    this->glWidget->getEngine().setSeamlessLoop(checked);
 }
 
 
@@ -246,7 +549,7 @@ void AVPlayer::label_av_update(){
 **/
 void AVPlayer::shouldLoop(){
     if(this->checkBox_loop->isChecked()){
-        this->glWidget->avRestart();
+        this->glWidget->getEngine().avRestart();
     }
 }
 
@@ -267,15 +570,22 @@ void AVPlayer::toggleFullscreen(bool fs){
     pushButton_advance->setVisible(!fs);
     pushButton_pause->setVisible(!fs);
     pushButton_restart->setVisible(!fs);
+    pushButton_export->setVisible(!fs);
+    checkBox_exact->setVisible(!fs);
     checkBox_loop->setVisible(!fs);
+    checkBox_live->setVisible(!fs);
+    checkBox_fast->setVisible(!fs);
+    checkBox_normalize->setVisible(!fs);
+    label_waveform->setVisible(!fs);
+    slider_progress->setVisible(!fs);
     label_av->setVisible(!fs);
     if (fs) {
-        vLayout_main->setStretch(1, 0);
-        vLayout_main->setStretch(2, 0);
+        vLayout_main->setStretch(3, 0);
+        vLayout_main->setStretch(4, 0);
         showFullScreen();
     } else {
-        vLayout_main->setStretch(1, 1);
-        vLayout_main->setStretch(2, 1);
+        vLayout_main->setStretch(3, 1);
+        vLayout_main->setStretch(4, 1);
         showNormal();
     }
 }
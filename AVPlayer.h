@@ -19,6 +19,10 @@ class QHBoxLayout;
 class QVBoxLayout;
 class QCheckBox;
 class QLabel;
+class QSlider;
+class QEvent;
+class ThumbnailService;
+namespace MediaUse { class AudioAnalyzer; class ClipExporter; }
 
 
 
@@ -35,9 +39,16 @@ public:
     AVPlayer(QWidget* parent = nullptr);
     ~AVPlayer();
 
+protected:
+
+    bool eventFilter(QObject* obj, QEvent* e);
+
 private:
 
     void make_connections();
+    void label_preview_update();
+    void label_waveform_update();
+    void applyNormalizeGain();
 
 private slots:
 
@@ -48,6 +59,10 @@ private slots:
     void pushButton_pause_clicked();
     void pushButton_restart_clicked();
     void label_av_update();
+    void slider_progress_released();
+    void checkBox_loop_toggled(bool checked);
+    void checkBox_normalize_toggled(bool checked);
+    void pushButton_export_clicked();
 
     void toggleFullscreen(bool fs);
     void updateGL();
@@ -62,8 +77,16 @@ private:
     QPushButton* pushButton_advance;//快进按键
     QPushButton* pushButton_pause;//暂停按键
     QPushButton* pushButton_restart;//重播按键
+    QPushButton* pushButton_export;//导出按键，导出A/B键标记的入点到出点之间的片段，导出中再次按下取消
+    QCheckBox* checkBox_exact;//精确剪切选择框，不勾选时从入点之前的关键帧开始导出
     QCheckBox* checkBox_loop;//循环选择框
+    QCheckBox* checkBox_live;//直播模式选择框（RTSP/UDP等低延迟播放）
+    QCheckBox* checkBox_fast;//快速启动选择框（缩短探测、少量预缓冲即开始播放），打开时生效
+    QCheckBox* checkBox_normalize;//响度归一化选择框
     QLabel* label_av;//实时显示播放时间
+    QLabel* label_waveform;//进度条上方的整个文件的音频波形
+    QSlider* slider_progress;//进度条，拖动跳转，悬停显示缩略图
+    QLabel* label_preview;//进度条悬停时的缩略图预览（悬浮窗口）
 
     //布局
     /**
@@ -77,6 +100,10 @@ private:
     *         |                                                          |  \
     *         |                                                          |
     *         |__________________________________________________________|
+    *         |                     label_waveform                       |
+    *         |__________________________________________________________|
+    *         |                     slider_progress                      |
+    *         |__________________________________________________________|
     *         |                                                          |
     *         |                     hLayout_path                         |
     *         |__________________________________________________________|
@@ -91,6 +118,19 @@ private:
 
     CppPlayer* glWidget;
 
+    //缩略图服务，使用独立的解码器为进度条悬停预览生成关键帧缩略图
+    ThumbnailService* thumbnails;
+    int64_t previewPts;//当前悬停位置对应的时间，-1表示没有悬停
+
+    //音频预分析，使用独立的解码器生成波形和响度，结果缓存到磁盘
+    MediaUse::AudioAnalyzer* analyzer;
+    int waveformWidth;//已绘制的波形宽度，宽度变化或分析完成时重绘
+    bool waveformDone;
+
+    //片段导出，在后台线程按packet复制
+    MediaUse::ClipExporter* exporter;
+    bool exportPending;//导出结束后提示一次
+
 };
 
 #endif // AVPLAYER_H
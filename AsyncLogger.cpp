@@ -0,0 +1,376 @@
+#include "AsyncLogger.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  AsyncLogger.h的实现
+**/
+
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+using namespace MediaUse;
+
+
+namespace {
+
+    //每个logger实例的唯一编号，线程局部缓存用它判断缓存的缓冲是否属于当前logger
+    std::atomic<uint64_t> loggerNextId(1);
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  线程局部的缓冲缓存，一个线程一般只写一两个logger
+    **/
+    struct LoggerThreadCache {
+        uint64_t id[4];
+        LogThreadBuffer* buffer[4];
+        int next;
+    };
+
+    thread_local LoggerThreadCache loggerThreadCache = { { 0,0,0,0 }, { nullptr,nullptr,nullptr,nullptr }, 0 };
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        单调时钟
+    * @Param:        void
+    * @Return:       int64_t us
+    **/
+    int64_t loggerNow() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        FNV-1a，用于限频时区分消息
+    * @Param:        @text (const char*) 消息
+    * @Return:       uint32_t
+    **/
+    uint32_t loggerHash(const char* text) {
+        uint32_t hash = 2166136261u;
+        for (int i = 0; text[i] && i < ASYNCLOGGER_TEXT_SIZE; i++) {
+            hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    const char* loggerLevelName[] = { "DEBUG", "INFO ", "WARN ", "ERROR" };
+
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数，默认等级为INFO
+* @Param:        void
+* @Return:       void
+**/
+AsyncLogger::AsyncLogger() :opened(false), level(ASYNCLOGGER_LEVEL_INFO), rateLimitPerSecond(ASYNCLOGGER_RATE_LIMIT),
+    id(loggerNextId++), origin(loggerNow()), nextTid(1), threadShouldEnd(false), thread(nullptr) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，写完剩余记录并释放缓冲
+* @Param:        void
+* @Return:       void
+**/
+AsyncLogger::~AsyncLogger() {
+    this->close();
+    for (auto i : this->buffers) {
+        delete i;
+    }
+    this->buffers.clear();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开日志文件并启动后台写入线程，已打开时先关闭。会释放之前的线程缓冲，
+*                调用时不能有其他线程正在写这个logger（CppPlayer在setPath时调用，此时播放线程都已结束）
+* @Param:        @path (const std::string&) 日志文件路径
+* @Return:       bool 成功返回true
+**/
+bool AsyncLogger::open(const std::string& path) {
+    this->close();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->id.store(loggerNextId++);
+    for (auto i : this->buffers) {
+        delete i;
+    }
+    this->buffers.clear();
+    this->nextTid = 1;
+    this->file.open(path, std::ios_base::out);
+    if (!this->file.is_open()) return false;
+    this->origin = loggerNow();
+    this->threadShouldEnd = false;
+    this->opened.store(true);
+    this->thread = new std::thread(&AsyncLogger::writerThread, this);
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        停止后台线程，写完剩余记录后关闭文件
+* @Param:        void
+* @Return:       void
+**/
+void AsyncLogger::close() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (!this->thread) return;
+    this->opened.store(false);
+    this->threadShouldEnd = true;
+    lock.unlock();
+    this->cv.notify_all();
+    this->thread->join();
+    delete this->thread;
+    lock.lock();
+    this->thread = nullptr;
+    this->drain();
+    this->file.close();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否已打开
+* @Param:        void
+* @Return:       bool
+**/
+bool AsyncLogger::isOpen() {
+    return this->opened.load(std::memory_order_relaxed);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        写入一条日志，低于当前等级或超过限频时直接返回，缓冲已满时丢弃并计数
+* @Param:        @level uint8_t ASYNCLOGGER_LEVEL_xxx
+*                @text (const char*) 消息，超过ASYNCLOGGER_TEXT_SIZE截断
+* @Return:       void
+**/
+void AsyncLogger::write(uint8_t level, const char* text) {
+    LogThreadBuffer* buffer = nullptr;
+    LogRecord record;
+    uint32_t suppressed = 0;
+    size_t length = 0;
+    int prefix = 0;
+    if (level < this->level.load(std::memory_order_relaxed) || !this->isOpen() || !text) return;
+    buffer = this->threadBuffer();
+    record.time = loggerNow() - this->origin;
+    if (!this->rateLimit(buffer, text, record.time, suppressed)) return;
+    record.tid = buffer->tid;
+    record.level = level > ASYNCLOGGER_LEVEL_ERROR ? ASYNCLOGGER_LEVEL_ERROR : level;
+    if (suppressed) {//上一秒被限频丢弃的次数附在这一条前面
+        prefix = snprintf(record.text, sizeof(record.text), "(+%u suppressed) ", suppressed);
+        if (prefix < 0 || prefix >= (int)sizeof(record.text)) prefix = 0;
+    }
+    length = strlen(text);
+    if (length > sizeof(record.text) - 1 - prefix) length = sizeof(record.text) - 1 - prefix;
+    std::memcpy(record.text + prefix, text, length);
+    record.text[prefix + length] = '\0';
+    if (!buffer->ring.push(record)) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (buffer->ring.size() > ASYNCLOGGER_BUFFER_RECORDS / 2) this->cv.notify_one();//缓冲过半时提前唤醒写入线程
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置日志等级，低于该等级的日志不记录
+* @Param:        @level uint8_t ASYNCLOGGER_LEVEL_xxx
+* @Return:       void
+**/
+void AsyncLogger::setLevel(uint8_t level) {
+    this->level.store(level);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取日志等级
+* @Param:        void
+* @Return:       uint8_t
+**/
+uint8_t AsyncLogger::getLevel() {
+    return this->level.load();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置同一条消息（每个线程单独计算）每秒最多记录的次数
+* @Param:        @perSecond uint32_t 0表示不限频
+* @Return:       void
+**/
+void AsyncLogger::setRateLimit(uint32_t perSecond) {
+    this->rateLimitPerSecond.store(perSecond);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        根据消息前缀（DEBUG::/INFO::/WARNNING::/ERROR::）推断等级，其他前缀视为INFO
+* @Param:        @text (const char*) 消息
+* @Return:       uint8_t ASYNCLOGGER_LEVEL_xxx
+**/
+uint8_t AsyncLogger::levelOf(const char* text) {
+    if (!text) return ASYNCLOGGER_LEVEL_INFO;
+    if (std::strncmp(text, "ERROR", 5) == 0) return ASYNCLOGGER_LEVEL_ERROR;
+    if (std::strncmp(text, "WARN", 4) == 0) return ASYNCLOGGER_LEVEL_WARN;
+    if (std::strncmp(text, "DEBUG", 5) == 0) return ASYNCLOGGER_LEVEL_DEBUG;
+    return ASYNCLOGGER_LEVEL_INFO;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取当前线程在这个logger中的缓冲，先查线程局部缓存，未命中时加锁查找或创建
+*                （按线程id查找，线程结束后id被新线程复用时缓冲也随之复用）
+* @Param:        void
+* @Return:       LogThreadBuffer*
+**/
+LogThreadBuffer* AsyncLogger::threadBuffer() {
+    LoggerThreadCache& cache = loggerThreadCache;
+    LogThreadBuffer* buffer = nullptr;
+    uint64_t loggerId = this->id.load(std::memory_order_relaxed);
+    std::thread::id self = std::this_thread::get_id();
+    for (int i = 0; i < 4; i++) {
+        if (cache.id[i] == loggerId) return cache.buffer[i];
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        for (auto i : this->buffers) {
+            if (i->owner == self) {
+                buffer = i;
+                break;
+            }
+        }
+        if (!buffer) {
+            buffer = new LogThreadBuffer;
+            buffer->ring.setCapacity(ASYNCLOGGER_BUFFER_RECORDS);
+            buffer->owner = self;
+            buffer->tid = this->nextTid++;
+            buffer->dropped.store(0);
+            std::memset(buffer->rate, 0, sizeof(buffer->rate));
+            this->buffers.push_back(buffer);
+        }
+    }
+    cache.id[cache.next] = loggerId;
+    cache.buffer[cache.next] = buffer;
+    cache.next = (cache.next + 1) % 4;
+    return buffer;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        限频判断，同一消息每秒超过上限的部分被丢弃，下一秒第一条记录时返回被丢弃的次数
+*                限频表满（哈希冲突）时用新消息覆盖旧的槽位
+* @Param:        @buffer (LogThreadBuffer*) 当前线程缓冲
+*                @text (const char*) 消息
+*                @time int64_t 当前时间（us）
+*                @suppressed (uint32_t&) 输出上一个窗口被丢弃的次数
+* @Return:       bool 需要记录返回true
+**/
+bool AsyncLogger::rateLimit(LogThreadBuffer* buffer, const char* text, int64_t time, uint32_t& suppressed) {
+    uint32_t limit = this->rateLimitPerSecond.load(std::memory_order_relaxed);
+    uint32_t hash = 0;
+    int64_t second = time / 1000000;
+    LogThreadBuffer::RateSlot* slot = nullptr;
+    if (limit == 0) return true;
+    hash = loggerHash(text);
+    slot = &buffer->rate[hash % ASYNCLOGGER_RATE_SLOTS];
+    if (slot->hash != hash || slot->second != second) {
+        suppressed = slot->hash == hash ? slot->suppressed : 0;
+        slot->hash = hash;
+        slot->second = second;
+        slot->count = 0;
+        slot->suppressed = 0;
+    }
+    if (slot->count >= limit) {
+        slot->suppressed++;
+        return false;
+    }
+    slot->count++;
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        后台写入线程，每ASYNCLOGGER_FLUSH_INTERVAL毫秒（或缓冲过半时）批量写入一次
+* @Param:        void
+* @Return:       void
+**/
+void AsyncLogger::writerThread() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (!this->threadShouldEnd) {
+        this->cv.wait_for(lock, std::chrono::milliseconds(ASYNCLOGGER_FLUSH_INTERVAL));
+        this->drain();
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        取出全部线程缓冲的记录写入文件并flush一次，需要持有mutex
+* @Param:        void
+* @Return:       void
+**/
+void AsyncLogger::drain() {
+    LogRecord record;
+    uint64_t dropped = 0;
+    char head[64] = { 0 };
+    bool written = false;
+    if (!this->file.is_open()) return;
+    for (auto i : this->buffers) {
+        while (i->ring.pop(record)) {
+            this->batch.push_back(record);
+        }
+        dropped = i->dropped.exchange(0);
+        if (dropped) {
+            this->file << "[LOGGER] thread T" << i->tid << " buffer full, dropped " << dropped << " records\n";
+            written = true;
+        }
+    }
+    std::stable_sort(this->batch.begin(), this->batch.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.time < b.time;
+    });
+    for (auto& i : this->batch) {
+        snprintf(head, sizeof(head), "[%10.3f][%s][T%u] ", i.time / 1000000.0, loggerLevelName[i.level], i.tid);
+        this->file << head << i.text << '\n';
+        written = true;
+    }
+    this->batch.clear();
+    if (written) this->file.flush();
+}
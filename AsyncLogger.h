@@ -0,0 +1,123 @@
+#ifndef _ASYNCLOGGER_H_
+#define _ASYNCLOGGER_H_
+
+/**
+* @File name:    AsyncLogger.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  异步日志：调用线程只把记录写入自己的无锁环形缓冲（不加锁、不做系统调用），
+*                后台线程定时取出并批量写入文件；支持运行时日志等级和按消息限频
+**/
+
+
+#include <string>
+#include <list>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <condition_variable>
+#include <cstdint>
+#include "MediaUse.h"
+
+
+#define ASYNCLOGGER_LEVEL_DEBUG         (0x00)
+#define ASYNCLOGGER_LEVEL_INFO          (0x01)
+#define ASYNCLOGGER_LEVEL_WARN          (0x02)
+#define ASYNCLOGGER_LEVEL_ERROR         (0x03)
+#define ASYNCLOGGER_LEVEL_OFF           (0x04)
+
+#define ASYNCLOGGER_TEXT_SIZE           (112)//单条记录的最大长度，超出截断
+#define ASYNCLOGGER_BUFFER_RECORDS      (1024)//每个线程环形缓冲的记录数
+#define ASYNCLOGGER_RATE_LIMIT          (20)//同一条消息每秒最多记录的次数，0表示不限频
+#define ASYNCLOGGER_RATE_SLOTS          (64)//每个线程限频表的大小
+#define ASYNCLOGGER_FLUSH_INTERVAL      (50)//后台写入间隔（ms）
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  一条日志记录
+    **/
+    struct LogRecord {
+        int64_t time;//us，相对于open的时刻
+        uint32_t tid;
+        uint8_t level;
+        char text[ASYNCLOGGER_TEXT_SIZE];
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  单个线程的日志缓冲和限频表（限频表只由该线程访问）
+    **/
+    struct LogThreadBuffer {
+        struct RateSlot {
+            uint32_t hash;
+            int64_t second;
+            uint32_t count;
+            uint32_t suppressed;
+        };
+        LockFreeRing<LogRecord> ring;
+        std::thread::id owner;
+        uint32_t tid;
+        std::atomic<uint64_t> dropped;
+        RateSlot rate[ASYNCLOGGER_RATE_SLOTS];
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  异步日志，write线程安全且无锁（线程第一次写入时注册缓冲需要加锁一次）
+    **/
+    class AsyncLogger {
+    public:
+        AsyncLogger();
+        ~AsyncLogger();
+
+        bool open(const std::string& path);
+        void close();
+        bool isOpen();
+        void write(uint8_t level, const char* text);
+        void setLevel(uint8_t level);
+        uint8_t getLevel();
+        void setRateLimit(uint32_t perSecond);
+        static uint8_t levelOf(const char* text);
+
+    private:
+        LogThreadBuffer* threadBuffer();
+        bool rateLimit(LogThreadBuffer* buffer, const char* text, int64_t time, uint32_t& suppressed);
+        void writerThread();
+        void drain();
+
+        std::atomic<bool> opened;
+        std::atomic<uint8_t> level;
+        std::atomic<uint32_t> rateLimitPerSecond;
+        std::atomic<uint64_t> id;//区分不同的logger实例（每次open更新），线程局部缓存以此判断是否失效
+        int64_t origin;
+        std::ofstream file;
+        std::list<LogThreadBuffer*> buffers;
+        std::vector<LogRecord> batch;//后台线程一次取出的记录，按时间排序后写入
+        uint32_t nextTid;
+        bool threadShouldEnd;
+        std::thread* thread;
+        std::mutex mutex;//保护buffers和文件，只在注册线程和后台写入时使用
+        std::condition_variable cv;
+    };
+
+
+};
+
+
+#endif//_ASYNCLOGGER_H_
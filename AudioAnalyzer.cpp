@@ -0,0 +1,884 @@
+#include "AudioAnalyzer.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  AudioAnalyzer.h的实现
+**/
+
+extern "C"{
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libswresample/swresample.h"
+#include "libavutil/channel_layout.h"
+}
+
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <sys/stat.h>
+#include "MediaUse.h"
+
+//包络扫描的SIMD实现，x86使用SSE2，ARM使用NEON，其他平台使用标量循环
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIOANALYZER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUDIOANALYZER_NEON
+#endif
+
+using namespace MediaUse;
+
+
+static const double AUDIOANALYZER_PI = 3.14159265358979323846;
+static const char AUDIOANALYZER_MAGIC[4] = { 'C','P','W','F' };//磁盘缓存文件头
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+WaveformLevel::WaveformLevel() :samplesPerBlock(AUDIOANALYZER_BASE_BLOCK) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+AudioAnalysis::AudioAnalysis() :sampleRate(0), samples(0), loudness(AUDIOANALYZER_SILENCE), samplePeak(0.0f) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        达到目标响度需要的音量倍数，提升时不超过使采样峰值到0dBFS的倍数（避免削波），并限制在GAIN_MIN~GAIN_MAX
+* @Param:        @target double 目标响度（LUFS）
+* @Return:       float 无法测量响度（静音或太短）时返回1
+**/
+float AudioAnalysis::normalizeGain(double target) const {
+    double gain = 1.0;
+    if (this->loudness <= AUDIOANALYZER_SILENCE) return 1.0f;
+    gain = pow(10.0, (target - this->loudness) / 20.0);
+    if (this->samplePeak > 0.0f) gain = std::min(gain, 1.0 / this->samplePeak);
+    return std::min(AUDIOANALYZER_GAIN_MAX, std::max(AUDIOANALYZER_GAIN_MIN, (float)gain));
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+LoudnessMeter::LoudnessMeter() :subBlockSize(1), subBlockFill(0), subBlockCount(0) {
+    memset(&this->shelf, 0, sizeof(this->shelf));
+    memset(&this->highpass, 0, sizeof(this->highpass));
+    memset(this->recent, 0, sizeof(this->recent));
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        按采样率计算K加权滤波器系数（与libebur128相同的公式，任意采样率可用）并清空测量
+* @Param:        @sampleRate int 采样率
+*                @channelWeights (const std::vector<double>&) 每声道的权重
+* @Return:       void
+**/
+void LoudnessMeter::open(int sampleRate, const std::vector<double>& channelWeights) {
+    double f0 = 1681.974450955533;
+    double G = 3.999843853973347;
+    double Q = 0.7071752369554196;
+    double K = tan(AUDIOANALYZER_PI * f0 / sampleRate);
+    double Vh = pow(10.0, G / 20.0);
+    double Vb = pow(Vh, 0.4996667741545416);
+    double a0 = 1.0 + K / Q + K * K;
+
+    //高架滤波器，模拟头部的声学影响
+    this->shelf.b[0] = (Vh + Vb * K / Q + K * K) / a0;
+    this->shelf.b[1] = 2.0 * (K * K - Vh) / a0;
+    this->shelf.b[2] = (Vh - Vb * K / Q + K * K) / a0;
+    this->shelf.a[0] = 1.0;
+    this->shelf.a[1] = 2.0 * (K * K - 1.0) / a0;
+    this->shelf.a[2] = (1.0 - K / Q + K * K) / a0;
+
+    //RLB高通滤波器
+    f0 = 38.13547087602444;
+    Q = 0.5003270373238773;
+    K = tan(AUDIOANALYZER_PI * f0 / sampleRate);
+    a0 = 1.0 + K / Q + K * K;
+    this->highpass.b[0] = 1.0;
+    this->highpass.b[1] = -2.0;
+    this->highpass.b[2] = 1.0;
+    this->highpass.a[0] = 1.0;
+    this->highpass.a[1] = 2.0 * (K * K - 1.0) / a0;
+    this->highpass.a[2] = (1.0 - K / Q + K * K) / a0;
+
+    this->weights = channelWeights;
+    this->subBlockSize = std::max(1, sampleRate / 10);
+    this->reset();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        处理一段平面格式的采样，权重为0的声道（LFE）不计算
+* @Param:        @planes (const float* const*) 每声道的采样
+*                @count int 每声道的采样数
+* @Return:       void
+**/
+void LoudnessMeter::process(const float* const* planes, int count) {
+    int offset = 0;
+    int chunk = 0;
+    double x = 0.0;
+    double y = 0.0;
+    double* s = nullptr;
+    while (offset < count) {
+        chunk = std::min(count - offset, this->subBlockSize - this->subBlockFill);
+        for (size_t c = 0; c < this->weights.size(); c++) {
+            if (this->weights[c] <= 0.0) continue;
+            s = &this->state[c * 4];
+            for (int i = offset; i < offset + chunk; i++) {
+                x = planes[c][i];
+                //两级直接II型转置结构
+                y = this->shelf.b[0] * x + s[0];
+                s[0] = this->shelf.b[1] * x - this->shelf.a[1] * y + s[1];
+                s[1] = this->shelf.b[2] * x - this->shelf.a[2] * y;
+                x = y;
+                y = this->highpass.b[0] * x + s[2];
+                s[2] = this->highpass.b[1] * x - this->highpass.a[1] * y + s[3];
+                s[3] = this->highpass.b[2] * x - this->highpass.a[2] * y;
+                this->sums[c] += y * y;
+            }
+        }
+        this->subBlockFill += chunk;
+        offset += chunk;
+        if (this->subBlockFill == this->subBlockSize) this->pushSubBlock();
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        结束一个100ms子块，凑满4个子块后每个子块产生一个400ms块（75%重叠）
+* @Param:        void
+* @Return:       void
+**/
+void LoudnessMeter::pushSubBlock() {
+    double power = 0.0;
+    for (size_t c = 0; c < this->weights.size(); c++) {
+        power += this->weights[c] * this->sums[c] / this->subBlockSize;
+        this->sums[c] = 0.0;
+    }
+    this->recent[this->subBlockCount % 4] = power;
+    this->subBlockCount++;
+    this->subBlockFill = 0;
+    if (this->subBlockCount >= 4) {
+        this->blocks.push_back((this->recent[0] + this->recent[1] + this->recent[2] + this->recent[3]) / 4.0);
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        积分响度：先去掉低于-70LUFS的块，再去掉低于剩余块平均响度-10LU的块，对剩余块的功率取平均
+* @Param:        void
+* @Return:       double LUFS，没有块通过门限时为AUDIOANALYZER_SILENCE
+**/
+double LoudnessMeter::integrated() const {
+    double absolute = pow(10.0, (AUDIOANALYZER_SILENCE + 0.691) / 10.0);
+    double relative = 0.0;
+    double sum = 0.0;
+    size_t n = 0;
+    for (double p : this->blocks) {
+        if (p > absolute) {
+            sum += p;
+            n++;
+        }
+    }
+    if (n == 0) return AUDIOANALYZER_SILENCE;
+    relative = std::max(absolute, sum / n * 0.1);//-10LU
+    sum = 0.0;
+    n = 0;
+    for (double p : this->blocks) {
+        if (p > relative) {
+            sum += p;
+            n++;
+        }
+    }
+    if (n == 0) return AUDIOANALYZER_SILENCE;
+    return -0.691 + 10.0 * log10(sum / n);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        清空滤波器状态和已测量的块
+* @Param:        void
+* @Return:       void
+**/
+void LoudnessMeter::reset() {
+    this->state.assign(this->weights.size() * 4, 0.0);
+    this->sums.assign(this->weights.size(), 0.0);
+    this->subBlockFill = 0;
+    this->subBlockCount = 0;
+    memset(this->recent, 0, sizeof(this->recent));
+    this->blocks.clear();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+AudioAnalyzer::AudioAnalyzer()
+    :formatContext(nullptr), codecContext(nullptr), swrContext(nullptr), packet(nullptr), frame(nullptr), streamIndex(-1), channels(0),
+    blockPeak(0.0f), blockSum(0.0), blockFill(0), duration(0), done(false), threadShouldEnd(true), thread(nullptr) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构函数，结束工作线程并释放资源
+* @Param:        void
+* @Return:       void
+**/
+AudioAnalyzer::~AudioAnalyzer() {
+    this->close();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开文件，磁盘缓存命中时直接加载结果，否则打开独立的解码器并启动低优先级工作线程
+* @Param:        @path (const std::string&) 文件路径
+*                @diskCacheDir (const std::string&) 磁盘缓存目录（需已存在），为空不使用磁盘缓存
+* @Return:       bool 打开成功返回true（文件没有音频流返回false）
+**/
+bool AudioAnalyzer::open(const std::string& path, const std::string& diskCacheDir) {
+    int ret = 0;
+    const AVCodec* codec = nullptr;
+    AVStream* stream = nullptr;
+    AVChannel channel = AV_CHAN_NONE;
+    std::vector<double> weights;
+    struct stat st;
+    std::ostringstream key;
+
+    this->close();
+
+    //文件标识：路径+大小+修改时间，与缩略图缓存相同
+    if (!diskCacheDir.empty() && stat(path.c_str(), &st) == 0) {
+        key << diskCacheDir << '/' << std::hex << std::hash<std::string>()(path) << '_' << (long long)st.st_size << '_' << (long long)st.st_mtime
+            << ".wave";
+        this->diskPath = key.str();
+        if (this->loadFromDisk()) {
+            this->done = true;
+            return true;
+        }
+    }
+
+    ret = avformat_open_input(&this->formatContext, path.c_str(), nullptr, nullptr);
+    if (ret != 0) {
+        this->formatContext = nullptr;
+        return false;
+    }
+    ret = avformat_find_stream_info(this->formatContext, nullptr);
+    if (ret < 0) {
+        this->releaseDecoder();
+        return false;
+    }
+    this->streamIndex = av_find_best_stream(this->formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (this->streamIndex < 0) {
+        this->releaseDecoder();
+        return false;
+    }
+    //只读取音频流，视频等其他流不解析
+    for (unsigned int i = 0; i < this->formatContext->nb_streams; i++) {
+        if ((int)i != this->streamIndex) this->formatContext->streams[i]->discard = AVDISCARD_ALL;
+    }
+    stream = this->formatContext->streams[this->streamIndex];
+    codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (codec) this->codecContext = avcodec_alloc_context3(codec);
+    if (!this->codecContext || avcodec_parameters_to_context(this->codecContext, stream->codecpar) < 0) {
+        this->releaseDecoder();
+        return false;
+    }
+    this->codecContext->thread_count = 1;
+    this->codecContext->pkt_timebase = stream->time_base;
+    if (avcodec_open2(this->codecContext, nullptr, nullptr) != 0
+        || this->codecContext->sample_rate <= 0 || this->codecContext->ch_layout.nb_channels <= 0) {
+        this->releaseDecoder();
+        return false;
+    }
+    this->packet = av_packet_alloc();
+    this->frame = av_frame_alloc();
+    if (!this->packet || !this->frame) {
+        this->releaseDecoder();
+        return false;
+    }
+
+    //BS.1770声道权重：LFE不计入，环绕/侧声道+1.5dB
+    this->channels = this->codecContext->ch_layout.nb_channels;
+    for (int i = 0; i < this->channels; i++) {
+        channel = av_channel_layout_channel_from_index(&this->codecContext->ch_layout, i);
+        if (channel == AV_CHAN_LOW_FREQUENCY || channel == AV_CHAN_LOW_FREQUENCY_2) {
+            weights.push_back(0.0);
+        }
+        else if (channel == AV_CHAN_SIDE_LEFT || channel == AV_CHAN_SIDE_RIGHT
+            || channel == AV_CHAN_BACK_LEFT || channel == AV_CHAN_BACK_RIGHT || channel == AV_CHAN_BACK_CENTER) {
+            weights.push_back(1.41);
+        }
+        else {
+            weights.push_back(1.0);
+        }
+    }
+    this->meter.open(this->codecContext->sample_rate, weights);
+
+    this->analysis = AudioAnalysis();
+    this->analysis.sampleRate = this->codecContext->sample_rate;
+    this->analysis.levels.resize(1);
+    this->duration = this->formatContext->duration > 0 ? this->formatContext->duration : 0;
+    this->blockPeak = 0.0f;
+    this->blockSum = 0.0;
+    this->blockFill = 0;
+    this->done = false;
+    this->threadShouldEnd = false;
+    this->thread = new std::thread(&AudioAnalyzer::workerThread, this);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        结束工作线程（未完成的分析不写入磁盘缓存），释放解码器和结果
+* @Param:        void
+* @Return:       void
+**/
+void AudioAnalyzer::close() {
+    this->threadShouldEnd = true;
+    if (this->thread) {
+        this->thread->join();
+        delete this->thread;
+        this->thread = nullptr;
+    }
+    this->releaseDecoder();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->analysis = AudioAnalysis();
+    this->duration = 0;
+    this->done = false;
+    this->diskPath.clear();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        分析是否完成（响度和所有级的包络可用）
+* @Param:        void
+* @Return:       bool
+**/
+bool AudioAnalyzer::isDone() {
+    return this->done;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        分析进度，按已解码的采样数和文件时长估计
+* @Param:        void
+* @Return:       float 0~1
+**/
+float AudioAnalyzer::getProgress() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->done) return 1.0f;
+    if (this->duration <= 0 || this->analysis.sampleRate <= 0) return 0.0f;
+    return std::min(1.0f, (float)((double)this->analysis.samples * AV_TIME_BASE / this->analysis.sampleRate / this->duration));
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回文件时长（从缓存加载时为音轨时长）
+* @Param:        void
+* @Return:       int64_t 单位us
+**/
+int64_t AudioAnalyzer::getDuration() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->duration;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        取得时间范围内的波形，按每列的采样数选择最粗的可用级，每列为其覆盖的点的峰值最大值和RMS，
+*                还没有分析到的列为0
+* @Param:        @from int64_t 起始时间（AV_TIME_BASE）
+*                @to int64_t 结束时间（AV_TIME_BASE）
+*                @columns int 列数（如显示宽度的像素数）
+*                @peak (std::vector<float>&) 输出每列峰值
+*                @rms (std::vector<float>&) 输出每列RMS
+* @Return:       bool 还没有任何结果时返回false
+**/
+bool AudioAnalyzer::getWaveform(int64_t from, int64_t to, int columns, std::vector<float>& peak, std::vector<float>& rms) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    const WaveformLevel* level = nullptr;
+    int64_t first = 0;
+    int64_t last = 0;
+    int64_t perColumn = 0;
+    int64_t b0 = 0;
+    int64_t b1 = 0;
+    int64_t size = 0;
+    float p = 0.0f;
+    double s = 0.0;
+    if (columns <= 0 || to <= from || this->analysis.levels.empty() || this->analysis.levels[0].peak.empty()) return false;
+
+    first = av_rescale(from, this->analysis.sampleRate, AV_TIME_BASE);
+    last = av_rescale(to, this->analysis.sampleRate, AV_TIME_BASE);
+    perColumn = std::max((int64_t)1, (last - first) / columns);
+    level = &this->analysis.levels[0];
+    for (size_t i = 1; i < this->analysis.levels.size(); i++) {
+        if (this->analysis.levels[i].samplesPerBlock > perColumn) break;
+        level = &this->analysis.levels[i];
+    }
+
+    size = (int64_t)level->peak.size();
+    peak.assign(columns, 0.0f);
+    rms.assign(columns, 0.0f);
+    for (int c = 0; c < columns; c++) {
+        b0 = (first + (last - first) * c / columns) / level->samplesPerBlock;
+        b1 = (first + (last - first) * (c + 1) / columns) / level->samplesPerBlock;
+        if (b1 <= b0) b1 = b0 + 1;
+        if (b0 < 0) b0 = 0;
+        if (b1 > size) b1 = size;
+        if (b0 >= b1) continue;
+        p = 0.0f;
+        s = 0.0;
+        for (int64_t b = b0; b < b1; b++) {
+            p = std::max(p, level->peak[b]);
+            s += (double)level->rms[b] * level->rms[b];
+        }
+        peak[c] = p;
+        rms[c] = (float)sqrt(s / (b1 - b0));
+    }
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        分析结果的副本
+* @Param:        void
+* @Return:       AudioAnalysis
+**/
+AudioAnalysis AudioAnalyzer::getAnalysis() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->analysis;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        达到目标响度需要的音量倍数，设置到AudioMixer通道（OpenAL source的AL_GAIN），不处理采样
+* @Param:        @target double 目标响度（LUFS）
+* @Return:       float 分析未完成时返回1
+**/
+float AudioAnalyzer::getNormalizeGain(double target) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->done) return 1.0f;
+    return this->analysis.normalizeGain(target);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        扫描一段采样，更新峰值绝对值并累加平方和，每次处理4个采样，剩余的按标量处理
+* @Param:        @data (const float*) 采样
+*                @count int 采样数
+*                @peak float& 峰值（输入输出）
+*                @sumSquares double& 平方和（输入输出）
+* @Return:       void
+**/
+void AudioAnalyzer::envelopeScan(const float* data, int count, float& peak, double& sumSquares) {
+    int i = 0;
+    float p = peak;
+    float s = 0.0f;
+#if defined(AUDIOANALYZER_SSE2)
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vpeak = _mm_setzero_ps();
+    __m128 vsum = _mm_setzero_ps();
+    __m128 x;
+    float lanes[4];
+    for (; i + 4 <= count; i += 4) {
+        x = _mm_loadu_ps(data + i);
+        vpeak = _mm_max_ps(vpeak, _mm_and_ps(x, absMask));
+        vsum = _mm_add_ps(vsum, _mm_mul_ps(x, x));
+    }
+    _mm_storeu_ps(lanes, vpeak);
+    p = std::max(std::max(p, std::max(lanes[0], lanes[1])), std::max(lanes[2], lanes[3]));
+    _mm_storeu_ps(lanes, vsum);
+    s = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(AUDIOANALYZER_NEON)
+    float32x4_t vpeak = vdupq_n_f32(0.0f);
+    float32x4_t vsum = vdupq_n_f32(0.0f);
+    float32x4_t x;
+    float lanes[4];
+    for (; i + 4 <= count; i += 4) {
+        x = vld1q_f32(data + i);
+        vpeak = vmaxq_f32(vpeak, vabsq_f32(x));
+        vsum = vmlaq_f32(vsum, x, x);
+    }
+    vst1q_f32(lanes, vpeak);
+    p = std::max(std::max(p, std::max(lanes[0], lanes[1])), std::max(lanes[2], lanes[3]));
+    vst1q_f32(lanes, vsum);
+    s = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < count; i++) {
+        p = std::max(p, fabsf(data[i]));
+        s += data[i] * data[i];
+    }
+    peak = p;
+    sumSquares += s;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        解码整个音轨，转换为FLTP后计算包络和响度，只在工作线程调用
+* @Param:        void
+* @Return:       bool 完整读到文件末尾返回true，被close打断返回false
+**/
+bool AudioAnalyzer::analyze() {
+    int ret = 0;
+    int count = 0;
+    bool eof = false;
+    std::vector<const float*> planes(this->channels);
+    std::vector<uint8_t*> out(this->channels);
+
+    while (!this->threadShouldEnd) {
+        ret = avcodec_receive_frame(this->codecContext, this->frame);
+        if (ret == AVERROR_EOF) break;
+        if (ret == AVERROR(EAGAIN)) {
+            if (eof) break;
+            ret = av_read_frame(this->formatContext, this->packet);
+            if (ret < 0) {
+                eof = true;
+                avcodec_send_packet(this->codecContext, nullptr);//冲刷解码器
+                continue;
+            }
+            if (this->packet->stream_index == this->streamIndex) {
+                avcodec_send_packet(this->codecContext, this->packet);//损坏的packet跳过
+            }
+            av_packet_unref(this->packet);
+            continue;
+        }
+        if (ret < 0) break;
+        if (this->frame->ch_layout.nb_channels != this->channels) {//声道数中途变化，跳过这一帧
+            av_frame_unref(this->frame);
+            continue;
+        }
+
+        count = this->frame->nb_samples;
+        if (this->frame->format == AV_SAMPLE_FMT_FLTP) {//多数解码器（AAC/MP3/Opus/Vorbis）直接输出FLTP，不需要转换
+            for (int c = 0; c < this->channels; c++) planes[c] = (const float*)this->frame->data[c];
+        }
+        else {
+            if (!this->swrContext) {
+                ret = swr_alloc_set_opts2(&this->swrContext,
+                    &this->frame->ch_layout, AV_SAMPLE_FMT_FLTP, this->frame->sample_rate,
+                    &this->frame->ch_layout, (AVSampleFormat)this->frame->format, this->frame->sample_rate,
+                    0, nullptr);
+                if (ret != 0 || swr_init(this->swrContext) != 0) {
+                    av_frame_unref(this->frame);
+                    return false;
+                }
+            }
+            this->planar.resize((size_t)count * this->channels);
+            for (int c = 0; c < this->channels; c++) {
+                out[c] = (uint8_t*)(this->planar.data() + (size_t)c * count);
+                planes[c] = this->planar.data() + (size_t)c * count;
+            }
+            count = swr_convert(this->swrContext, out.data(), count, (const uint8_t**)this->frame->data, this->frame->nb_samples);
+        }
+        if (count > 0) {
+            this->accumulate(planes.data(), count);
+            this->meter.process(planes.data(), count);
+        }
+        av_frame_unref(this->frame);
+    }
+    if (this->threadShouldEnd) return false;
+
+    //最后一个不完整的包络点
+    if (this->blockFill > 0) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->analysis.levels[0].peak.push_back(this->blockPeak);
+        this->analysis.levels[0].rms.push_back((float)sqrt(this->blockSum / ((double)this->blockFill * this->channels)));
+        this->blockFill = 0;
+    }
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        把一段采样累计到最细一级包络，凑满AUDIOANALYZER_BASE_BLOCK个采样产生一个点，
+*                一次追加整帧的点以减少加锁
+* @Param:        @planes (const float* const*) 每声道的采样
+*                @count int 每声道的采样数
+* @Return:       void
+**/
+void AudioAnalyzer::accumulate(const float* const* planes, int count) {
+    int offset = 0;
+    int chunk = 0;
+    float framePeak = 0.0f;
+    std::vector<float> peaks;
+    std::vector<float> rmss;
+    while (offset < count) {
+        chunk = std::min(count - offset, AUDIOANALYZER_BASE_BLOCK - this->blockFill);
+        for (int c = 0; c < this->channels; c++) {
+            envelopeScan(planes[c] + offset, chunk, this->blockPeak, this->blockSum);
+        }
+        this->blockFill += chunk;
+        offset += chunk;
+        if (this->blockFill == AUDIOANALYZER_BASE_BLOCK) {
+            peaks.push_back(this->blockPeak);
+            rmss.push_back((float)sqrt(this->blockSum / ((double)AUDIOANALYZER_BASE_BLOCK * this->channels)));
+            framePeak = std::max(framePeak, this->blockPeak);
+            this->blockPeak = 0.0f;
+            this->blockSum = 0.0;
+            this->blockFill = 0;
+        }
+    }
+    framePeak = std::max(framePeak, this->blockPeak);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    WaveformLevel& base = this->analysis.levels[0];
+    base.peak.insert(base.peak.end(), peaks.begin(), peaks.end());
+    base.rms.insert(base.rms.end(), rmss.begin(), rmss.end());
+    this->analysis.samples += count;
+    this->analysis.samplePeak = std::max(this->analysis.samplePeak, framePeak);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        由最细一级逐级合并AUDIOANALYZER_LEVEL_FACTOR个点生成其他级（峰值取最大，RMS按均方合并）
+* @Param:        @analysis (AudioAnalysis&) levels[0]已完整的结果
+* @Return:       void
+**/
+void AudioAnalyzer::buildLevels(AudioAnalysis& analysis) {
+    size_t n = 0;
+    size_t end = 0;
+    float p = 0.0f;
+    double s = 0.0;
+    analysis.levels.resize(1);
+    analysis.levels[0].samplesPerBlock = AUDIOANALYZER_BASE_BLOCK;
+    for (int k = 1; k < AUDIOANALYZER_LEVELS; k++) {
+        const WaveformLevel& prev = analysis.levels[k - 1];
+        WaveformLevel level;
+        level.samplesPerBlock = prev.samplesPerBlock * AUDIOANALYZER_LEVEL_FACTOR;
+        n = (prev.peak.size() + AUDIOANALYZER_LEVEL_FACTOR - 1) / AUDIOANALYZER_LEVEL_FACTOR;
+        level.peak.resize(n);
+        level.rms.resize(n);
+        for (size_t j = 0; j < n; j++) {
+            end = std::min(prev.peak.size(), (j + 1) * AUDIOANALYZER_LEVEL_FACTOR);
+            p = 0.0f;
+            s = 0.0;
+            for (size_t i = j * AUDIOANALYZER_LEVEL_FACTOR; i < end; i++) {
+                p = std::max(p, prev.peak[i]);
+                s += (double)prev.rms[i] * prev.rms[i];
+            }
+            level.peak[j] = p;
+            level.rms[j] = (float)sqrt(s / (end - j * AUDIOANALYZER_LEVEL_FACTOR));
+        }
+        analysis.levels.push_back(level);
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        从磁盘缓存读取结果，文件格式为 "CPWF" 版本(int32) 采样率(int32) 采样数(int64) 响度(double) 峰值(float)
+*                点数(int64) 最细一级的峰值和RMS(float数组)，其他级加载后重新生成
+* @Param:        void
+* @Return:       bool 成功返回true
+**/
+bool AudioAnalyzer::loadFromDisk() {
+    char magic[4] = { 0 };
+    int32_t version = 0;
+    int64_t count = 0;
+    AudioAnalysis result;
+    int32_t sampleRate = 0;
+    if (this->diskPath.empty()) return false;
+    std::ifstream f(this->diskPath, std::ios_base::in | std::ios_base::binary);
+    if (!f.is_open()) return false;
+    f.read(magic, sizeof(magic));
+    f.read((char*)&version, sizeof(version));
+    if (!f || memcmp(magic, AUDIOANALYZER_MAGIC, sizeof(magic)) != 0 || version != AUDIOANALYZER_CACHE_VERSION) return false;
+    f.read((char*)&sampleRate, sizeof(sampleRate));
+    f.read((char*)&result.samples, sizeof(result.samples));
+    f.read((char*)&result.loudness, sizeof(result.loudness));
+    f.read((char*)&result.samplePeak, sizeof(result.samplePeak));
+    f.read((char*)&count, sizeof(count));
+    if (!f || sampleRate <= 0 || count < 0 || count > result.samples / AUDIOANALYZER_BASE_BLOCK + 1) return false;
+    result.sampleRate = sampleRate;
+    result.levels.resize(1);
+    result.levels[0].peak.resize((size_t)count);
+    result.levels[0].rms.resize((size_t)count);
+    f.read((char*)result.levels[0].peak.data(), count * sizeof(float));
+    f.read((char*)result.levels[0].rms.data(), count * sizeof(float));
+    if (!f) return false;
+    this->buildLevels(result);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->analysis = result;
+    this->duration = av_rescale(result.samples, AV_TIME_BASE, result.sampleRate);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        结果写入磁盘缓存，格式见loadFromDisk
+* @Param:        void
+* @Return:       void
+**/
+void AudioAnalyzer::saveToDisk() {
+    int32_t version = AUDIOANALYZER_CACHE_VERSION;
+    int32_t sampleRate = 0;
+    int64_t count = 0;
+    if (this->diskPath.empty()) return;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    const WaveformLevel& base = this->analysis.levels[0];
+    sampleRate = this->analysis.sampleRate;
+    count = (int64_t)base.peak.size();
+    std::ofstream f(this->diskPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!f.is_open()) return;
+    f.write(AUDIOANALYZER_MAGIC, sizeof(AUDIOANALYZER_MAGIC));
+    f.write((const char*)&version, sizeof(version));
+    f.write((const char*)&sampleRate, sizeof(sampleRate));
+    f.write((const char*)&this->analysis.samples, sizeof(this->analysis.samples));
+    f.write((const char*)&this->analysis.loudness, sizeof(this->analysis.loudness));
+    f.write((const char*)&this->analysis.samplePeak, sizeof(this->analysis.samplePeak));
+    f.write((const char*)&count, sizeof(count));
+    f.write((const char*)base.peak.data(), count * sizeof(float));
+    f.write((const char*)base.rms.data(), count * sizeof(float));
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        工作线程，以低优先级解码整个音轨，完成后生成其他级包络、计算响度并写入磁盘缓存
+* @Param:        void
+* @Return:       void
+**/
+void AudioAnalyzer::workerThread() {
+    bool ok = false;
+
+    MediaUse::lowerThreadPriority();
+
+    ok = this->analyze();
+    this->releaseDecoder();
+    if (!ok) return;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->buildLevels(this->analysis);
+        this->analysis.loudness = this->meter.integrated();
+        if (this->duration <= 0) this->duration = av_rescale(this->analysis.samples, AV_TIME_BASE, this->analysis.sampleRate);
+        this->done = true;
+    }
+    this->saveToDisk();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        释放ffmpeg资源
+* @Param:        void
+* @Return:       void
+**/
+void AudioAnalyzer::releaseDecoder() {
+    if (this->packet) {
+        av_packet_free(&this->packet);
+    }
+    if (this->frame) {
+        av_frame_free(&this->frame);
+    }
+    if (this->swrContext) {
+        swr_free(&this->swrContext);
+    }
+    if (this->codecContext) {
+        avcodec_free_context(&this->codecContext);
+    }
+    if (this->formatContext) {
+        avformat_close_input(&this->formatContext);
+    }
+    this->streamIndex = -1;
+}
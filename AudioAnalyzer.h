@@ -0,0 +1,181 @@
+#ifndef _AUDIOANALYZER_H_
+#define _AUDIOANALYZER_H_
+
+/**
+* @File name:    AudioAnalyzer.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  音频预分析：使用独立的解封装器和解码器在低优先级线程中解码整个音轨，计算多级缩放的峰值/RMS波形包络
+*                和EBU R128积分响度，结果按文件标识缓存到磁盘。播放时的响度归一化只设置OpenAL source的音量，
+*                不处理采样数据，不依赖Qt
+**/
+
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+struct SwrContext;
+
+
+#define AUDIOANALYZER_BASE_BLOCK        (512)//最细一级包络每个点对应的采样数
+#define AUDIOANALYZER_LEVEL_FACTOR      (4)//相邻两级包络的采样数倍数
+#define AUDIOANALYZER_LEVELS            (6)//包络级数，最粗一级每个点为512*4^5个采样（48kHz约11s）
+#define AUDIOANALYZER_DEFAULT_TARGET    (-23.0)//默认目标响度（LUFS，EBU R128）
+#define AUDIOANALYZER_GAIN_MIN          (0.1f)//归一化音量下限
+#define AUDIOANALYZER_GAIN_MAX          (4.0f)//归一化音量上限（约+12dB）
+#define AUDIOANALYZER_SILENCE           (-70.0)//绝对门限（LUFS），低于它的400ms块不计入响度
+#define AUDIOANALYZER_CACHE_VERSION     (1)//磁盘缓存格式版本，格式变化时增加使旧缓存失效
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  一级波形包络，每个点为samplesPerBlock个采样（所有声道）的峰值绝对值和RMS，范围0~1
+    **/
+    class WaveformLevel {
+    public:
+        WaveformLevel();
+        int samplesPerBlock;
+        std::vector<float> peak;
+        std::vector<float> rms;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  分析结果，levels[0]为最细一级，分析中只有levels[0]且在增长，完成后才有其他级
+    **/
+    class AudioAnalysis {
+    public:
+        AudioAnalysis();
+        float normalizeGain(double target = AUDIOANALYZER_DEFAULT_TARGET) const;
+
+        int sampleRate;
+        int64_t samples;//每声道的采样数
+        double loudness;//积分响度（LUFS），没有超过门限的内容时为AUDIOANALYZER_SILENCE
+        float samplePeak;//采样峰值绝对值
+        std::vector<WaveformLevel> levels;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  ITU-R BS.1770 / EBU R128积分响度测量：K加权（高架+高通两个双二阶滤波器），
+    *                100ms子块计算加权均方，400ms块（75%重叠）经过-70LUFS绝对门限和-10LU相对门限后取平均，非线程安全
+    **/
+    class LoudnessMeter {
+    public:
+        LoudnessMeter();
+        void open(int sampleRate, const std::vector<double>& channelWeights);
+        void process(const float* const* planes, int count);
+        double integrated() const;
+        void reset();
+    private:
+
+        struct Biquad {
+            double b[3];
+            double a[3];
+        };
+
+        void pushSubBlock();
+
+        Biquad shelf;
+        Biquad highpass;
+        std::vector<double> weights;//声道权重，LFE为0，环绕声道为1.41
+        std::vector<double> state;//每声道两个滤波器各两个状态
+        std::vector<double> sums;//当前子块每声道的平方和
+        int subBlockSize;
+        int subBlockFill;
+        double recent[4];//最近4个子块的加权均方和（环形）
+        int64_t subBlockCount;
+        std::vector<double> blocks;//每个400ms块的功率
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  音频预分析服务，open后在后台线程分析（磁盘缓存命中时直接加载），分析中即可读取已完成部分的波形，
+    *                完成后可取得响度和归一化音量，线程安全
+    **/
+    class AudioAnalyzer {
+    public:
+        AudioAnalyzer();
+        ~AudioAnalyzer();
+
+        bool open(const std::string& path, const std::string& diskCacheDir = "");
+        void close();
+        bool isDone();
+        float getProgress();
+        int64_t getDuration();
+        bool getWaveform(int64_t from, int64_t to, int columns, std::vector<float>& peak, std::vector<float>& rms);
+        AudioAnalysis getAnalysis();
+        float getNormalizeGain(double target = AUDIOANALYZER_DEFAULT_TARGET);
+
+        static void envelopeScan(const float* data, int count, float& peak, double& sumSquares);
+
+    private:
+        AudioAnalyzer(const AudioAnalyzer&) = delete;
+        AudioAnalyzer& operator=(const AudioAnalyzer&) = delete;
+
+        bool analyze();
+        void accumulate(const float* const* planes, int count);
+        void buildLevels(AudioAnalysis& analysis);
+        bool loadFromDisk();
+        void saveToDisk();
+        void workerThread();
+        void releaseDecoder();
+
+        //独立的ffmpeg资源，只在工作线程中使用
+        AVFormatContext* formatContext;
+        AVCodecContext* codecContext;
+        SwrContext* swrContext;
+        AVPacket* packet;
+        AVFrame* frame;
+        int streamIndex;
+        int channels;
+        std::vector<float> planar;//转换为FLTP的缓冲
+
+        //当前正在累计的最细一级包络点
+        float blockPeak;
+        double blockSum;
+        int blockFill;
+        LoudnessMeter meter;
+
+        //结果，levels[0]在分析中逐步追加
+        AudioAnalysis analysis;
+        int64_t duration;
+        std::atomic<bool> done;
+
+        //磁盘缓存路径，为空表示不使用磁盘缓存
+        std::string diskPath;
+
+        std::atomic<bool> threadShouldEnd;
+        std::thread* thread;
+        std::mutex mutex;
+    };
+
+
+};
+
+
+#endif//_AUDIOANALYZER_H_
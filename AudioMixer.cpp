@@ -0,0 +1,424 @@
+#include "AudioMixer.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  AudioMixer.h的实现
+**/
+
+#include<AL/alc.h>
+#include<AL/al.h>
+#include<algorithm>
+
+using namespace MediaUse;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+AudioMixerChannel::AudioMixerChannel() :channel(-1), gain(1.0f), normalizeGain(1.0f), effectiveGain(1.0f), muted(false), focused(false), suspended(false), playing(false) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        进程内共用的混音管理（与OpenALAudioSink共用的设备和上下文对应）
+* @Param:        void
+* @Return:       AudioMixer&
+**/
+AudioMixer& AudioMixer::global() {
+    static AudioMixer mixer;
+    return mixer;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数，没有焦点，开启ducking和自动挂起
+* @Param:        void
+* @Return:       void
+**/
+AudioMixer::AudioMixer() :nextChannel(0), focus(-1), ducking(true), duckGain(AUDIOMIXER_DEFAULT_DUCK_GAIN), masterGain(1.0f), autoSuspend(true) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        注册一个通道，默认音量1.0、不静音
+* @Param:        @name (const std::string&) 通道名，用于显示
+* @Return:       int 通道号
+**/
+int AudioMixer::addChannel(const std::string& name) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    Channel c;
+    c.name = name;
+    c.gain = 1.0f;
+    c.normalizeGain = 1.0f;
+    c.muted = false;
+    c.source = 0;
+    this->channels[this->nextChannel] = c;
+    return this->nextChannel++;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        注销通道，是焦点时取消焦点并恢复其他通道的音量
+* @Param:        @channel int
+* @Return:       void
+**/
+void AudioMixer::removeChannel(int channel) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->channels.erase(channel);
+    if (this->focus == channel) {
+        this->focus = -1;
+        this->applyAll();
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置通道名
+* @Param:        @channel int
+*                @name (const std::string&)
+* @Return:       void
+**/
+void AudioMixer::setChannelName(int channel, const std::string& name) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    if (it != this->channels.end()) it->second.name = name;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        绑定通道的source（OpenALAudioSink::open创建source后调用）并设置音量
+* @Param:        @channel int
+*                @source unsigned int OpenAL source
+* @Return:       void
+**/
+void AudioMixer::attachSource(int channel, unsigned int source) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    if (it == this->channels.end()) return;
+    it->second.source = source;
+    alListenerf(AL_GAIN, this->masterGain);//上下文在第一个source打开时才创建
+    this->apply(channel, it->second);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        解绑通道的source，需要在删除source之前调用，之后的音量设置不再作用于它
+* @Param:        @channel int
+* @Return:       void
+**/
+void AudioMixer::detachSource(int channel) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    if (it != this->channels.end()) it->second.source = 0;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置通道音量
+* @Param:        @channel int
+*                @gain float 0为无声，1为原始音量
+* @Return:       void
+**/
+void AudioMixer::setGain(int channel, float gain) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    if (it == this->channels.end()) return;
+    it->second.gain = std::max(0.0f, gain);
+    this->apply(channel, it->second);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取通道音量
+* @Param:        @channel int
+* @Return:       float 通道不存在返回0
+**/
+float AudioMixer::getGain(int channel) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    return it == this->channels.end() ? 0.0f : it->second.gain;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置通道静音
+* @Param:        @channel int
+*                @mute bool
+* @Return:       void
+**/
+void AudioMixer::setMute(int channel, bool mute) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    if (it == this->channels.end()) return;
+    it->second.muted = mute;
+    this->apply(channel, it->second);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        通道是否静音
+* @Param:        @channel int
+* @Return:       bool
+**/
+bool AudioMixer::isMuted(int channel) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    return it != this->channels.end() && it->second.muted;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置通道的响度归一化音量倍数（AudioAnalyzer::getNormalizeGain），只改变source的AL_GAIN，不处理采样
+* @Param:        @channel int
+*                @gain float 1为不归一化，可大于1（提升安静的文件）
+* @Return:       void
+**/
+void AudioMixer::setNormalizeGain(int channel, float gain) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    if (it == this->channels.end()) return;
+    it->second.normalizeGain = std::max(0.0f, gain);
+    this->apply(channel, it->second);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取通道的响度归一化音量倍数
+* @Param:        @channel int
+* @Return:       float 通道不存在返回1
+**/
+float AudioMixer::getNormalizeGain(int channel) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    return it == this->channels.end() ? 1.0f : it->second.normalizeGain;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置焦点通道（如监控墙中被选中的画面），开启ducking时其他通道压低音量，焦点通道不会被挂起
+* @Param:        @channel int -1表示取消焦点
+* @Return:       void
+**/
+void AudioMixer::setFocus(int channel) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->focus = channel;
+    this->applyAll();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取焦点通道
+* @Param:        void
+* @Return:       int -1表示没有
+**/
+int AudioMixer::getFocus() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->focus;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置ducking：有焦点通道时其他通道的音量乘以duckGain
+* @Param:        @enable bool
+*                @duckGain float 0~1，为0时非焦点通道听不到，会被挂起
+* @Return:       void
+**/
+void AudioMixer::setDucking(bool enable, float duckGain) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->ducking = enable;
+    this->duckGain = std::min(1.0f, std::max(0.0f, duckGain));
+    this->applyAll();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置总音量（AL_GAIN of listener），作用于所有通道
+* @Param:        @gain float
+* @Return:       void
+**/
+void AudioMixer::setMasterGain(float gain) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->masterGain = std::max(0.0f, gain);
+    if (alcGetCurrentContext()) alListenerf(AL_GAIN, this->masterGain);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置是否自动挂起听不到的通道（关闭后静音的通道仍然解码）
+* @Param:        @enable bool
+* @Return:       void
+**/
+void AudioMixer::setAutoSuspend(bool enable) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->autoSuspend = enable;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        通道是否挂起（听不到且不是焦点），由引擎的音频线程轮询
+* @Param:        @channel int
+* @Return:       bool
+**/
+bool AudioMixer::isSuspended(int channel) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->channels.find(channel);
+    return it != this->channels.end() && this->suspended(channel, it->second);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        所有通道的状态快照
+* @Param:        void
+* @Return:       std::vector<AudioMixerChannel>
+**/
+std::vector<AudioMixerChannel> AudioMixer::getChannels() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::vector<AudioMixerChannel> result;
+    for (auto& it : this->channels) {
+        AudioMixerChannel c;
+        c.channel = it.first;
+        c.name = it.second.name;
+        c.gain = it.second.gain;
+        c.normalizeGain = it.second.normalizeGain;
+        c.effectiveGain = this->effectiveGain(it.first, it.second);
+        c.muted = it.second.muted;
+        c.focused = it.first == this->focus;
+        c.suspended = this->suspended(it.first, it.second);
+        c.playing = it.second.source != 0;
+        result.push_back(c);
+    }
+    return result;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        通道的实际音量：静音为0，否则为音量乘以归一化倍数，有焦点且开启ducking时非焦点通道再乘以duckGain（调用时持有mutex）
+* @Param:        @channel int
+*                @c (const Channel&)
+* @Return:       float
+**/
+float AudioMixer::effectiveGain(int channel, const Channel& c) {
+    if (c.muted) return 0.0f;
+    if (this->ducking && this->focus >= 0 && channel != this->focus) return c.gain * c.normalizeGain * this->duckGain;
+    return c.gain * c.normalizeGain;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        通道是否挂起：开启自动挂起、不是焦点且实际音量为0（调用时持有mutex）
+* @Param:        @channel int
+*                @c (const Channel&)
+* @Return:       bool
+**/
+bool AudioMixer::suspended(int channel, const Channel& c) {
+    return this->autoSuspend && channel != this->focus && this->effectiveGain(channel, c) <= 0.0f;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        把实际音量设置到通道的source（调用时持有mutex），AL_MAX_GAIN默认为1，音量大于1时同时提高上限
+* @Param:        @channel int
+*                @c (const Channel&)
+* @Return:       void
+**/
+void AudioMixer::apply(int channel, const Channel& c) {
+    float gain = 0.0f;
+    if (!c.source) return;
+    gain = this->effectiveGain(channel, c);
+    alSourcef(c.source, AL_MAX_GAIN, std::max(1.0f, gain));
+    alSourcef(c.source, AL_GAIN, gain);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        焦点或ducking改变后重新设置所有通道的音量（调用时持有mutex）
+* @Param:        void
+* @Return:       void
+**/
+void AudioMixer::applyAll() {
+    for (auto& it : this->channels) {
+        this->apply(it.first, it.second);
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef _AUDIOMIXER_H_
+#define _AUDIOMIXER_H_
+
+/**
+* @File name:    AudioMixer.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  多个播放器共用OpenAL上下文时的混音管理：每个播放器的音量/静音、焦点播放器以外的压低（ducking），
+*                以及静音且不在焦点的播放器暂停音频解码（监控墙等大量播放器同时运行时只解码听得到的音频），
+*                响度归一化的音量倍数也在这里与用户音量相乘后设置到source
+**/
+
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+
+#define AUDIOMIXER_DEFAULT_DUCK_GAIN    (0.25f)//有焦点播放器时其他播放器的音量倍数
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  单个通道（一个OpenALAudioSink）的状态快照，effectiveGain为实际设置到source的音量
+    **/
+    class AudioMixerChannel {
+    public:
+        AudioMixerChannel();
+        int channel;
+        std::string name;
+        float gain;
+        float normalizeGain;
+        float effectiveGain;
+        bool muted;
+        bool focused;
+        bool suspended;
+        bool playing;//已打开source
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  混音管理，线程安全。每个OpenALAudioSink构造时注册一个通道，open/close时绑定/解绑source，
+    *                音量设置立即作用到source（AL_GAIN）。通道静音（或音量为0）且不是焦点时视为挂起，
+    *                引擎的音频线程发现输出挂起后停止音频解码，用墙上时钟推进主时钟，取消挂起后重新同步
+    **/
+    class AudioMixer {
+    public:
+        static AudioMixer& global();
+
+        AudioMixer();
+
+        int addChannel(const std::string& name = "");
+        void removeChannel(int channel);
+        void setChannelName(int channel, const std::string& name);
+        void attachSource(int channel, unsigned int source);
+        void detachSource(int channel);
+
+        void setGain(int channel, float gain);
+        float getGain(int channel);
+        void setMute(int channel, bool mute);
+        bool isMuted(int channel);
+        void setNormalizeGain(int channel, float gain);
+        float getNormalizeGain(int channel);
+        void setFocus(int channel);
+        int getFocus();
+        void setDucking(bool enable, float duckGain = AUDIOMIXER_DEFAULT_DUCK_GAIN);
+        void setMasterGain(float gain);
+        void setAutoSuspend(bool enable);
+        bool isSuspended(int channel);
+        std::vector<AudioMixerChannel> getChannels();
+
+    private:
+
+        struct Channel {
+            std::string name;
+            float gain;
+            float normalizeGain;//响度归一化的音量倍数，与gain相乘
+            bool muted;
+            unsigned int source;//0表示未打开
+        };
+
+        float effectiveGain(int channel, const Channel& c);
+        bool suspended(int channel, const Channel& c);
+        void apply(int channel, const Channel& c);
+        void applyAll();
+
+        std::map<int, Channel> channels;
+        int nextChannel;
+
+        //焦点通道（-1表示没有），开启ducking时其他通道音量乘以duckGain
+        int focus;
+        bool ducking;
+        float duckGain;
+
+        float masterGain;
+        bool autoSuspend;
+
+        std::mutex mutex;
+    };
+
+
+};
+
+
+#endif//_AUDIOMIXER_H_
@@ -0,0 +1,743 @@
+#include "ClipExporter.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  ClipExporter.h的实现
+**/
+
+extern "C"{
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libavutil/avutil.h"
+}
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+
+using namespace MediaUse;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+ClipExporter::ClipExporter()
+    :in(0), out(0), exact(false), inContext(nullptr), outContext(nullptr), videoStream(-1), startTime(-1), videoDelay(0),
+    decoder(nullptr), encoder(nullptr), frame(nullptr), encoded(nullptr), lastEncodedPts(INT64_MIN), headActive(false),
+    result(CLIPEXPORTER_OK), progress(0.0f), exactApplied(false), threadShouldEnd(false), thread(nullptr) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构函数，取消未完成的导出
+* @Param:        void
+* @Return:       void
+**/
+ClipExporter::~ClipExporter() {
+    this->cancel();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        开始导出，立即返回，进度和结果由getProgress/getResult查询
+* @Param:        @input (const std::string&) 输入文件路径
+*                @output (const std::string&) 输出文件路径，容器格式由扩展名决定（.mp4/.mkv/.ts等）
+*                @in int64_t 入点（us）
+*                @out int64_t 出点（us）
+*                @exact bool 是否精确剪切（重新编码入点所在GOP的开头部分）
+* @Return:       bool 已有导出在进行时返回false
+**/
+bool ClipExporter::start(const std::string& input, const std::string& output, int64_t in, int64_t out, bool exact) {
+    if (this->thread) {
+        if (this->isRunning()) return false;
+        this->thread->join();
+        delete this->thread;
+        this->thread = nullptr;
+    }
+    this->input = input;
+    this->output = output;
+    this->in = in;
+    this->out = out;
+    this->exact = exact;
+    this->result = CLIPEXPORTER_RUNNING;
+    this->progress = 0.0f;
+    this->exactApplied = false;
+    this->threadShouldEnd = false;
+    this->thread = new std::thread(&ClipExporter::workerThread, this);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        取消导出并等待线程结束，未完成的输出文件被删除
+* @Param:        void
+* @Return:       void
+**/
+void ClipExporter::cancel() {
+    this->threadShouldEnd = true;
+    if (this->thread) {
+        this->thread->join();
+        delete this->thread;
+        this->thread = nullptr;
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否正在导出
+* @Param:        void
+* @Return:       bool
+**/
+bool ClipExporter::isRunning() {
+    return this->result == CLIPEXPORTER_RUNNING;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        导出结果
+* @Param:        void
+* @Return:       int CLIPEXPORTER_RUNNING、CLIPEXPORTER_OK 或 CLIPEXPORTER_ERROR_xxx
+**/
+int ClipExporter::getResult() {
+    return this->result;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        导出进度，按已写入的时间戳在入点到出点之间的位置估计
+* @Param:        void
+* @Return:       float 0~1
+**/
+float ClipExporter::getProgress() {
+    return this->progress;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        输出是否从精确的入点开始（请求了精确剪切且开头部分能够重新编码，或文件没有视频）
+* @Param:        void
+* @Return:       bool
+**/
+bool ClipExporter::wasExact() {
+    return this->exactApplied;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        导出的主流程：跳转到入点之前的关键帧，按packet复制到出点，精确剪切时开头部分经过解码器和编码器，
+*                读到下一个关键帧后衔接回复制
+* @Param:        void
+* @Return:       int CLIPEXPORTER_OK 或 CLIPEXPORTER_ERROR_xxx
+**/
+int ClipExporter::exportClip() {
+    int ret = 0;
+    int index = 0;
+    int remaining = 0;
+    int64_t pts = 0;
+    int64_t end = 0;
+    int64_t videoCopyFrom = 0;//视频从这个时间起复制，之前的（开放GOP的前导帧）丢弃
+    bool isVideo = false;
+    bool key = false;
+    bool firstVideo = true;
+    std::vector<bool> finished;
+    AVPacket* packet = nullptr;
+    AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+
+    if (this->out <= this->in) return CLIPEXPORTER_ERROR_RANGE;
+    ret = this->openInput();
+    if (ret != CLIPEXPORTER_OK) return ret;
+    ret = this->openOutput();
+    if (ret != CLIPEXPORTER_OK) return ret;
+
+    //没有视频时音频packet很短，入点本身就是精确的
+    this->exactApplied = this->exact && (this->videoStream < 0 || this->openHeadCodec());
+    this->startTime = (this->exactApplied || this->videoStream < 0) ? this->in : -1;
+    this->videoDelay = 0;
+
+    //跳转到入点或之前最近的关键帧
+    if (avformat_seek_file(this->inContext, -1, INT64_MIN, this->in, this->in, 0) < 0
+        && av_seek_frame(this->inContext, -1, this->in, AVSEEK_FLAG_BACKWARD) < 0 && this->in > 0) {
+        return CLIPEXPORTER_ERROR_INPUT;
+    }
+
+    //字幕流是稀疏的，只等音视频流到达出点
+    finished.assign(this->inContext->nb_streams, false);
+    for (unsigned int i = 0; i < this->inContext->nb_streams; i++) {
+        type = this->inContext->streams[i]->codecpar->codec_type;
+        if (this->streamMap[i] >= 0 && (type == AVMEDIA_TYPE_VIDEO || type == AVMEDIA_TYPE_AUDIO)) remaining++;
+    }
+    if (remaining == 0) return CLIPEXPORTER_ERROR_INPUT;
+
+    packet = av_packet_alloc();
+    if (!packet) return CLIPEXPORTER_ERROR_INPUT;
+    while (!this->threadShouldEnd && remaining > 0) {
+        if (av_read_frame(this->inContext, packet) < 0) break;//文件末尾或读取错误，已写入的部分仍然有效
+        index = packet->stream_index;
+        if (index >= (int)this->streamMap.size() || this->streamMap[index] < 0 || finished[index]) {
+            av_packet_unref(packet);
+            continue;
+        }
+        isVideo = index == this->videoStream;
+        key = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+        pts = this->packetTime(packet, false);
+        end = this->packetTime(packet, isVideo);//视频按dts判断出点，出点之前的帧参考的后向帧不会丢失
+        if (pts == AV_NOPTS_VALUE) {
+            av_packet_unref(packet);
+            continue;
+        }
+
+        if (end >= this->out) {
+            if (isVideo && this->headActive) ret = this->finishHead();
+            finished[index] = true;
+            type = this->inContext->streams[index]->codecpar->codec_type;
+            if (type == AVMEDIA_TYPE_VIDEO || type == AVMEDIA_TYPE_AUDIO) remaining--;
+            av_packet_unref(packet);
+            if (ret != CLIPEXPORTER_OK) break;
+            continue;
+        }
+
+        if (isVideo && firstVideo) {
+            firstVideo = false;
+            if (packet->pts != AV_NOPTS_VALUE && packet->dts != AV_NOPTS_VALUE && packet->pts > packet->dts) {
+                this->videoDelay = packet->pts - packet->dts;
+            }
+            if (this->startTime < 0) {
+                if (!key) {//跳转没有落在关键帧上，等待下一个关键帧
+                    firstVideo = true;
+                    av_packet_unref(packet);
+                    continue;
+                }
+                this->startTime = pts;//关键帧剪切，时间零点为第一个关键帧
+            }
+            videoCopyFrom = this->startTime;
+            if (this->headActive && key && pts >= this->in) {//入点正好是关键帧，不需要重新编码
+                this->release();
+                this->headActive = false;
+            }
+        }
+        if (this->startTime < 0) {//还没有读到第一个视频关键帧
+            av_packet_unref(packet);
+            continue;
+        }
+
+        if (isVideo && this->headActive) {
+            if (key && pts > this->in) {//下一个关键帧，结束重新编码，从这里开始复制并补上原参数集
+                ret = this->finishHead();
+                videoCopyFrom = pts;
+                if (ret == CLIPEXPORTER_OK) ret = this->writePacket(packet, true, false);
+            }
+            else {
+                ret = this->decodeHead(packet);
+            }
+        }
+        else if (pts >= (isVideo ? videoCopyFrom : this->startTime)) {
+            ret = this->writePacket(packet, false, false);
+        }
+        av_packet_unref(packet);
+        if (ret != CLIPEXPORTER_OK) break;
+        if (pts > this->startTime) {
+            this->progress = std::min(1.0f, (float)(pts - this->startTime) / (float)(this->out - this->startTime));
+        }
+    }
+    av_packet_free(&packet);
+    if (ret != CLIPEXPORTER_OK) return ret;
+    if (this->threadShouldEnd) return CLIPEXPORTER_ERROR_CANCELED;
+    if (this->headActive) {//出点之前没有下一个关键帧
+        ret = this->finishHead();
+        if (ret != CLIPEXPORTER_OK) return ret;
+    }
+    if (av_write_trailer(this->outContext) < 0) return CLIPEXPORTER_ERROR_OUTPUT;
+    this->progress = 1.0f;
+    return CLIPEXPORTER_OK;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开输入文件（独立于播放器的解封装器，导出期间播放不受影响），选择主视频流
+* @Param:        void
+* @Return:       int CLIPEXPORTER_OK 或 CLIPEXPORTER_ERROR_INPUT
+**/
+int ClipExporter::openInput() {
+    if (avformat_open_input(&this->inContext, this->input.c_str(), nullptr, nullptr) != 0) {
+        this->inContext = nullptr;
+        return CLIPEXPORTER_ERROR_INPUT;
+    }
+    if (avformat_find_stream_info(this->inContext, nullptr) < 0) return CLIPEXPORTER_ERROR_INPUT;
+    this->videoStream = av_find_best_stream(this->inContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (this->videoStream >= 0 && (this->inContext->streams[this->videoStream]->disposition & AV_DISPOSITION_ATTACHED_PIC)) {
+        this->videoStream = -1;//封面不是视频
+    }
+    return CLIPEXPORTER_OK;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        创建输出文件，复制输出容器支持的音视频流和字幕流的参数（不重新编码），封面和数据流不导出
+* @Param:        void
+* @Return:       int CLIPEXPORTER_OK 或 CLIPEXPORTER_ERROR_OUTPUT
+**/
+int ClipExporter::openOutput() {
+    AVStream* stream = nullptr;
+    AVStream* outStream = nullptr;
+    AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+    int supported = 0;
+    if (avformat_alloc_output_context2(&this->outContext, nullptr, nullptr, this->output.c_str()) < 0 || !this->outContext) {
+        this->outContext = nullptr;
+        return CLIPEXPORTER_ERROR_OUTPUT;
+    }
+    this->streamMap.assign(this->inContext->nb_streams, -1);
+    for (unsigned int i = 0; i < this->inContext->nb_streams; i++) {
+        stream = this->inContext->streams[i];
+        type = stream->codecpar->codec_type;
+        if (stream->disposition & AV_DISPOSITION_ATTACHED_PIC) continue;
+        if (type != AVMEDIA_TYPE_VIDEO && type != AVMEDIA_TYPE_AUDIO && type != AVMEDIA_TYPE_SUBTITLE) continue;
+        supported = avformat_query_codec(this->outContext->oformat, stream->codecpar->codec_id, FF_COMPLIANCE_NORMAL);
+        if (supported == 0 || (type == AVMEDIA_TYPE_SUBTITLE && supported != 1)) continue;//字幕只导出确定支持的
+        outStream = avformat_new_stream(this->outContext, nullptr);
+        if (!outStream || avcodec_parameters_copy(outStream->codecpar, stream->codecpar) < 0) return CLIPEXPORTER_ERROR_OUTPUT;
+        outStream->codecpar->codec_tag = 0;//由输出容器重新选择
+        outStream->time_base = stream->time_base;
+        outStream->disposition = stream->disposition;
+        av_dict_copy(&outStream->metadata, stream->metadata, 0);
+        this->streamMap[i] = outStream->index;
+    }
+    if (this->videoStream >= 0 && this->streamMap[this->videoStream] < 0) this->videoStream = -1;
+    if (!(this->outContext->oformat->flags & AVFMT_NOFILE)
+        && avio_open(&this->outContext->pb, this->output.c_str(), AVIO_FLAG_WRITE) < 0) {
+        return CLIPEXPORTER_ERROR_OUTPUT;
+    }
+    if (avformat_write_header(this->outContext, nullptr) < 0) return CLIPEXPORTER_ERROR_OUTPUT;
+    return CLIPEXPORTER_OK;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开精确剪切用的解码器和同一编码格式的编码器。编码器不使用B帧（dts与pts相同，按原视频的延迟对齐后
+*                与复制部分的dts连续），参数集写在码流中（不使用全局头）
+* @Param:        void
+* @Return:       bool 找不到或无法打开编码器返回false（退回关键帧剪切）
+**/
+bool ClipExporter::openHeadCodec() {
+    AVStream* stream = this->inContext->streams[this->videoStream];
+    const AVCodec* decodec = avcodec_find_decoder(stream->codecpar->codec_id);
+    const AVCodec* encodec = avcodec_find_encoder(stream->codecpar->codec_id);
+    AVRational rate = av_guess_frame_rate(this->inContext, stream, nullptr);
+    if (!decodec || !encodec || stream->codecpar->format < 0) return false;
+
+    this->decoder = avcodec_alloc_context3(decodec);
+    if (!this->decoder || avcodec_parameters_to_context(this->decoder, stream->codecpar) < 0) {
+        this->release();
+        return false;
+    }
+    this->decoder->pkt_timebase = stream->time_base;
+    if (avcodec_open2(this->decoder, decodec, nullptr) != 0) {
+        this->release();
+        return false;
+    }
+
+    this->encoder = avcodec_alloc_context3(encodec);
+    if (!this->encoder) {
+        this->release();
+        return false;
+    }
+    this->encoder->width = stream->codecpar->width;
+    this->encoder->height = stream->codecpar->height;
+    this->encoder->pix_fmt = (AVPixelFormat)stream->codecpar->format;
+    this->encoder->sample_aspect_ratio = stream->codecpar->sample_aspect_ratio;
+    this->encoder->color_range = stream->codecpar->color_range;
+    this->encoder->color_primaries = stream->codecpar->color_primaries;
+    this->encoder->color_trc = stream->codecpar->color_trc;
+    this->encoder->colorspace = stream->codecpar->color_space;
+    this->encoder->chroma_sample_location = stream->codecpar->chroma_location;
+    this->encoder->time_base = (rate.num > 0 && rate.den > 0) ? av_inv_q(rate) : stream->time_base;
+    this->encoder->framerate = rate;
+    this->encoder->bit_rate = stream->codecpar->bit_rate > 0 ? stream->codecpar->bit_rate
+        : (this->inContext->bit_rate > 0 ? this->inContext->bit_rate : CLIPEXPORTER_HEAD_BITRATE);
+    this->encoder->max_b_frames = 0;
+    this->encoder->gop_size = 1000;//开头部分不超过一个GOP，只需要第一帧为关键帧
+    if (avcodec_open2(this->encoder, encodec, nullptr) != 0) {
+        this->release();
+        return false;
+    }
+
+    this->frame = av_frame_alloc();
+    this->encoded = av_packet_alloc();
+    if (!this->frame || !this->encoded) {
+        this->release();
+        return false;
+    }
+    this->lastEncodedPts = INT64_MIN;
+    this->headActive = true;
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        开头部分的一个视频packet送入解码器，解码出的帧交给encodeHead
+* @Param:        @packet AVPacket* 视频packet，为null时冲刷解码器
+* @Return:       int CLIPEXPORTER_OK 或 CLIPEXPORTER_ERROR_xxx
+**/
+int ClipExporter::decodeHead(AVPacket* packet) {
+    int ret = avcodec_send_packet(this->decoder, packet);
+    if (ret < 0 && ret != AVERROR_INVALIDDATA && ret != AVERROR_EOF) return CLIPEXPORTER_ERROR_ENCODE;
+    while (avcodec_receive_frame(this->decoder, this->frame) == 0) {
+        ret = this->encodeHead(this->frame);
+        av_frame_unref(this->frame);
+        if (ret != CLIPEXPORTER_OK) return ret;
+    }
+    return CLIPEXPORTER_OK;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        入点到出点之间的帧送入编码器，编码出的packet按原视频的延迟设置dts后写入
+* @Param:        @frame AVFrame* 解码出的帧，为null时冲刷编码器
+* @Return:       int CLIPEXPORTER_OK 或 CLIPEXPORTER_ERROR_xxx
+**/
+int ClipExporter::encodeHead(AVFrame* frame) {
+    AVStream* stream = this->inContext->streams[this->videoStream];
+    int64_t pts = 0;
+    int64_t time = 0;
+    int ret = 0;
+    if (frame) {
+        pts = frame->best_effort_timestamp;
+        if (pts == AV_NOPTS_VALUE) return CLIPEXPORTER_OK;
+        time = av_rescale_q(pts, stream->time_base, AVRational{ 1, AV_TIME_BASE });
+        if (time < this->in || time >= this->out) return CLIPEXPORTER_OK;
+        if (frame->width != this->encoder->width || frame->height != this->encoder->height
+            || frame->format != this->encoder->pix_fmt) {
+            return CLIPEXPORTER_ERROR_ENCODE;
+        }
+        pts = av_rescale_q(pts, stream->time_base, this->encoder->time_base);
+        if (pts <= this->lastEncodedPts) return CLIPEXPORTER_OK;//可变帧率换算到编码器time_base后重复
+        this->lastEncodedPts = pts;
+        frame->pts = pts;
+        frame->pict_type = AV_PICTURE_TYPE_NONE;
+    }
+    ret = avcodec_send_frame(this->encoder, frame);
+    if (ret < 0 && ret != AVERROR_EOF) return CLIPEXPORTER_ERROR_ENCODE;
+    while ((ret = avcodec_receive_packet(this->encoder, this->encoded)) == 0) {
+        av_packet_rescale_ts(this->encoded, this->encoder->time_base, stream->time_base);
+        this->encoded->dts = this->encoded->pts - this->videoDelay;
+        this->encoded->stream_index = this->videoStream;
+        ret = this->writePacket(this->encoded, false, true);
+        av_packet_unref(this->encoded);
+        if (ret != CLIPEXPORTER_OK) return ret;
+    }
+    if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) return CLIPEXPORTER_ERROR_ENCODE;
+    return CLIPEXPORTER_OK;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        冲刷解码器和编码器，写出开头部分剩余的帧并释放它们
+* @Param:        void
+* @Return:       int CLIPEXPORTER_OK 或 CLIPEXPORTER_ERROR_xxx
+**/
+int ClipExporter::finishHead() {
+    int ret = this->decodeHead(nullptr);
+    if (ret == CLIPEXPORTER_OK) ret = this->encodeHead(nullptr);
+    this->release();
+    this->headActive = false;
+    return ret;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        写入一个packet，时间戳减去时间零点后换算到输出流。H.264/HEVC在衔接处的关键帧前补上原参数集
+*                （解码器从重新编码部分的参数集切换回来），重新编码的Annex B码流在MP4等长度前缀格式中转换为长度前缀
+* @Param:        @packet AVPacket* 输入流time_base的packet，写入后被重置
+*                @spliceKey bool 是否为衔接处的关键帧
+*                @encodedHead bool 是否为编码器输出
+* @Return:       int CLIPEXPORTER_OK 或 CLIPEXPORTER_ERROR_OUTPUT
+**/
+int ClipExporter::writePacket(AVPacket* packet, bool spliceKey, bool encodedHead) {
+    AVStream* stream = this->inContext->streams[packet->stream_index];
+    AVStream* outStream = this->outContext->streams[this->streamMap[packet->stream_index]];
+    int64_t offset = av_rescale_q(this->startTime, AVRational{ 1, AV_TIME_BASE }, stream->time_base);
+    int lengthSize = 0;
+    int ret = 0;
+    std::vector<uint8_t> data;
+    AVPacket* rewritten = nullptr;
+
+    if (spliceKey) {
+        parameterSets(stream, data);
+        if (!data.empty()) data.insert(data.end(), packet->data, packet->data + packet->size);
+    }
+    else if (encodedHead && lengthPrefixed(stream, lengthSize)) {
+        annexbToLength(packet->data, packet->size, lengthSize, data);
+    }
+    if (!data.empty()) {
+        rewritten = av_packet_alloc();
+        if (!rewritten || av_new_packet(rewritten, (int)data.size()) < 0) {
+            av_packet_free(&rewritten);
+            return CLIPEXPORTER_ERROR_OUTPUT;
+        }
+        memcpy(rewritten->data, data.data(), data.size());
+        av_packet_copy_props(rewritten, packet);
+        rewritten->stream_index = packet->stream_index;
+        packet = rewritten;
+    }
+
+    if (packet->pts != AV_NOPTS_VALUE) packet->pts -= offset;
+    if (packet->dts != AV_NOPTS_VALUE) packet->dts -= offset;
+    av_packet_rescale_ts(packet, stream->time_base, outStream->time_base);
+    packet->stream_index = outStream->index;
+    packet->pos = -1;
+    ret = av_interleaved_write_frame(this->outContext, packet);
+    av_packet_free(&rewritten);
+    return ret < 0 ? CLIPEXPORTER_ERROR_OUTPUT : CLIPEXPORTER_OK;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        packet的时间（us，流的时间戳）
+* @Param:        @packet AVPacket*
+*                @preferDts bool 优先使用dts
+* @Return:       int64_t 没有时间戳返回AV_NOPTS_VALUE
+**/
+int64_t ClipExporter::packetTime(AVPacket* packet, bool preferDts) {
+    int64_t ts = packet->pts;
+    if (ts == AV_NOPTS_VALUE || (preferDts && packet->dts != AV_NOPTS_VALUE)) ts = packet->dts;
+    if (ts == AV_NOPTS_VALUE) return AV_NOPTS_VALUE;
+    return av_rescale_q(ts, this->inContext->streams[packet->stream_index]->time_base, AVRational{ 1, AV_TIME_BASE });
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        释放开头部分的解码器和编码器
+* @Param:        void
+* @Return:       void
+**/
+void ClipExporter::release() {
+    if (this->decoder) {
+        avcodec_free_context(&this->decoder);
+    }
+    if (this->encoder) {
+        avcodec_free_context(&this->encoder);
+    }
+    if (this->frame) {
+        av_frame_free(&this->frame);
+    }
+    if (this->encoded) {
+        av_packet_free(&this->encoded);
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        导出线程，结束后关闭文件，失败或取消时删除不完整的输出
+* @Param:        void
+* @Return:       void
+**/
+void ClipExporter::workerThread() {
+    int ret = this->exportClip();
+    this->release();
+    this->headActive = false;
+    if (this->outContext) {
+        if (!(this->outContext->oformat->flags & AVFMT_NOFILE)) avio_closep(&this->outContext->pb);
+        avformat_free_context(this->outContext);
+        this->outContext = nullptr;
+    }
+    if (this->inContext) {
+        avformat_close_input(&this->inContext);
+    }
+    if (ret != CLIPEXPORTER_OK) std::remove(this->output.c_str());
+    this->result = ret;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        H.264/HEVC流是否为长度前缀格式（MP4/MKV中的avcC/hvcC），不是则为Annex B起始码格式（TS等）
+* @Param:        @stream (const AVStream*) 输入视频流
+*                @lengthSize int& 输出NAL长度字段的字节数
+* @Return:       bool
+**/
+bool ClipExporter::lengthPrefixed(const AVStream* stream, int& lengthSize) {
+    const uint8_t* p = stream->codecpar->extradata;
+    int size = stream->codecpar->extradata_size;
+    if (!p) return false;
+    if (stream->codecpar->codec_id == AV_CODEC_ID_H264 && size >= 7 && p[0] == 1) {
+        lengthSize = (p[4] & 3) + 1;
+        return true;
+    }
+    if (stream->codecpar->codec_id == AV_CODEC_ID_HEVC && size >= 23
+        && !(p[0] == 0 && p[1] == 0 && (p[2] == 1 || (p[2] == 0 && p[3] == 1)))) {
+        lengthSize = (p[21] & 3) + 1;
+        return true;
+    }
+    return false;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        取出H.264/HEVC流的参数集（SPS/PPS，HEVC另有VPS），格式与流中的packet相同，其他编码格式为空
+* @Param:        @stream (const AVStream*) 输入视频流
+*                @data (std::vector<uint8_t>&) 输出
+* @Return:       void
+**/
+void ClipExporter::parameterSets(const AVStream* stream, std::vector<uint8_t>& data) {
+    const uint8_t* p = stream->codecpar->extradata;
+    int size = stream->codecpar->extradata_size;
+    int lengthSize = 0;
+    int pos = 0;
+    int arrays = 0;
+    int count = 0;
+    int length = 0;
+    AVCodecID codec = stream->codecpar->codec_id;
+    data.clear();
+    if (!p || size <= 0 || (codec != AV_CODEC_ID_H264 && codec != AV_CODEC_ID_HEVC)) return;
+    if (!lengthPrefixed(stream, lengthSize)) {//Annex B的extradata本身就是带起始码的参数集
+        data.assign(p, p + size);
+        return;
+    }
+
+    //avcC: 5字节头，SPS个数+SPS，PPS个数+PPS；hvcC: 22字节头，按类型分组的数组
+    if (codec == AV_CODEC_ID_H264) {
+        arrays = 2;
+        pos = 5;
+    }
+    else {
+        arrays = p[22];
+        pos = 23;
+    }
+    for (int a = 0; a < arrays; a++) {
+        if (codec == AV_CODEC_ID_H264) {
+            if (pos >= size) break;
+            count = a == 0 ? (p[pos] & 0x1f) : p[pos];
+            pos += 1;
+        }
+        else {
+            if (pos + 3 > size) break;
+            count = (p[pos + 1] << 8) | p[pos + 2];
+            pos += 3;
+        }
+        for (int i = 0; i < count; i++) {
+            if (pos + 2 > size) {
+                data.clear();
+                return;
+            }
+            length = (p[pos] << 8) | p[pos + 1];
+            pos += 2;
+            if (pos + length > size) {
+                data.clear();
+                return;
+            }
+            for (int b = lengthSize - 1; b >= 0; b--) data.push_back((uint8_t)((length >> (8 * b)) & 0xff));
+            data.insert(data.end(), p + pos, p + pos + length);
+            pos += length;
+        }
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        Annex B起始码格式转换为长度前缀格式，去掉NAL之间的填充零，没有起始码时原样复制
+* @Param:        @data (const uint8_t*) Annex B数据
+*                @size int 字节数
+*                @lengthSize int 长度字段字节数
+*                @out (std::vector<uint8_t>&) 输出
+* @Return:       void
+**/
+void ClipExporter::annexbToLength(const uint8_t* data, int size, int lengthSize, std::vector<uint8_t>& out) {
+    std::vector<std::pair<int, int>> nals;
+    int start = -1;
+    int end = 0;
+    int i = 0;
+    out.clear();
+    while (i + 2 < size) {
+        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) {
+            if (start >= 0) nals.push_back(std::pair<int, int>(start, i));
+            i += 3;
+            start = i;
+        }
+        else {
+            i++;
+        }
+    }
+    if (start < 0) {
+        out.assign(data, data + size);
+        return;
+    }
+    nals.push_back(std::pair<int, int>(start, size));
+    for (auto& nal : nals) {
+        end = nal.second;
+        while (end > nal.first && data[end - 1] == 0) end--;//下一个4字节起始码的首个0和填充零
+        if (end <= nal.first) continue;
+        for (int b = lengthSize - 1; b >= 0; b--) out.push_back((uint8_t)(((end - nal.first) >> (8 * b)) & 0xff));
+        out.insert(out.end(), data + nal.first, data + end);
+    }
+}
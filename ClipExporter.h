@@ -0,0 +1,116 @@
+#ifndef _CLIPEXPORTER_H_
+#define _CLIPEXPORTER_H_
+
+/**
+* @File name:    ClipExporter.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  片段导出：在后台线程把入点到出点之间的packet直接复制到新文件（不重新编码，速度取决于磁盘），
+*                需要精确入点时只重新编码入点所在GOP的开头部分，从下一个关键帧起仍然复制，不依赖Qt
+**/
+
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+struct AVStream;
+
+
+#define CLIPEXPORTER_OK                 (0)
+#define CLIPEXPORTER_RUNNING            (1)//导出中
+#define CLIPEXPORTER_ERROR_INPUT        (-1)//输入文件打开或跳转失败
+#define CLIPEXPORTER_ERROR_OUTPUT       (-2)//输出文件创建或写入失败（格式由扩展名决定）
+#define CLIPEXPORTER_ERROR_RANGE        (-3)//出点不在入点之后
+#define CLIPEXPORTER_ERROR_ENCODE       (-4)//精确剪切时开头部分重新编码失败
+#define CLIPEXPORTER_ERROR_CANCELED     (-5)//被cancel取消
+
+#define CLIPEXPORTER_HEAD_BITRATE       (8000000)//原视频没有码率信息时开头部分重新编码使用的码率
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  片段导出，start后在后台线程运行，输出已有文件会被覆盖，失败或取消时删除输出文件，线程安全。
+    *                入点/出点与PlayerEngine::getCurrentPts相同（us，流的时间戳）。不精确剪切时从入点之前的关键帧开始；
+    *                精确剪切时入点到下一个关键帧之间的视频重新编码（H.264/HEVC在衔接处补上原参数集），
+    *                找不到编码器时退回到关键帧剪切（wasExact返回false）
+    **/
+    class ClipExporter {
+    public:
+        ClipExporter();
+        ~ClipExporter();
+
+        bool start(const std::string& input, const std::string& output, int64_t in, int64_t out, bool exact = false);
+        void cancel();
+        bool isRunning();
+        int getResult();
+        float getProgress();
+        bool wasExact();
+
+    private:
+        ClipExporter(const ClipExporter&) = delete;
+        ClipExporter& operator=(const ClipExporter&) = delete;
+
+        int exportClip();
+        int openInput();
+        int openOutput();
+        bool openHeadCodec();
+        int decodeHead(AVPacket* packet);
+        int encodeHead(AVFrame* frame);
+        int finishHead();
+        int writePacket(AVPacket* packet, bool spliceKey, bool encodedHead);
+        int64_t packetTime(AVPacket* packet, bool preferDts);
+        void release();
+        void workerThread();
+
+        static bool lengthPrefixed(const AVStream* stream, int& lengthSize);
+        static void parameterSets(const AVStream* stream, std::vector<uint8_t>& data);
+        static void annexbToLength(const uint8_t* data, int size, int lengthSize, std::vector<uint8_t>& out);
+
+        std::string input;
+        std::string output;
+        int64_t in;
+        int64_t out;
+        bool exact;
+
+        //导出线程使用的ffmpeg资源，与播放器的解封装器相互独立
+        AVFormatContext* inContext;
+        AVFormatContext* outContext;
+        std::vector<int> streamMap;//输入流下标到输出流下标，-1表示不导出
+        int videoStream;
+        int64_t startTime;//输出的时间零点（us），不精确剪切时为第一个关键帧的时间
+        int64_t videoDelay;//视频流pts与dts的差（输入流time_base），重新编码部分的dts按它对齐
+
+        //精确剪切开头部分的解码器和编码器
+        AVCodecContext* decoder;
+        AVCodecContext* encoder;
+        AVFrame* frame;
+        AVPacket* encoded;
+        int64_t lastEncodedPts;
+        bool headActive;
+
+        std::atomic<int> result;
+        std::atomic<float> progress;
+        std::atomic<bool> exactApplied;
+        std::atomic<bool> threadShouldEnd;
+        std::thread* thread;
+    };
+
+
+};
+
+
+#endif//_CLIPEXPORTER_H_
@@ -15,64 +15,23 @@
 #include<QGL>
 
 #include <string>
-#include <thread>
+#include <vector>
+#include <deque>
 #include <mutex>
-#include <condition_variable>
-#include <future>
-#include <fstream>
-extern "C" {
-#include "libavutil/avutil.h"
-}
-#include"MediaUse.h"
-
-struct AVFormatContext;
-struct AVStream;
-struct AVCodecContext;
-struct AVPacket;
-struct AVFrame;
-struct SwsContext;
-struct SwrContext;
-struct GLFWwindow;
-struct ALCdevice;
-struct ALCcontext;
-class QSurface;
-class QTimer;
-class QOpenGLFunctions_3_0;
+#include <atomic>
+#include <functional>
+#include"PlayerEngine.h"
+#include"OpenALAudioSink.h"
 
 
-/**
-* @Author:       Li
-* @Version:      1.0
-* @Date:         2025-03-26
-* @Description:  解码器状态和播放状态的define
-**/
-#define CPPPLAYER_DEFINE
-#define CPPPLAYER_DECODER_UNKNOW     (0x00)
-#define CPPPLAYER_DECODER_EOF		 (0x01)
-#define CPPPLAYER_DECODER_ADVANCE	 (0x02)
-#define CPPPLAYER_DECODER_BACK		 (0x04)
-#define CPPPLAYER_DECODER_PAUSE		 (0x08)
-#define CPPPLAYER_DECODER_STOP		 (0x10)
-#define CPPPLAYER_DECODER_ING		 (0x20)
-#define CPPPLAYER_DECODER_GOTO		 (0x40)
-#define CPPPLAYER_DECODER_BUSY       (0x46)
-
-#define CPPPLAYER_AV_UNKNOW			 (0x00)
-#define CPPPLAYER_AV_PLAYING	     (0x01)
-#define CPPPLAYER_AV_PAUSE			 (0x02)
-#define CPPPLAYER_AV_STOP			 (0x04)
-#define CPPPLAYER_AV_CHANGE			 (0x08)
-#define CPPPLAYER_AV_A_FRAME         (0x10)
-
-//std::cout输出字符颜色修改
-#define CPPPLAYER_COLOR_RESET		"\033[0m"
-#define CPPPLAYER_COLOR_RED			"\033[31m"
-#define CPPPLAYER_COLOR_GREEN		"\033[32m"
-#define CPPPLAYER_COLOR_YELLOW		"\033[33m"
-#define CPPPLAYER_COLOR_BLUE		"\033[33m"
-
-//define开启debug，不需要请注释
-#define CPPPLAYER_DEBUG
+//预先光栅化的字幕图像最多保留的个数，以及提前上传为纹理的时间（us，每次绘制最多提前上传一个）
+#define CPPPLAYER_SUBTITLE_CACHE            (8)
+#define CPPPLAYER_SUBTITLE_UPLOAD_AHEAD     (1000000)
+
+class QOpenGLFunctions_3_0;
+class QOffscreenSurface;
+class QSurface;
+class QTimer;
 
 
 
@@ -80,7 +39,8 @@ class QOpenGLFunctions_3_0;
 * @Author:       Li
 * @Version:      1.0
 * @Date:         2025-03-26
-* @Description:  能够独立运行或嵌入其他Qt窗口的player类，使用了OpenGL、OpenAL、FFmpeg库
+* @Description:  能够独立运行或嵌入其他Qt窗口的player类，使用了OpenGL、OpenAL、FFmpeg库，
+*                解码和同步由PlayerEngine完成，本类提供OpenGL视频输出和按键操作
 **/
 class CppPlayer:public QGLWidget{
     Q_OBJECT
@@ -95,7 +55,10 @@ protected:
     void paintGL();
     void resizeGL(int width, int height);
     void keyPressEvent(QKeyEvent* e);
+    void showEvent(QShowEvent* e);
+    void hideEvent(QHideEvent* e);
     void loadGLTexture(QOpenGLFunctions_3_0* openGL_funcs);
+    void drawVideoQuad();
 
 signals:
     void updateGLrender();
@@ -104,148 +67,141 @@ signals:
     void playerEnd();
 
 public:
-    static void resourceInit();
-    static void releaseResource();
-
-    void setPath(const std::string str);
-    bool avOpen();
-    void avStart();
-    void join();
-    void avStop();
-    bool avPause();
-    bool avResume();
-    void setOffset(std::pair<int64_t, AVRational> x);
-    bool setCurrentPts(std::pair<int64_t, AVRational> x);
-    void avAdvance();
-    void avBack();
-    bool avRestart();
-    bool isRunning();
-    bool playerCouldBeOperate();
-    uint8_t getPlayStatus();
-    uint8_t getDecoderStatus();
-    std::pair<int64_t, AVRational> getCurrentPts();
-    std::pair<int64_t, AVRational> getDuration();
+    MediaUse::PlayerEngine& getEngine();
+    int getMixerChannel();
+    void setStatsOverlay(bool show);
+    bool nextAudioTrack();
+    bool nextSubtitleTrack();
+    void setPowerSaving(bool enable, uint8_t mode = CPPPLAYER_BACKGROUND_DISCARD);
+    bool isPowerSaving();
+    double getPowerSavedMs();
+    void setOfflineMode(bool offline, const std::string& audioPath = "");
+    bool isOfflineMode();
+    void setOfflineFrameCallback(std::function<void(const unsigned char* rgb, int width, int height, int64_t pts)> callback);
 
 private:
 
-    bool videoDecoderOneFrame(SwsContext*& swsContext, AVPacket*& packet, AVFrame*& frame, std::queue<MediaUse::AVDataInfo>& frameDataQueue);
-    void avClear();
-    void avInit();
-    void ffmpegErrorPrint(int errEnum);
-    void messagePrint(const char* str, const char* color);
-
-    void ffmpegReadThread();
-    void openGLrenderThread();
-    void openALoutputThread();
-
-    //跳转时给渲染或音频输出线程刷新信号，即告诉线程队列的数据是过时或超时的，需要清空和切换队列
-    bool videoShouldFlush;
-    bool audioShouldFlush;
-
-    //表示渲染或音频输出准备完毕，随时可以开始
-    bool videoReady;
-    bool audioReady;
-
-    //表示音频线程正在等待某些条件而暂停输出
-    bool audioIsWaiting;
-
-    //表示是否该结束播放和解码了，用于控制整个播放器的随时退出
-    bool playerShouldEnd;
-
-    //表示视频流是否只有一张图片（或mp3封面）
-    bool justCover;
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  OpenGL视频输出，转发给CppPlayer的sinkXxx（不直接继承VideoSink，避免close与QWidget::close冲突）
+    **/
+    class GLVideoSink :public MediaUse::VideoSink {
+    public:
+        GLVideoSink(CppPlayer* player) :player(player) {}
+        bool open(int width, int height) override { return this->player->sinkOpen(width, height); }
+        void close() override { this->player->sinkClose(); }
+        bool canStage() override { return this->player->PBOcount < 2; }
+        bool stage(const MediaUse::AVDataInfo& frame) override { return this->player->sinkStage(frame); }
+        void present(int64_t pts) override { this->player->sinkPresent(pts); }
+        void flush() override { this->player->PBOcount = 0; }
+    private:
+        CppPlayer* player;
+    };
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  字幕输出，转发给CppPlayer的subtitleXxx（在引擎的字幕线程调用）
+    **/
+    class GLSubtitleSink :public MediaUse::SubtitleSink {
+    public:
+        GLSubtitleSink(CppPlayer* player) :player(player) {}
+        void show(const MediaUse::SubtitleEvent& event) override { this->player->subtitleShow(event); }
+        void flush() override { this->player->subtitleFlush(); }
+    private:
+        CppPlayer* player;
+    };
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  光栅化好的一张字幕图像（RGBA，非预乘），left/top/right/bottom为在视频视口中的位置（-1~1），
+    *                texture在界面线程第一次需要时由rgba上传（上传后rgba释放），0表示还未上传
+    **/
+    class SubtitleImage {
+    public:
+        SubtitleImage() :start(0), end(INT64_MAX), left(0), top(0), right(0), bottom(0), width(0), height(0), texture(0) {}
+        int64_t start;
+        int64_t end;
+        float left;
+        float top;
+        float right;
+        float bottom;
+        int width;
+        int height;
+        std::vector<unsigned char> rgba;
+        GLuint texture;
+    };
+
+    void subtitleShow(const MediaUse::SubtitleEvent& event);
+    void subtitleFlush();
+    void drawSubtitles();
+    void statsSample();
+
+    bool sinkOpen(int width, int height);
+    void sinkClose();
+    bool sinkStage(const MediaUse::AVDataInfo& frame);
+    void sinkPresent(int64_t pts);
+    bool offlineTargetCreate();
+    void offlineRender(int64_t pts);
 
     //是否需要全屏
     bool fullScreen;
 
-    //视频渲染线程当前是否在使用解码器，避免在使用解码器时解码线程对解码器进行刷新操作导致视频解码异常
-    bool videoIsDecoding;
-
-    //判断音视频是否播放完毕，以便在设置循环播放模式下重新解码播放
-    bool videoEnd;
-    bool audioEnd;
-
-    //资源初始化，避免多次对音频输出设备初始化
-    static bool resourceInitOnce;
-
-    //对在多线程中经常读写的变量操作原子化
-    std::atomic<uint8_t> queueUseIndex;
-    std::atomic<uint8_t> queueFlushIndex;
-    std::atomic<uint8_t> decoderStatus;
-    std::atomic<uint8_t> playerStatus;
-    std::atomic<int64_t> videoPts;
-    std::atomic<int64_t> audioPts;
-
-    //文件解码信息
-    float videoAvgFrame;
-    int audioSampleRate;
-    int videoStreamIndex;
-    int audioStreamIndex;
+    //是否在画面上叠加显示运行统计。getStats会短暂获取各组件的锁，由statsTimer每200ms采样一次
+    //并拆成行放入statsLines，paintGL只绘制采样结果
+    bool statsOverlay;
+    QTimer* statsTimer;
+    std::vector<QString> statsLines;
+
+    //省电模式：窗口隐藏或最小化时引擎进入后台模式（CPPPLAYER_BACKGROUND_xxx），重新显示时同步回来
+    bool powerSaving;
+    uint8_t powerSavingMode;
+
+    //离线模式：视频渲染到离屏FBO（可回读给offlineFrameCallback），音频写入WAV文件（路径为空则丢弃）
+    //offscreenSurface在界面线程创建，offlineFBO/offlineTexture/offlineReadback只在视频线程使用
+    QOffscreenSurface* offscreenSurface;
+    std::function<void(const unsigned char*, int, int, int64_t)> offlineFrameCallback;
+    GLuint offlineFBO;
+    GLuint offlineTexture;
+    std::vector<unsigned char> offlineReadback;
+
+    //字幕：字幕线程把事件光栅化为RGBA图像放入subtitleImages（按开始时间先后，最多CPPPLAYER_SUBTITLE_CACHE个），
+    //界面线程在paintGL中按最近显示的视频帧的pts（subtitlePts）选出当前的图像，作为纹理混合绘制在视频上。
+    //淘汰或清除的图像的纹理只能在界面线程删除，先放入subtitleTextureTrash。subtitleMutex保护这两个容器
+    std::mutex subtitleMutex;
+    std::deque<SubtitleImage> subtitleImages;
+    std::vector<GLuint> subtitleTextureTrash;
+    std::atomic<int64_t> subtitlePts;
+
+    //视频图像大小
     int windowWidth;
     int windowHeight;
 
-    //OpenGL资源
+    //OpenGL资源，两个PBO轮流暂存帧，PBOhead为最早暂存的一个，PBOcount为暂存的帧数
     GLuint videoTexture;
     GLuint PBO[2];
+    int PBOhead;
+    int PBOcount;
 
-    //文件路径或地址
-    std::string path;
-
-    //用于纯OpenGL键盘读取（已经弃用）
-    std::pair<int, int> lastKey;
-
-    //音视频时长 <size,单位>
-    std::pair<int64_t, AVRational> duration;
-
-    //单次前进或后退偏移时长
-    std::pair<int64_t, AVRational> offset;
-
-    //指定跳转的pts
-    std::pair<int64_t, AVRational> gotoPts;
-
-    //OpenGL、OpenAL资源
-    AVRational videoTimeBase;
-    AVRational audioTimeBase;
-    AVFormatContext* formatContext;
-    AVStream* videoStream;
-    AVStream* audioStream;
-    AVCodecContext* videoCodecContext;
-    AVCodecContext* audioCodecContext;
-    SwrContext* swrContext;
-    static ALCdevice* device;
-    static ALCcontext* context;
-
-    //视频流包队列、音频流帧队列，采用双队列机制，确保跳转时ffmpeg无需等待两个子线程放弃或清空当前队列，直接读取和解码到另一个队列
-    MediaUse::MediaDataQueue<AVPacket*> videoPacketQueue[2];
-    MediaUse::MediaDataQueue<MediaUse::AVDataInfo> audioDataQueue[2];
-
-    //用户按键操作队列
-    MediaUse::MediaDataQueue<Qt::Key> userOperationQueue;
-
-    //用于当前音频播放帧的pts存储，即OpenAL音频输出缓存队列有空时拿出一个buffer并填充新数据后入队SourceQueue，这时候audioPlayingQueue同步也pop一个push一个
-    MediaUse::AVFifoLoop<int64_t> audioPlayingQueue;
-
-    //三个线程，每次更换文件播放会重新new
-    std::future<void>* ffmpegThread;
-    std::future<void>* openGLthread;
-    std::future<void>* openALthread;
-
-    //解码状态锁，ffmpeg线程解码完后会使用条件变量等待其他信号激活
-    std::mutex decoderStatus_mutex;
-    std::condition_variable decoderStatus_cv;
-
-    //OpenAL静态设备锁
-    static std::mutex device_mutex;
-
-    //当前OpenGL上下文
+    //当前OpenGL上下文（界面线程），以及视频线程中共享它的上下文
     QOpenGLContext* mainGLContext;
     QSurface* mainSurface;
+    QOpenGLContext* sharedContext;
+    QOpenGLFunctions_3_0* openGL_funcs;
+
+    //视频输出；音频输出，正常播放使用OpenAL，离线模式写入WAV文件。输出需要在engine之前构造、之后析构
+    GLVideoSink videoSink;
+    GLSubtitleSink subtitleSink;
+    MediaUse::OpenALAudioSink openALSink;
+    MediaUse::WavAudioSink wavSink;
 
-    //debug日志
-#ifdef CPPPLAYER_DEBUG
-    std::ofstream log;
-    std::mutex log_mutex;
-#endif
+    //播放引擎
+    MediaUse::PlayerEngine engine;
 
 };
 
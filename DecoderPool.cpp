@@ -0,0 +1,474 @@
+#include "DecoderPool.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  DecoderPool.h的实现
+**/
+
+#include <chrono>
+#include <cstdio>
+#include <cinttypes>
+#include <algorithm>
+
+using namespace MediaUse;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+DecoderPoolClientStats::DecoderPoolClientStats() :client(-1), priority(0), tasks(0), slices(0), steals(0), waits(0),
+    busyUs(0), units(0), elapsedUs(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        吞吐量：加入调度器以来平均每秒完成的工作量
+* @Param:        void
+* @Return:       double
+**/
+double DecoderPoolClientStats::unitsPerSecond() const {
+    if (this->elapsedUs <= 0) return 0.0;
+    return this->units * 1000000.0 / this->elapsedUs;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        占用率：任务运行时间 / 加入调度器至今的时间，以一个线程计
+* @Param:        void
+* @Return:       double
+**/
+double DecoderPoolClientStats::busyRatio() const {
+    if (this->elapsedUs <= 0) return 0.0;
+    return (double)this->busyUs / this->elapsedUs;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+DecoderPoolStats::DecoderPoolStats() :threads(0), slices(0), steals(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        转换为多行文本，每个调用者一行
+* @Param:        void
+* @Return:       std::string
+**/
+std::string DecoderPoolStats::toString() const {
+    char buf[512] = { 0 };
+    std::string str;
+    snprintf(buf, sizeof(buf), "decoder pool threads %d  slices %" PRIu64 "  steals %" PRIu64 "\n", this->threads, this->slices, this->steals);
+    str += buf;
+    for (size_t i = 0; i < this->clients.size(); i++) {
+        const DecoderPoolClientStats& c = this->clients[i];
+        snprintf(buf, sizeof(buf), "#%d prio %d  busy %.1f%%  %.1f units/s  slices %" PRIu64 "  steals %" PRIu64 "  waits %" PRIu64 "  %s\n",
+            c.client, c.priority, c.busyRatio() * 100, c.unitsPerSecond(), c.slices, c.steals, c.waits, c.name.c_str());
+        str += buf;
+    }
+    return str;
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        进程共享的调度器，第一次使用时创建
+* @Param:        void
+* @Return:       DecoderPool&
+**/
+DecoderPool& DecoderPool::global() {
+    static DecoderPool pool;
+    return pool;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数，需要start后才能提交任务
+* @Param:        void
+* @Return:       void
+**/
+DecoderPool::DecoderPool() :running(false), threadShouldEnd(true), queued(0), nextWorker(0), nextClient(0),
+    totalSlices(0), totalSteals(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，结束工作线程
+* @Param:        void
+* @Return:       void
+**/
+DecoderPool::~DecoderPool() {
+    this->stop();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        单调时钟（us）
+* @Param:        void
+* @Return:       int64_t
+**/
+int64_t DecoderPool::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        创建工作线程，已经运行时不做任何操作
+* @Param:        @threadCount int 线程数，不大于0时使用CPU核心数
+* @Return:       bool 成功返回true
+**/
+bool DecoderPool::start(int threadCount) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->running.load()) return true;
+    if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 4;
+    this->threadShouldEnd = false;
+    for (int i = 0; i < threadCount; i++) {
+        this->workers.push_back(new Worker);
+    }
+    for (int i = 0; i < threadCount; i++) {
+        this->threads.push_back(new std::thread(&DecoderPool::workerThread, this, i));
+    }
+    this->running.store(true);
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        结束工作线程，未结束的任务以DECODERPOOL_BUDGET_CANCEL调用直到返回DECODERPOOL_TASK_DONE，
+*                使任务走完结束流程（播放器的join等待的promise在其中设置）
+* @Param:        void
+* @Return:       void
+**/
+void DecoderPool::stop() {
+    std::vector<Task*> remaining;
+    uint64_t units = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->running.load()) return;
+        this->threadShouldEnd = true;
+    }
+    this->cv.notify_all();
+    for (size_t i = 0; i < this->threads.size(); i++) {
+        this->threads[i]->join();
+        delete this->threads[i];
+    }
+    this->threads.clear();
+    for (size_t i = 0; i < this->workers.size(); i++) {
+        remaining.insert(remaining.end(), this->workers[i]->queue.begin(), this->workers[i]->queue.end());
+        delete this->workers[i];
+    }
+    this->workers.clear();
+    for (auto it = this->waiting.begin(); it != this->waiting.end(); it++) {
+        remaining.push_back(it->second);
+    }
+    this->waiting.clear();
+    this->queued.store(0);
+    for (size_t i = 0; i < remaining.size(); i++) {//工作线程已全部结束，任务在本线程中依次结束
+        while (remaining[i]->step(DECODERPOOL_BUDGET_CANCEL, units) != DECODERPOOL_TASK_DONE);
+        remaining[i]->client->tasks--;
+        delete remaining[i];
+    }
+    this->running.store(false);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否正在运行
+* @Param:        void
+* @Return:       bool
+**/
+bool DecoderPool::isRunning() {
+    return this->running.load();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        工作线程数
+* @Param:        void
+* @Return:       int
+**/
+int DecoderPool::getThreadCount() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return (int)this->threads.size();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        注册调用者
+* @Param:        @name const std::string& 用于统计显示的名字（如文件路径）
+*                @priority int 优先级，限制在[DECODERPOOL_PRIORITY_LOW, DECODERPOOL_PRIORITY_MAX]
+* @Return:       int 调用者编号
+**/
+int DecoderPool::addClient(const std::string& name, int priority) {
+    std::shared_ptr<Client> client = std::make_shared<Client>();
+    client->name = name;
+    client->priority.store(std::min(std::max(priority, DECODERPOOL_PRIORITY_LOW), DECODERPOOL_PRIORITY_MAX));
+    client->tasks.store(0);
+    client->slices.store(0);
+    client->steals.store(0);
+    client->waits.store(0);
+    client->busyUs.store(0);
+    client->units.store(0);
+    client->addedAt = now();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    client->id = this->nextClient++;
+    this->clients[client->id] = client;
+    return client->id;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        注销调用者，之后不再出现在统计中，需要在它的任务都结束后调用
+* @Param:        @client int 调用者编号
+* @Return:       void
+**/
+void DecoderPool::removeClient(int client) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->clients.erase(client);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        修改优先级，下一个时间片生效
+* @Param:        @client int 调用者编号
+*                @priority int 优先级
+* @Return:       void
+**/
+void DecoderPool::setPriority(int client, int priority) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->clients.find(client);
+    if (it == this->clients.end()) return;
+    it->second->priority.store(std::min(std::max(priority, DECODERPOOL_PRIORITY_LOW), DECODERPOOL_PRIORITY_MAX));
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        提交任务，任务会被反复调用直到返回DECODERPOOL_TASK_DONE
+* @Param:        @client int 调用者编号
+*                @step DecoderPoolStep 任务单步函数
+* @Return:       bool 调度器未运行或调用者不存在时返回false
+**/
+bool DecoderPool::submit(int client, DecoderPoolStep step) {
+    Task* task = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto it = this->clients.find(client);
+        if (!this->running.load() || it == this->clients.end()) return false;
+        task = new Task;
+        task->client = it->second;
+        task->step = step;
+        task->client->tasks++;
+    }
+    this->push(this->nextWorker.fetch_add(1) % this->workers.size(), task);
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取统计
+* @Param:        @stats DecoderPoolStats& 输出
+* @Return:       void
+**/
+void DecoderPool::getStats(DecoderPoolStats& stats) {
+    int64_t t = now();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    stats.threads = (int)this->threads.size();
+    stats.slices = this->totalSlices.load();
+    stats.steals = this->totalSteals.load();
+    stats.clients.clear();
+    for (auto it = this->clients.begin(); it != this->clients.end(); it++) {
+        DecoderPoolClientStats c;
+        c.client = it->first;
+        c.name = it->second->name;
+        c.priority = it->second->priority.load();
+        c.tasks = it->second->tasks.load();
+        c.slices = it->second->slices.load();
+        c.steals = it->second->steals.load();
+        c.waits = it->second->waits.load();
+        c.busyUs = it->second->busyUs.load();
+        c.units = it->second->units.load();
+        c.elapsedUs = t - it->second->addedAt;
+        stats.clients.push_back(c);
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        任务放入指定工作线程的队尾，并唤醒一个空闲线程
+* @Param:        @index int 工作线程下标
+*                @task Task* 任务
+* @Return:       void
+**/
+void DecoderPool::push(int index, Task* task) {
+    {
+        std::lock_guard<std::mutex> lock(this->workers[index]->mutex);
+        this->workers[index]->queue.push_back(task);
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);//与空闲线程的等待互斥，避免唤醒丢失
+        this->queued++;
+    }
+    this->cv.notify_one();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        取一个任务：先取自己队列的队头，为空时从其他队列的队尾窃取
+* @Param:        @index int 工作线程下标
+*                @stolen bool& 输出是否为窃取的任务
+* @Return:       Task* 没有任务返回nullptr
+**/
+DecoderPool::Task* DecoderPool::take(int index, bool& stolen) {
+    Task* task = nullptr;
+    size_t count = this->workers.size();
+    stolen = false;
+    {
+        std::lock_guard<std::mutex> lock(this->workers[index]->mutex);
+        if (!this->workers[index]->queue.empty()) {
+            task = this->workers[index]->queue.front();
+            this->workers[index]->queue.pop_front();
+        }
+    }
+    for (size_t i = 1; !task && i < count; i++) {
+        Worker* victim = this->workers[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->queue.empty()) {
+            task = victim->queue.back();
+            victim->queue.pop_back();
+            stolen = true;
+        }
+    }
+    if (task) this->queued--;
+    return task;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        工作线程，按优先级给每个任务一个时间片，执行后根据返回值放回队尾、延后调度或结束
+* @Param:        @index int 工作线程下标
+* @Return:       void
+**/
+void DecoderPool::workerThread(int index) {
+    Task* task = nullptr;
+    bool stolen = false;
+    int ret = DECODERPOOL_TASK_AGAIN;
+    uint64_t units = 0;
+    int64_t start = 0;
+    int64_t t = 0;
+    std::vector<Task*> due;
+
+    while (!this->threadShouldEnd.load()) {
+        {//到时间的等待任务放回自己的队列，所有线程都忙时也不会一直得不到调度
+            std::lock_guard<std::mutex> lock(this->mutex);
+            t = now();
+            while (!this->waiting.empty() && this->waiting.begin()->first <= t) {
+                due.push_back(this->waiting.begin()->second);
+                this->waiting.erase(this->waiting.begin());
+            }
+        }
+        for (size_t i = 0; i < due.size(); i++) {
+            this->push(index, due[i]);
+        }
+        due.clear();
+
+        task = this->take(index, stolen);
+        if (!task) {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            if (this->threadShouldEnd.load()) break;
+            t = now();
+            if (this->queued.load() > 0 || (!this->waiting.empty() && this->waiting.begin()->first <= t)) continue;
+            if (this->waiting.empty()) {//没有任何任务，等待提交
+                this->cv.wait(lock, [this] {return this->threadShouldEnd || this->queued.load() > 0; });
+            }
+            else {//等待最早的等待任务到时间
+                this->cv.wait_for(lock, std::chrono::microseconds(this->waiting.begin()->first - t),
+                    [this] {return this->threadShouldEnd || this->queued.load() > 0; });
+            }
+            continue;
+        }
+
+        if (stolen) {
+            task->client->steals++;
+            this->totalSteals++;
+        }
+        units = 0;
+        start = now();
+        ret = task->step((int64_t)DECODERPOOL_SLICE_US * task->client->priority.load(), units);
+        t = now();
+        task->client->slices++;
+        task->client->busyUs += t - start;
+        task->client->units += units;
+        this->totalSlices++;
+
+        if (ret == DECODERPOOL_TASK_AGAIN) {
+            this->push(index, task);
+        }
+        else if (ret == DECODERPOOL_TASK_WAIT) {
+            task->client->waits++;
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->waiting.insert(std::pair<int64_t, Task*>(t + DECODERPOOL_WAIT_US, task));
+            }
+            this->cv.notify_one();//等待时间可能早于正在休眠的线程的唤醒时刻
+        }
+        else {
+            task->client->tasks--;
+            delete task;
+        }
+    }
+}
@@ -0,0 +1,186 @@
+#ifndef _DECODERPOOL_H_
+#define _DECODERPOOL_H_
+
+/**
+* @File name:    DecoderPool.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  进程共享的解码调度器（多画面监控墙等大量播放器同时运行时使用），
+*                固定数量的工作线程以时间片方式运行所有播放器的解封装/解码任务，空闲线程从其他线程窃取任务
+**/
+
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include <cstdint>
+
+
+//任务单步执行的返回值
+#define DECODERPOOL_TASK_AGAIN      (0)//还有工作，放回队列尾部等待下一次调度
+#define DECODERPOOL_TASK_WAIT       (1)//暂时无事可做（队列满、等待其他线程），DECODERPOOL_WAIT_US后再调度
+#define DECODERPOOL_TASK_DONE       (2)//任务结束，移出调度器
+
+//优先级即权重，每次调度的时间片与优先级成正比
+#define DECODERPOOL_PRIORITY_LOW    (1)
+#define DECODERPOOL_PRIORITY_NORMAL (2)
+#define DECODERPOOL_PRIORITY_HIGH   (4)
+#define DECODERPOOL_PRIORITY_MAX    (16)
+
+#define DECODERPOOL_SLICE_US        (2000)//优先级为1时的时间片（us）
+#define DECODERPOOL_WAIT_US         (5000)//返回DECODERPOOL_TASK_WAIT的任务再次调度的间隔（us）
+#define DECODERPOOL_BUDGET_CANCEL   (0)//stop时以该时间片调用尚未结束的任务，任务需要放弃工作、释放资源并返回DECODERPOOL_TASK_DONE
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  单个调用者（一个播放器实例）的统计，units为任务报告的工作量（解封装的packet数+解码的帧数），
+    *                busyUs为任务在工作线程中运行的总时间
+    **/
+    class DecoderPoolClientStats {
+    public:
+        DecoderPoolClientStats();
+        double unitsPerSecond() const;
+        double busyRatio() const;
+        int client;
+        std::string name;
+        int priority;
+        int tasks;//尚未结束的任务数
+        uint64_t slices;
+        uint64_t steals;
+        uint64_t waits;
+        uint64_t busyUs;
+        uint64_t units;
+        int64_t elapsedUs;//加入调度器至今
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  调度器统计
+    **/
+    class DecoderPoolStats {
+    public:
+        DecoderPoolStats();
+        std::string toString() const;
+        int threads;
+        uint64_t slices;
+        uint64_t steals;
+        std::vector<DecoderPoolClientStats> clients;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  任务单步函数，在budgetUs内执行尽量多的工作后返回DECODERPOOL_TASK_xxx，
+    *                并把完成的工作量累加到units。同一个任务不会被两个工作线程同时执行。
+    *                budgetUs为DECODERPOOL_BUDGET_CANCEL时调度器正在停止，任务需要走结束流程并返回DECODERPOOL_TASK_DONE
+    **/
+    typedef std::function<int(int64_t budgetUs, uint64_t& units)> DecoderPoolStep;
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  工作窃取的解码调度器，线程安全。每个工作线程有自己的任务队列，从队头取任务，
+    *                执行一个时间片后放回队尾（轮转保证公平），自己的队列为空时从其他队列的队尾窃取。
+    *                调用者（播放器）通过addClient注册并设置优先级。stop时尚未结束的任务在调用stop的线程中
+    *                以DECODERPOOL_BUDGET_CANCEL被调用直到返回DECODERPOOL_TASK_DONE，等待任务结束的调用者不会一直阻塞
+    **/
+    class DecoderPool {
+    public:
+        static DecoderPool& global();
+
+        DecoderPool();
+        ~DecoderPool();
+
+        bool start(int threadCount = 0);
+        void stop();
+        bool isRunning();
+        int getThreadCount();
+        int addClient(const std::string& name, int priority = DECODERPOOL_PRIORITY_NORMAL);
+        void removeClient(int client);
+        void setPriority(int client, int priority);
+        bool submit(int client, DecoderPoolStep step);
+        void getStats(DecoderPoolStats& stats);
+
+    private:
+
+        struct Client {
+            int id;
+            std::string name;
+            std::atomic<int> priority;
+            std::atomic<int> tasks;
+            std::atomic<uint64_t> slices;
+            std::atomic<uint64_t> steals;
+            std::atomic<uint64_t> waits;
+            std::atomic<uint64_t> busyUs;
+            std::atomic<uint64_t> units;
+            int64_t addedAt;
+        };
+
+        struct Task {
+            std::shared_ptr<Client> client;
+            DecoderPoolStep step;
+        };
+
+        struct Worker {
+            std::deque<Task*> queue;
+            std::mutex mutex;
+        };
+
+        static int64_t now();
+        void workerThread(int index);
+        Task* take(int index, bool& stolen);
+        void push(int index, Task* task);
+
+        //工作线程和各自的任务队列
+        std::vector<Worker*> workers;
+        std::vector<std::thread*> threads;
+        std::atomic<bool> running;
+        std::atomic<bool> threadShouldEnd;
+
+        //所有队列中的任务数，空闲线程据此判断是否需要等待
+        std::atomic<int> queued;
+
+        //下一次提交任务使用的队列（轮流分配）
+        std::atomic<unsigned int> nextWorker;
+
+        //返回DECODERPOOL_TASK_WAIT的任务，按再次调度的时刻排序，由mutex保护
+        std::multimap<int64_t, Task*> waiting;
+
+        //已注册的调用者，由mutex保护
+        std::map<int, std::shared_ptr<Client>> clients;
+        int nextClient;
+
+        std::atomic<uint64_t> totalSlices;
+        std::atomic<uint64_t> totalSteals;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+
+};
+
+
+#endif//_DECODERPOOL_H_
@@ -0,0 +1,326 @@
+#include "FrameCache.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  FrameCache.h的实现
+**/
+
+#include <cstring>
+
+extern "C"{
+#include "libswscale/swscale.h"
+#include "libavutil/pixfmt.h"
+}
+
+using namespace MediaUse;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+FrameCacheStats::FrameCacheStats() :hits(0), misses(0), seeks(0), seeksFromCache(0), bytes(0), budget(0), frames(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        帧命中率：从缓存取出的帧 / (取出的帧 + 未命中的查询)
+* @Param:        void
+* @Return:       double [0,1]
+**/
+double FrameCacheStats::hitRate() const {
+    if (this->hits + this->misses == 0) return 0.0;
+    return (double)this->hits / (this->hits + this->misses);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        跳转命中率：由缓存直接供帧的跳转 / 全部跳转
+* @Param:        void
+* @Return:       double [0,1]
+**/
+double FrameCacheStats::seekHitRate() const {
+    if (this->seeks == 0) return 0.0;
+    return (double)this->seeksFromCache / this->seeks;
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数，预算为0即不缓存
+* @Param:        void
+* @Return:       void
+**/
+FrameCache::FrameCache() :budget(0), bytes(0), downscale(1), width(0), height(0),
+    downContext(nullptr), upContext(nullptr), hits(0), misses(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，释放全部缓存
+* @Param:        void
+* @Return:       void
+**/
+FrameCache::~FrameCache() {
+    this->clear();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置预算和帧格式，会清空已有缓存和统计
+* @Param:        @budget size_t 内存预算（字节），0表示不缓存
+*                @downscale int 视频帧缩小倍数（宽高各除以该值），1表示原尺寸
+*                @width int 视频帧宽，音频缓存为0
+*                @height int 视频帧高，音频缓存为0
+* @Return:       void
+**/
+void FrameCache::configure(size_t budget, int downscale, int width, int height) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->clearLocked();
+    this->budget = budget;
+    this->downscale = downscale > 1 ? downscale : 1;
+    this->width = width;
+    this->height = height;
+    if (this->width / this->downscale < 2 || this->height / this->downscale < 2) this->downscale = 1;
+    this->hits = 0;
+    this->misses = 0;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否启用缓存
+* @Param:        void
+* @Return:       bool
+**/
+bool FrameCache::enabled() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->budget > 0;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        插入一帧，转移info.data的所有权（之后info.data为null），pts已存在时只更新LRU，
+*                没有启用缓存时直接释放数据
+* @Param:        @info (AVDataInfo&) 帧数据
+* @Return:       void
+**/
+void FrameCache::insert(AVDataInfo& info) {
+    Entry entry;
+    int64_t pts = info.pts;
+    uint8_t* src[4] = { nullptr };
+    uint8_t* dst[4] = { nullptr };
+    int srcLines[4] = { 0 };
+    int dstLines[4] = { 0 };
+    int w = 0;
+    int h = 0;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->frames.find(pts);
+    if (this->budget == 0 || !info.data || it != this->frames.end()) {
+        if (it != this->frames.end()) {
+            this->lru.splice(this->lru.begin(), this->lru, it->second.lruIt);
+        }
+        info.clear();
+        return;
+    }
+    entry.size = info.size;
+    if (this->width > 0 && this->downscale > 1) {//缩小存储
+        w = this->width / this->downscale;
+        h = this->height / this->downscale;
+        this->downContext = sws_getCachedContext(this->downContext, this->width, this->height, AV_PIX_FMT_RGB24,
+            w, h, AV_PIX_FMT_RGB24, SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+        if (!this->downContext) {
+            info.clear();
+            return;
+        }
+        entry.bytes = (size_t)w * h * 3;
+        entry.data = new unsigned char[entry.bytes];
+        src[0] = info.data;
+        srcLines[0] = this->width * 3;
+        dst[0] = entry.data;
+        dstLines[0] = w * 3;
+        sws_scale(this->downContext, src, srcLines, 0, this->height, dst, dstLines);
+        info.clear();
+    }
+    else {
+        entry.bytes = this->width > 0 ? (size_t)this->width * this->height * 3 : info.size;
+        entry.data = info.data;
+        info.data = nullptr;
+        info.clear();
+    }
+    this->lru.push_front(pts);
+    entry.lruIt = this->lru.begin();
+    this->frames[pts] = entry;
+    this->bytes += entry.bytes;
+    this->evict();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        取出[from, until)内pts最小的一帧的拷贝（缩小存储的帧会放大回原尺寸），取出的数据由调用者释放
+* @Param:        @from int64_t 起始pts（包含）
+*                @until int64_t 结束pts（不包含）
+*                @info (AVDataInfo&) 输出帧数据
+* @Return:       bool 取到返回true
+**/
+bool FrameCache::get(int64_t from, int64_t until, AVDataInfo& info) {
+    uint8_t* src[4] = { nullptr };
+    uint8_t* dst[4] = { nullptr };
+    int srcLines[4] = { 0 };
+    int dstLines[4] = { 0 };
+    size_t outBytes = 0;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->frames.lower_bound(from);
+    if (it == this->frames.end() || it->first >= until) return false;
+    this->lru.splice(this->lru.begin(), this->lru, it->second.lruIt);
+    if (this->width > 0 && this->downscale > 1) {
+        this->upContext = sws_getCachedContext(this->upContext, this->width / this->downscale, this->height / this->downscale, AV_PIX_FMT_RGB24,
+            this->width, this->height, AV_PIX_FMT_RGB24, SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+        if (!this->upContext) return false;
+        outBytes = (size_t)this->width * this->height * 3;
+        info.data = new unsigned char[outBytes];
+        src[0] = it->second.data;
+        srcLines[0] = (this->width / this->downscale) * 3;
+        dst[0] = info.data;
+        dstLines[0] = this->width * 3;
+        sws_scale(this->upContext, src, srcLines, 0, this->height / this->downscale, dst, dstLines);
+    }
+    else {
+        info.data = new unsigned char[it->second.bytes];
+        std::memcpy(info.data, it->second.data, it->second.bytes);
+    }
+    info.pts = it->first;
+    info.size = it->second.size;
+    this->hits++;
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        查询从pts开始连续缓存的区间：起点为pts之前（含）最近的一帧且距离不超过maxGap，
+*                之后相邻两帧间隔不超过maxGap视为连续
+* @Param:        @pts int64_t 跳转目标
+*                @maxGap int64_t 视为连续的最大帧间隔
+*                @start (int64_t&) 输出区间起点（第一帧pts）
+* @Return:       int64_t 区间最后一帧的pts，未命中返回-1
+**/
+int64_t FrameCache::coverage(int64_t pts, int64_t maxGap, int64_t& start) {
+    int64_t last = 0;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->frames.upper_bound(pts);
+    if (it == this->frames.begin()) {
+        this->misses++;
+        return -1;
+    }
+    --it;
+    if (pts - it->first > maxGap) {
+        this->misses++;
+        return -1;
+    }
+    start = it->first;
+    last = it->first;
+    for (++it; it != this->frames.end() && it->first - last <= maxGap; ++it) {
+        last = it->first;
+    }
+    return last;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        清空缓存（保留预算和格式设置）
+* @Param:        void
+* @Return:       void
+**/
+void FrameCache::clear() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->clearLocked();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取统计
+* @Param:        @stats (FrameCacheStats&) 输出
+* @Return:       void
+**/
+void FrameCache::getStats(FrameCacheStats& stats) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    stats.hits += this->hits;
+    stats.misses += this->misses;
+    stats.bytes += this->bytes;
+    stats.budget += this->budget;
+    stats.frames += this->frames.size();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        超出预算时淘汰最久未使用的帧，需要持有mutex
+* @Param:        void
+* @Return:       void
+**/
+void FrameCache::evict() {
+    while (this->bytes > this->budget && !this->lru.empty()) {
+        auto it = this->frames.find(this->lru.back());
+        this->bytes -= it->second.bytes;
+        delete[] it->second.data;
+        this->frames.erase(it);
+        this->lru.pop_back();
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        释放全部缓存帧和缩放上下文，需要持有mutex
+* @Param:        void
+* @Return:       void
+**/
+void FrameCache::clearLocked() {
+    for (auto& i : this->frames) {
+        delete[] i.second.data;
+    }
+    this->frames.clear();
+    this->lru.clear();
+    this->bytes = 0;
+    if (this->downContext) {
+        sws_freeContext(this->downContext);
+        this->downContext = nullptr;
+    }
+    if (this->upContext) {
+        sws_freeContext(this->upContext);
+        this->upContext = nullptr;
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef _FRAMECACHE_H_
+#define _FRAMECACHE_H_
+
+/**
+* @File name:    FrameCache.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  供CppPlayer使用的已解码帧缓存（按pts索引，内存预算LRU淘汰，视频帧可选缩小存储）
+**/
+
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include "MediaUse.h"
+
+struct SwsContext;
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  帧缓存统计，hits为从缓存取出的帧数，misses为未命中的覆盖查询次数，
+    *                seeks/seeksFromCache由CppPlayer填写（跳转总数/由缓存直接供帧的跳转数）
+    **/
+    class FrameCacheStats {
+    public:
+        FrameCacheStats();
+        double hitRate() const;
+        double seekHitRate() const;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t seeks;
+        uint64_t seeksFromCache;
+        size_t bytes;//当前占用
+        size_t budget;//内存预算
+        size_t frames;//当前缓存的帧数
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  已解码帧缓存，线程安全。视频帧为RGB24（需要configure指定宽高），
+    *                音频帧为PCM（按AVDataInfo::size计算大小）。insert转移数据所有权，get返回拷贝
+    **/
+    class FrameCache {
+    public:
+        FrameCache();
+        ~FrameCache();
+
+        void configure(size_t budget, int downscale = 1, int width = 0, int height = 0);
+        bool enabled();
+        void insert(AVDataInfo& info);
+        bool get(int64_t from, int64_t until, AVDataInfo& info);
+        int64_t coverage(int64_t pts, int64_t maxGap, int64_t& start);
+        void clear();
+        void getStats(FrameCacheStats& stats);
+
+    private:
+
+        struct Entry {
+            unsigned char* data;//缓存数据（可能已缩小）
+            size_t size;//原AVDataInfo::size
+            size_t bytes;//data实际大小
+            std::list<int64_t>::iterator lruIt;
+        };
+
+        void evict();
+        void clearLocked();
+
+        std::map<int64_t, Entry> frames;//按pts排序，便于查找连续区间
+        std::list<int64_t> lru;//表头为最近使用
+
+        size_t budget;//内存预算，0表示不缓存
+        size_t bytes;//当前占用
+        int downscale;//缩小倍数，1表示原尺寸
+        int width;//视频帧宽，0表示不是视频帧
+        int height;//视频帧高
+        SwsContext* downContext;//缩小
+        SwsContext* upContext;//放大回原尺寸
+
+        uint64_t hits;
+        uint64_t misses;
+        std::mutex mutex;
+    };
+
+
+};
+
+
+#endif//_FRAMECACHE_H_
@@ -0,0 +1,323 @@
+#include "FrameConverter.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  FrameConverter.h的实现
+**/
+
+extern "C"{
+#include "libavcodec/avcodec.h"
+#include "libswscale/swscale.h"
+#include "libswresample/swresample.h"
+#include "libavutil/channel_layout.h"
+#include "libavutil/samplefmt.h"
+}
+
+#include <cstring>
+
+using namespace MediaUse;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+VideoFrameConverter::VideoFrameConverter() :context(nullptr), fast(false), downscale(1) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构函数
+* @Param:        void
+* @Return:       void
+**/
+VideoFrameConverter::~VideoFrameConverter() {
+    this->release();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        把一帧转换为width*height的RGB24，成功时info持有新分配的数据（size为1，与渲染队列一致）
+* @Param:        @frame AVFrame* 解码得到的帧
+* @Param:        @width int 输出宽
+* @Param:        @height int 输出高
+* @Param:        @pts int64_t 写入info的pts（us）
+* @Param:        @info AVDataInfo& 输出
+* @Return:       int FRAMECONVERTER_OK 或 FRAMECONVERTER_ERROR_xxx
+**/
+int VideoFrameConverter::convert(AVFrame* frame, int width, int height, int64_t pts, AVDataInfo& info) {
+    unsigned char* rgb = nullptr;
+    unsigned char* data[8] = { nullptr };
+    int lines[8] = { 0 };
+    int ret = 0;
+    int scaledWidth = width;
+    int scaledHeight = height;
+
+    if (this->downscale > 1 && width / this->downscale >= 2 && height / this->downscale >= 2) {
+        scaledWidth = width / this->downscale;
+        scaledHeight = height / this->downscale;
+    }
+    //sws_getCachedContext在参数不变时直接返回原上下文
+    this->context = sws_getCachedContext(this->context,
+        frame->width, frame->height, (AVPixelFormat)frame->format,
+        scaledWidth, scaledHeight, AV_PIX_FMT_RGB24,
+        this->fast ? SWS_FAST_BILINEAR : SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!this->context) {
+        return FRAMECONVERTER_ERROR_CONTEXT;
+    }
+    rgb = new unsigned char[width * height * 4];
+    if (!rgb) {
+        return FRAMECONVERTER_ERROR_ALLOC;
+    }
+    if (scaledWidth != width) {
+        this->scaledBuffer.resize((size_t)scaledWidth * scaledHeight * 3);
+        data[0] = this->scaledBuffer.data();
+    }
+    else {
+        data[0] = rgb;
+    }
+    lines[0] = scaledWidth * 3;
+    ret = sws_scale(this->context, frame->data, frame->linesize, 0, frame->height, data, lines);//图像格式转换
+    if (ret <= 0) {
+        delete[] rgb;
+        return FRAMECONVERTER_ERROR_CONVERT;
+    }
+    if (scaledWidth != width) {
+        this->upscale(this->scaledBuffer.data(), scaledWidth, scaledHeight, rgb, width, height);
+    }
+    info = AVDataInfo(rgb, pts, 1);
+    return FRAMECONVERTER_OK;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置转换质量，下一次convert生效（输出尺寸不变）
+* @Param:        @fast bool 使用SWS_FAST_BILINEAR
+* @Param:        @downscale int 大于1时先转换为1/downscale大小，再按最近邻放大到输出尺寸
+* @Return:       void
+**/
+void VideoFrameConverter::setQuality(bool fast, int downscale) {
+    this->fast = fast;
+    this->downscale = downscale < 1 ? 1 : downscale;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        RGB24最近邻放大：每个源行展开一次，再整行复制到对应的输出行
+* @Param:        @src (const unsigned char*) srcWidth*srcHeight的RGB24
+* @Param:        @dst unsigned char* width*height的RGB24
+* @Return:       void
+**/
+void VideoFrameConverter::upscale(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int width, int height) {
+    int lastRow = -1;
+    unsigned char* lastLine = nullptr;
+    for (int y = 0; y < height; y++) {
+        int row = (int)((int64_t)y * srcHeight / height);
+        unsigned char* line = dst + (size_t)y * width * 3;
+        if (row == lastRow) {
+            memcpy(line, lastLine, (size_t)width * 3);
+            continue;
+        }
+        const unsigned char* s = src + (size_t)row * srcWidth * 3;
+        for (int x = 0; x < width; x++) {
+            const unsigned char* p = s + (int)((int64_t)x * srcWidth / width) * 3;
+            line[x * 3] = p[0];
+            line[x * 3 + 1] = p[1];
+            line[x * 3 + 2] = p[2];
+        }
+        lastRow = row;
+        lastLine = line;
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        释放转换上下文
+* @Param:        void
+* @Return:       void
+**/
+void VideoFrameConverter::release() {
+    if (this->context) {
+        sws_freeContext(this->context);
+        this->context = nullptr;
+    }
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+AudioFrameConverter::AudioFrameConverter() :context(nullptr), inSampleRate(0), outSampleRate(0), compensation(0.0), compensating(false) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构函数
+* @Param:        void
+* @Return:       void
+**/
+AudioFrameConverter::~AudioFrameConverter() {
+    this->release();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        按解码器的声道布局、采样格式、采样率创建重采样上下文
+* @Param:        @codecContext AVCodecContext* 已打开的音频解码器
+* @Param:        @outSampleRate int 输出采样率，不大于0时与解码器相同
+* @Return:       int 0成功，否则为FFmpeg错误码
+**/
+int AudioFrameConverter::open(AVCodecContext* codecContext, int outSampleRate) {
+    AVChannelLayout channelLayout = AV_CHANNEL_LAYOUT_STEREO;
+    int ret = 0;
+    this->release();
+    ret = swr_alloc_set_opts2(&this->context,
+        &channelLayout,
+        AV_SAMPLE_FMT_S16,
+        outSampleRate > 0 ? outSampleRate : codecContext->sample_rate,
+        &codecContext->ch_layout,
+        codecContext->sample_fmt,
+        codecContext->sample_rate,
+        0, nullptr);
+    if (ret == 0) {
+        ret = swr_init(this->context);
+    }
+    if (ret != 0) {
+        this->release();
+        return ret;
+    }
+    this->inSampleRate = codecContext->sample_rate;
+    this->outSampleRate = outSampleRate > 0 ? outSampleRate : codecContext->sample_rate;
+    this->compensating = false;
+    return ret;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置采样补偿（swr_set_compensation），之后每帧输出的采样数减少ratio，用于直播追赶延迟。
+*                补偿是在帧内均匀地重采样，播放速度和音调都升高约ratio（0.05约为0.8个半音），不会有丢帧的跳变
+* @Param:        @ratio double 少输出的比例，0表示恢复正常，在下一次convert生效
+* @Return:       void
+**/
+void AudioFrameConverter::setCompensation(double ratio) {
+    this->compensation = ratio > 0 ? ratio : 0.0;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        把一帧转换为S16立体声PCM，成功时info持有新分配的数据，size为字节数
+* @Param:        @frame AVFrame* 解码得到的帧
+* @Param:        @pts int64_t 写入info的pts（us）
+* @Param:        @info AVDataInfo& 输出
+* @Return:       int FRAMECONVERTER_OK 或 FRAMECONVERTER_ERROR_xxx
+**/
+int AudioFrameConverter::convert(AVFrame* frame, int64_t pts, AVDataInfo& info) {
+    unsigned char* pcm = nullptr;
+    int ret = 0;
+    int outSamples = 0;
+    if (!this->context) {
+        return FRAMECONVERTER_ERROR_CONTEXT;
+    }
+    if (this->compensation > 0 && this->inSampleRate > 0) {//在这一帧对应的输出采样内少输出compensation比例的采样
+        outSamples = (int)av_rescale(frame->nb_samples, this->outSampleRate, this->inSampleRate);
+        if (outSamples > 0 && swr_set_compensation(this->context, -(int)(outSamples * this->compensation), outSamples) == 0) {
+            this->compensating = true;
+        }
+    }
+    else if (this->compensating) {
+        swr_set_compensation(this->context, 0, 0);
+        this->compensating = false;
+    }
+    outSamples = swr_get_out_samples(this->context, frame->nb_samples);//重采样时输出采样数与输入不同
+    if (outSamples < frame->nb_samples) outSamples = frame->nb_samples;
+    pcm = new unsigned char[outSamples * 2 * 3];
+    if (!pcm) {
+        return FRAMECONVERTER_ERROR_ALLOC;
+    }
+    ret = swr_convert(this->context, &pcm, outSamples, (const uint8_t**)frame->data, frame->nb_samples);
+    if (ret <= 0) {
+        delete[] pcm;
+        return FRAMECONVERTER_ERROR_CONVERT;
+    }
+    info = AVDataInfo(pcm, pts, av_samples_get_buffer_size(nullptr, 2, ret, AV_SAMPLE_FMT_S16, 1));
+    return FRAMECONVERTER_OK;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        裁掉convert输出（S16立体声）中pts之前的采样，使数据从pts开始，用于跳转后精确到采样的起点
+* @Param:        @info AVDataInfo& convert的输出，原地修改data/size/pts
+* @Param:        @pts int64_t 新的起点（us），不在info范围内时不修改
+* @Param:        @sampleRate int 采样率
+* @Return:       void
+**/
+void AudioFrameConverter::trimFront(AVDataInfo& info, int64_t pts, int sampleRate) {
+    size_t bytes = 0;
+    if (!info.data || pts <= info.pts || sampleRate <= 0) return;
+    bytes = (size_t)av_rescale(pts - info.pts, sampleRate, AV_TIME_BASE) * 4;
+    if (bytes == 0 || bytes >= info.size) return;
+    memmove(info.data, info.data + bytes, info.size - bytes);
+    info.size -= bytes;
+    info.pts = pts;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否已成功open
+* @Param:        void
+* @Return:       bool
+**/
+bool AudioFrameConverter::isOpen() {
+    return this->context != nullptr;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        释放重采样上下文
+* @Param:        void
+* @Return:       void
+**/
+void AudioFrameConverter::release() {
+    if (this->context) {
+        swr_free(&this->context);
+    }
+}
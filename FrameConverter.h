@@ -0,0 +1,92 @@
+#ifndef _FRAMECONVERTER_H_
+#define _FRAMECONVERTER_H_
+
+/**
+* @File name:    FrameConverter.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  解码帧到输出格式的转换（视频RGB24、音频S16立体声），不依赖Qt，
+*                CppPlayer和基准测试程序共用
+**/
+
+
+#include <cstdint>
+#include <vector>
+#include "MediaUse.h"
+
+struct SwsContext;
+struct SwrContext;
+struct AVFrame;
+struct AVCodecContext;
+
+
+#define FRAMECONVERTER_OK               (0)
+#define FRAMECONVERTER_ERROR_CONTEXT    (-1)//转换上下文创建失败
+#define FRAMECONVERTER_ERROR_ALLOC      (-2)//输出缓冲分配失败
+#define FRAMECONVERTER_ERROR_CONVERT    (-3)//sws_scale/swr_convert失败
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  视频帧转换为指定大小的RGB24，输入尺寸/格式变化时自动重建上下文，非线程安全。
+    *                setQuality可改用SWS_FAST_BILINEAR，或先转换为1/downscale大小再按最近邻放大（输出尺寸不变）
+    **/
+    class VideoFrameConverter {
+    public:
+        VideoFrameConverter();
+        ~VideoFrameConverter();
+        int convert(AVFrame* frame, int width, int height, int64_t pts, AVDataInfo& info);
+        void setQuality(bool fast, int downscale);
+        void release();
+    private:
+        VideoFrameConverter(const VideoFrameConverter&) = delete;
+        VideoFrameConverter& operator=(const VideoFrameConverter&) = delete;
+
+        void upscale(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int width, int height);
+
+        SwsContext* context;
+        bool fast;
+        int downscale;
+        std::vector<unsigned char> scaledBuffer;//缩小转换的中间缓冲
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  音频帧转换为S16立体声（默认采样率不变，也可指定输出采样率，如切换音轨后保持输出不变），open后使用，非线程安全
+    **/
+    class AudioFrameConverter {
+    public:
+        AudioFrameConverter();
+        ~AudioFrameConverter();
+        int open(AVCodecContext* codecContext, int outSampleRate = 0);
+        int convert(AVFrame* frame, int64_t pts, AVDataInfo& info);
+        void setCompensation(double ratio);
+        static void trimFront(AVDataInfo& info, int64_t pts, int sampleRate);
+        bool isOpen();
+        void release();
+    private:
+        AudioFrameConverter(const AudioFrameConverter&) = delete;
+        AudioFrameConverter& operator=(const AudioFrameConverter&) = delete;
+
+        SwrContext* context;
+        int inSampleRate;
+        int outSampleRate;
+        double compensation;//每帧少输出的采样比例，0表示不补偿
+        bool compensating;//重采样上下文中是否设置了补偿
+    };
+
+
+};
+
+
+#endif//_FRAMECONVERTER_H_
@@ -0,0 +1,955 @@
+#include "MediaIO.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  MediaIO.h的实现
+**/
+
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+extern "C"{
+#include "libavformat/avio.h"
+#include "libavutil/mem.h"
+#include "libavutil/error.h"
+}
+
+using namespace MediaUse;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数，统计值全部为0
+* @Param:        void
+* @Return:       void
+**/
+AVIOStats::AVIOStats() :bytesRead(0), bytesDelivered(0), syscalls(0), cacheHits(0), cacheMisses(0), prefetched(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        块缓存命中率，没有访问时返回0
+* @Param:        void
+* @Return:       double [0,1]
+**/
+double AVIOStats::hitRate() const {
+    uint64_t total = this->cacheHits + this->cacheMisses;
+    if (total == 0) return 0.0;
+    return (double)this->cacheHits / total;
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+AVIOSource::AVIOSource() :fileSize(-1), syscalls(0), bytesRead(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数
+* @Param:        void
+* @Return:       void
+**/
+AVIOSource::~AVIOSource() {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回文件大小，未打开时返回-1
+* @Param:        void
+* @Return:       int64_t
+**/
+int64_t AVIOSource::size() {
+    return this->fileSize;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回读取产生的系统调用次数
+* @Param:        void
+* @Return:       uint64_t
+**/
+uint64_t AVIOSource::getSyscalls() {
+    return this->syscalls.load();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回实际读取的字节数
+* @Param:        void
+* @Return:       uint64_t
+**/
+uint64_t AVIOSource::getBytesRead() {
+    return this->bytesRead.load();
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+#ifdef _WIN32
+FileSource::FileSource() :handle(INVALID_HANDLE_VALUE) {
+#else
+FileSource::FileSource() :fd(-1) {
+#endif
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，关闭文件
+* @Param:        void
+* @Return:       void
+**/
+FileSource::~FileSource() {
+    this->close();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开本地文件并获取文件大小
+* @Param:        @path (const std::string&) 文件路径
+* @Return:       bool 成功返回true
+**/
+bool FileSource::open(const std::string& path) {
+    this->close();
+#ifdef _WIN32
+    LARGE_INTEGER li;
+    this->handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (this->handle == INVALID_HANDLE_VALUE) return false;
+    if (!GetFileSizeEx(this->handle, &li)) {
+        this->close();
+        return false;
+    }
+    this->fileSize = li.QuadPart;
+#else
+    struct stat st;
+    this->fd = ::open(path.c_str(), O_RDONLY);
+    if (this->fd < 0) return false;
+    if (fstat(this->fd, &st) != 0) {
+        this->close();
+        return false;
+    }
+    this->fileSize = st.st_size;
+#endif
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        关闭文件
+* @Param:        void
+* @Return:       void
+**/
+void FileSource::close() {
+#ifdef _WIN32
+    if (this->handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(this->handle);
+        this->handle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (this->fd >= 0) {
+        ::close(this->fd);
+        this->fd = -1;
+    }
+#endif
+    this->fileSize = -1;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        从指定偏移读取数据，不改变文件指针，可多线程同时调用
+* @Param:        @offset int64_t 文件偏移
+*                @buf (unsigned char *) 输出缓冲
+*                @size int 最大读取字节数
+* @Return:       int 读取的字节数，0表示文件结束，<0表示错误
+**/
+int FileSource::read(int64_t offset, unsigned char* buf, int size) {
+    int ret = -1;
+#ifdef _WIN32
+    DWORD got = 0;
+    OVERLAPPED ov;
+    std::memset(&ov, 0, sizeof(ov));
+    ov.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    ov.OffsetHigh = (DWORD)(offset >> 32);
+    if (ReadFile(this->handle, buf, size, &got, &ov)) {
+        ret = (int)got;
+    }
+    else if (GetLastError() == ERROR_HANDLE_EOF) {
+        ret = 0;
+    }
+#else
+    ret = (int)pread(this->fd, buf, size, offset);
+#endif
+    this->syscalls++;
+    if (ret > 0) this->bytesRead += ret;
+    return ret;
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+#ifdef _WIN32
+MmapSource::MmapSource() :mapped(nullptr), handle(INVALID_HANDLE_VALUE), mapping(nullptr) {
+#else
+MmapSource::MmapSource() :mapped(nullptr), fd(-1) {
+#endif
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，解除映射
+* @Param:        void
+* @Return:       void
+**/
+MmapSource::~MmapSource() {
+    this->close();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开本地文件并整体映射到内存，映射本身算作一次系统调用
+* @Param:        @path (const std::string&) 文件路径
+* @Return:       bool 成功返回true
+**/
+bool MmapSource::open(const std::string& path) {
+    this->close();
+#ifdef _WIN32
+    LARGE_INTEGER li;
+    this->handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (this->handle == INVALID_HANDLE_VALUE) return false;
+    if (!GetFileSizeEx(this->handle, &li) || li.QuadPart == 0) {
+        this->close();
+        return false;
+    }
+    this->fileSize = li.QuadPart;
+    this->mapping = CreateFileMappingA(this->handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!this->mapping) {
+        this->close();
+        return false;
+    }
+    this->mapped = (unsigned char*)MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!this->mapped) {
+        this->close();
+        return false;
+    }
+#else
+    struct stat st;
+    void* addr = nullptr;
+    this->fd = ::open(path.c_str(), O_RDONLY);
+    if (this->fd < 0) return false;
+    if (fstat(this->fd, &st) != 0 || st.st_size == 0) {
+        this->close();
+        return false;
+    }
+    this->fileSize = st.st_size;
+    addr = mmap(nullptr, this->fileSize, PROT_READ, MAP_PRIVATE, this->fd, 0);
+    if (addr == MAP_FAILED) {
+        this->close();
+        return false;
+    }
+    this->mapped = (unsigned char*)addr;
+    madvise(addr, this->fileSize, MADV_SEQUENTIAL);//媒体文件大多顺序读取，让内核积极预读
+#endif
+    this->syscalls++;
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        解除映射并关闭文件
+* @Param:        void
+* @Return:       void
+**/
+void MmapSource::close() {
+#ifdef _WIN32
+    if (this->mapped) {
+        UnmapViewOfFile(this->mapped);
+        this->mapped = nullptr;
+    }
+    if (this->mapping) {
+        CloseHandle(this->mapping);
+        this->mapping = nullptr;
+    }
+    if (this->handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(this->handle);
+        this->handle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (this->mapped) {
+        munmap(this->mapped, this->fileSize);
+        this->mapped = nullptr;
+    }
+    if (this->fd >= 0) {
+        ::close(this->fd);
+        this->fd = -1;
+    }
+#endif
+    this->fileSize = -1;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        从映射内存拷贝数据
+* @Param:        @offset int64_t 文件偏移
+*                @buf (unsigned char *) 输出缓冲
+*                @size int 最大读取字节数
+* @Return:       int 读取的字节数，0表示文件结束，<0表示错误
+**/
+int MmapSource::read(int64_t offset, unsigned char* buf, int size) {
+    if (!this->mapped || offset < 0) return -1;
+    if (offset >= this->fileSize) return 0;
+    if (offset + size > this->fileSize) {
+        size = (int)(this->fileSize - offset);
+    }
+    std::memcpy(buf, this->mapped + offset, size);
+    this->bytesRead += size;
+    return size;
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        构造函数
+* @Param:        @source (AVIOSource *) 被包装的读取源（不拥有）
+*                @latencyUs int 每次读取的固定延迟，单位us
+*                @bytesPerSecond int64_t 带宽，<=0表示不限速
+* @Return:       void
+**/
+ThrottledSource::ThrottledSource(AVIOSource* source, int latencyUs, int64_t bytesPerSecond)
+    :source(source), latencyUs(latencyUs), bytesPerSecond(bytesPerSecond) {
+    this->fileSize = source ? source->size() : -1;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，不关闭被包装的读取源
+* @Param:        void
+* @Return:       void
+**/
+ThrottledSource::~ThrottledSource() {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开被包装的读取源
+* @Param:        @path (const std::string&) 文件路径
+* @Return:       bool 成功返回true
+**/
+bool ThrottledSource::open(const std::string& path) {
+    if (!this->source || !this->source->open(path)) return false;
+    this->fileSize = this->source->size();
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        关闭被包装的读取源
+* @Param:        void
+* @Return:       void
+**/
+void ThrottledSource::close() {
+    if (this->source) this->source->close();
+    this->fileSize = -1;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        延迟latencyUs + size/bytesPerSecond后从被包装的读取源读取
+* @Param:        @offset int64_t 文件偏移
+*                @buf (unsigned char *) 输出缓冲
+*                @size int 最大读取字节数
+* @Return:       int 读取的字节数
+**/
+int ThrottledSource::read(int64_t offset, unsigned char* buf, int size) {
+    int64_t delay = this->latencyUs;
+    int ret = -1;
+    if (!this->source) return -1;
+    if (this->bytesPerSecond > 0) {
+        delay += (int64_t)size * 1000000 / this->bytesPerSecond;
+    }
+    if (delay > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(delay));
+    }
+    ret = this->source->read(offset, buf, size);//系统调用和字节数由被包装的读取源计数
+    return ret;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回被包装的读取源产生的系统调用次数
+* @Param:        void
+* @Return:       uint64_t
+**/
+uint64_t ThrottledSource::getSyscalls() {
+    return this->source ? this->source->getSyscalls() : 0;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回被包装的读取源实际读取的字节数
+* @Param:        void
+* @Return:       uint64_t
+**/
+uint64_t ThrottledSource::getBytesRead() {
+    return this->source ? this->source->getBytesRead() : 0;
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        构造函数，启动预读线程
+* @Param:        @source (AVIOSource *) 已打开的读取源（不拥有）
+*                @blockSize int 块大小
+*                @blockCount int 缓存块数上限
+*                @prefetchBlocks int 每次读取后预读的块数，0表示不预读
+* @Return:       void
+**/
+AVIOBlockCache::AVIOBlockCache(AVIOSource* source, int blockSize, int blockCount, int prefetchBlocks)
+    :source(source), blockSize(blockSize), blockCount(blockCount), prefetchBlocks(prefetchBlocks),
+    blockTotal(0), prefetchFrom(-1), threadShouldEnd(false), thread(nullptr), hits(0), misses(0), prefetched(0) {
+    if (this->blockSize <= 0) this->blockSize = MEDIAIO_DEFAULT_BLOCK_SIZE;
+    if (this->blockCount < 2) this->blockCount = 2;
+    //预读块不能把正在读取的块挤出缓存
+    if (this->prefetchBlocks > this->blockCount - 1) this->prefetchBlocks = this->blockCount - 1;
+    this->blockTotal = (source->size() + this->blockSize - 1) / this->blockSize;
+    if (this->prefetchBlocks > 0) {
+        this->thread = new std::thread(&AVIOBlockCache::prefetchThread, this);
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，结束预读线程并释放所有块
+* @Param:        void
+* @Return:       void
+**/
+AVIOBlockCache::~AVIOBlockCache() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->threadShouldEnd = true;
+        this->cv.notify_all();
+    }
+    if (this->thread) {
+        this->thread->join();
+        delete this->thread;
+    }
+    for (auto& i : this->lru) {
+        delete[] i.data;
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        从缓存中的块拷贝数据，需要持有mutex
+* @Param:        @index int64_t 块下标
+*                @offset int64_t 文件偏移（位于该块内）
+*                @buf (unsigned char *) 输出缓冲
+*                @size int 最大拷贝字节数
+*                @copied (int&) 实际拷贝的字节数
+* @Return:       bool 块在缓存中返回true
+**/
+bool AVIOBlockCache::copyFromBlock(int64_t index, int64_t offset, unsigned char* buf, int size, int& copied) {
+    auto it = this->blocks.find(index);
+    int inBlock = 0;
+    copied = 0;
+    if (it == this->blocks.end()) return false;
+    this->lru.splice(this->lru.begin(), this->lru, it->second);
+    inBlock = (int)(offset - index * this->blockSize);
+    if (inBlock < it->second->size) {
+        copied = it->second->size - inBlock < size ? it->second->size - inBlock : size;
+        std::memcpy(buf, it->second->data + inBlock, copied);
+    }
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        插入一个块到表头，超出容量时淘汰表尾，需要持有mutex
+* @Param:        @index int64_t 块下标
+*                @data (unsigned char *) 块数据，所有权转移给缓存
+*                @size int 块有效字节数
+* @Return:       void
+**/
+void AVIOBlockCache::insertBlock(int64_t index, unsigned char* data, int size) {
+    Block block;
+    block.index = index;
+    block.size = size;
+    block.data = data;
+    if (this->blocks.count(index)) {
+        delete[] data;
+        return;
+    }
+    this->lru.push_front(block);
+    this->blocks[index] = this->lru.begin();
+    while ((int)this->lru.size() > this->blockCount) {
+        this->blocks.erase(this->lru.back().index);
+        delete[] this->lru.back().data;
+        this->lru.pop_back();
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        从读取源读取一整块，不持有mutex调用
+* @Param:        @index int64_t 块下标
+*                @data (unsigned char *&) 输出新分配的块数据
+* @Return:       int 块有效字节数，<0表示错误
+**/
+int AVIOBlockCache::loadBlock(int64_t index, unsigned char*& data) {
+    int total = 0;
+    int ret = 0;
+    data = new unsigned char[this->blockSize];
+    while (total < this->blockSize) {
+        ret = this->source->read(index * this->blockSize + total, data + total, this->blockSize - total);
+        if (ret <= 0) break;
+        total += ret;
+    }
+    if (total == 0 && ret < 0) {
+        delete[] data;
+        data = nullptr;
+        return ret;
+    }
+    return total;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        读取数据，命中直接拷贝，未命中同步读取整块；每次读取后通知预读线程读取后续块
+* @Param:        @offset int64_t 文件偏移
+*                @buf (unsigned char *) 输出缓冲
+*                @size int 最大读取字节数
+* @Return:       int 读取的字节数，0表示文件结束，<0表示错误
+**/
+int AVIOBlockCache::read(int64_t offset, unsigned char* buf, int size) {
+    int total = 0;
+    int copied = 0;
+    int ret = 0;
+    int64_t index = 0;
+    unsigned char* data = nullptr;
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (total < size) {
+        index = (offset + total) / this->blockSize;
+        if (index >= this->blockTotal) break;
+        if (this->copyFromBlock(index, offset + total, buf + total, size - total, copied)) {
+            this->hits++;
+        }
+        else if (this->loading.count(index)) {//预读线程正在读取该块，等待即可
+            this->loaded_cv.wait(lock, [this, index] {return !this->loading.count(index); });
+            continue;
+        }
+        else {
+            this->misses++;
+            this->loading.insert(index);
+            lock.unlock();
+            ret = this->loadBlock(index, data);
+            lock.lock();
+            this->loading.erase(index);
+            this->loaded_cv.notify_all();
+            if (ret <= 0) {
+                if (total == 0) total = ret;
+                break;
+            }
+            this->insertBlock(index, data, ret);
+            data = nullptr;
+            this->copyFromBlock(index, offset + total, buf + total, size - total, copied);
+        }
+        if (copied <= 0) break;
+        total += copied;
+    }
+    if (this->prefetchBlocks > 0) {
+        this->prefetchFrom = (offset + (total > 0 ? total : 0)) / this->blockSize + 1;
+        this->cv.notify_one();
+    }
+    return total;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取缓存统计
+* @Param:        @stats (AVIOStats&) 输出
+* @Return:       void
+**/
+void AVIOBlockCache::getStats(AVIOStats& stats) {
+    stats.cacheHits = this->hits.load();
+    stats.cacheMisses = this->misses.load();
+    stats.prefetched = this->prefetched.load();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        预读线程，读取prefetchFrom之后prefetchBlocks个不在缓存中的块，新的读取位置会打断旧的预读任务
+* @Param:        void
+* @Return:       void
+**/
+void AVIOBlockCache::prefetchThread() {
+    int64_t from = -1;
+    int64_t index = 0;
+    int ret = 0;
+    unsigned char* data = nullptr;
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (!this->threadShouldEnd) {
+        this->cv.wait(lock, [this] {return this->prefetchFrom >= 0 || this->threadShouldEnd; });
+        if (this->threadShouldEnd) break;
+        from = this->prefetchFrom;
+        this->prefetchFrom = -1;
+        for (index = from; index < from + this->prefetchBlocks && index < this->blockTotal; index++) {
+            if (this->threadShouldEnd || this->prefetchFrom >= 0) break;//读取位置已经改变
+            if (this->blocks.count(index) || this->loading.count(index)) continue;
+            this->loading.insert(index);
+            lock.unlock();
+            ret = this->loadBlock(index, data);
+            lock.lock();
+            this->loading.erase(index);
+            if (ret > 0) {
+                this->insertBlock(index, data, ret);
+                this->prefetched++;
+            }
+            data = nullptr;
+            this->loaded_cv.notify_all();
+        }
+    }
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+MediaIO::MediaIO() :source(nullptr), ownsSource(false), cache(nullptr), ioContext(nullptr), position(0), bytesDelivered(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，释放全部资源
+* @Param:        void
+* @Return:       void
+**/
+MediaIO::~MediaIO() {
+    this->close();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        以指定模式打开本地文件
+* @Param:        @path (const std::string&) 本地文件路径
+*                @mode uint8_t MEDIAIO_MODE_CACHE 或 MEDIAIO_MODE_MMAP
+*                @blockSize int 块大小（仅cache模式）
+*                @blockCount int 缓存块数上限（仅cache模式）
+*                @prefetchBlocks int 预读块数（仅cache模式）
+* @Return:       bool 成功返回true
+**/
+bool MediaIO::open(const std::string& path, uint8_t mode, int blockSize, int blockCount, int prefetchBlocks) {
+    std::string localPath = path;
+    this->close();
+    if (mode != MEDIAIO_MODE_CACHE && mode != MEDIAIO_MODE_MMAP) return false;
+    if (!MediaIO::isLocalPath(path)) return false;
+    if (localPath.compare(0, 5, "file:") == 0) localPath = localPath.substr(5);
+    if (mode == MEDIAIO_MODE_MMAP) {
+        this->source = new MmapSource;
+    }
+    else {
+        this->source = new FileSource;
+    }
+    this->ownsSource = true;
+    if (!this->source->open(localPath)) {
+        this->close();
+        return false;
+    }
+    if (mode == MEDIAIO_MODE_CACHE) {
+        this->cache = new AVIOBlockCache(this->source, blockSize, blockCount, prefetchBlocks);
+    }
+    if (!this->createContext()) {
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        使用外部读取源打开（如ThrottledSource），读取源需已打开且生命周期长于MediaIO
+* @Param:        @source (AVIOSource *) 已打开的读取源
+*                @blockSize int 块大小
+*                @blockCount int 缓存块数上限，0表示不使用块缓存
+*                @prefetchBlocks int 预读块数
+* @Return:       bool 成功返回true
+**/
+bool MediaIO::open(AVIOSource* source, int blockSize, int blockCount, int prefetchBlocks) {
+    this->close();
+    if (!source || source->size() < 0) return false;
+    this->source = source;
+    this->ownsSource = false;
+    if (blockCount > 0) {
+        this->cache = new AVIOBlockCache(this->source, blockSize, blockCount, prefetchBlocks);
+    }
+    if (!this->createContext()) {
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        释放AVIOContext、块缓存和读取源，需要在formatContext释放之后调用
+* @Param:        void
+* @Return:       void
+**/
+void MediaIO::close() {
+    if (this->ioContext) {
+        av_freep(&this->ioContext->buffer);
+        avio_context_free(&this->ioContext);
+    }
+    if (this->cache) {
+        delete this->cache;
+        this->cache = nullptr;
+    }
+    if (this->source && this->ownsSource) {
+        delete this->source;
+    }
+    this->source = nullptr;
+    this->ownsSource = false;
+    this->position = 0;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回AVIOContext，赋值给formatContext->pb
+* @Param:        void
+* @Return:       (AVIOContext *)
+**/
+AVIOContext* MediaIO::context() {
+    return this->ioContext;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取IO统计
+* @Param:        void
+* @Return:       AVIOStats
+**/
+AVIOStats MediaIO::getStats() {
+    AVIOStats stats;
+    if (this->source) {
+        stats.bytesRead = this->source->getBytesRead();
+        stats.syscalls = this->source->getSyscalls();
+    }
+    if (this->cache) {
+        this->cache->getStats(stats);
+    }
+    stats.bytesDelivered = this->bytesDelivered.load();
+    return stats;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        判断是否为本地文件路径（没有协议头或为file:协议）
+* @Param:        @path (const std::string&) 路径
+* @Return:       bool
+**/
+bool MediaIO::isLocalPath(const std::string& path) {
+    size_t pos = path.find("://");
+    if (path.compare(0, 5, "file:") == 0) return true;
+    if (pos == std::string::npos) return true;
+    //windows盘符 C:/xxx 不会出现"://"，出现则视为网络协议
+    return false;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        创建AVIOContext
+* @Param:        void
+* @Return:       bool 成功返回true
+**/
+bool MediaIO::createContext() {
+    unsigned char* buffer = (unsigned char*)av_malloc(MEDIAIO_AVIO_BUFFER_SIZE);
+    if (!buffer) return false;
+    this->ioContext = avio_alloc_context(buffer, MEDIAIO_AVIO_BUFFER_SIZE, 0, this, &MediaIO::readPacket, nullptr, &MediaIO::seek);
+    if (!this->ioContext) {
+        av_free(buffer);
+        return false;
+    }
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        AVIOContext读取回调
+* @Param:        @opaque (void *) MediaIO指针
+*                @buf (uint8_t *) ffmpeg提供的缓冲
+*                @size int 缓冲大小
+* @Return:       int 读取字节数，文件结束返回AVERROR_EOF
+**/
+int MediaIO::readPacket(void* opaque, uint8_t* buf, int size) {
+    MediaIO* io = (MediaIO*)opaque;
+    int ret = 0;
+    if (io->cache) {
+        ret = io->cache->read(io->position, buf, size);
+    }
+    else {
+        ret = io->source->read(io->position, buf, size);
+    }
+    if (ret == 0) return AVERROR_EOF;
+    if (ret < 0) return AVERROR(EIO);
+    io->position += ret;
+    io->bytesDelivered += ret;
+    return ret;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        AVIOContext跳转回调，只改变读取位置，不产生系统调用
+* @Param:        @opaque (void *) MediaIO指针
+*                @offset int64_t 偏移
+*                @whence int SEEK_SET/SEEK_CUR/SEEK_END/AVSEEK_SIZE
+* @Return:       int64_t 新位置或文件大小，失败返回<0
+**/
+int64_t MediaIO::seek(void* opaque, int64_t offset, int whence) {
+    MediaIO* io = (MediaIO*)opaque;
+    int64_t size = io->source->size();
+    int64_t pos = 0;
+    whence &= ~AVSEEK_FORCE;
+    switch (whence) {
+    case AVSEEK_SIZE:
+        return size;
+    case SEEK_SET:
+        pos = offset;
+        break;
+    case SEEK_CUR:
+        pos = io->position + offset;
+        break;
+    case SEEK_END:
+        pos = size + offset;
+        break;
+    default:
+        return -1;
+    }
+    if (pos < 0) return -1;
+    io->position = pos;
+    return pos;
+}
@@ -0,0 +1,244 @@
+#ifndef _MEDIAIO_H_
+#define _MEDIAIO_H_
+
+/**
+* @File name:    MediaIO.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  供CppPlayer使用的自定义AVIOContext层（预读块缓存、mmap读取、限速读取源）
+**/
+
+
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+
+struct AVIOContext;
+
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  IO模式的define
+**/
+#define MEDIAIO_MODE_DEFAULT         (0x00)//使用ffmpeg默认的file协议
+#define MEDIAIO_MODE_CACHE           (0x01)//块缓存+后台预读
+#define MEDIAIO_MODE_MMAP            (0x02)//本地文件整体映射
+
+#define MEDIAIO_DEFAULT_BLOCK_SIZE   (256 * 1024)
+#define MEDIAIO_DEFAULT_BLOCK_COUNT  (64)
+#define MEDIAIO_DEFAULT_PREFETCH     (4)
+#define MEDIAIO_AVIO_BUFFER_SIZE     (64 * 1024)
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  IO统计信息，bytesRead/syscalls为实际读取源的数据，cacheHits/cacheMisses按块统计
+    **/
+    class AVIOStats {
+    public:
+        AVIOStats();
+        double hitRate() const;
+        uint64_t bytesRead;//从读取源实际读取的字节数
+        uint64_t bytesDelivered;//交给ffmpeg的字节数
+        uint64_t syscalls;//读取源产生的系统调用次数
+        uint64_t cacheHits;//块命中次数
+        uint64_t cacheMisses;//块未命中次数（需要同步读取）
+        uint64_t prefetched;//后台预读的块数
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  读取源抽象，按绝对偏移读取，需要保证read可被多个线程同时调用
+    **/
+    class AVIOSource {
+    public:
+        AVIOSource();
+        virtual ~AVIOSource();
+        virtual bool open(const std::string& path) = 0;
+        virtual void close() = 0;
+        virtual int read(int64_t offset, unsigned char* buf, int size) = 0;
+        int64_t size();
+        virtual uint64_t getSyscalls();
+        virtual uint64_t getBytesRead();
+    protected:
+        int64_t fileSize;//文件大小
+        std::atomic<uint64_t> syscalls;//系统调用次数
+        std::atomic<uint64_t> bytesRead;//实际读取字节数
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  普通文件读取源，每次read对应一次pread（win32下为ReadFile）
+    **/
+    class FileSource :public AVIOSource {
+    public:
+        FileSource();
+        ~FileSource();
+        bool open(const std::string& path);
+        void close();
+        int read(int64_t offset, unsigned char* buf, int size);
+    private:
+#ifdef _WIN32
+        void* handle;//文件句柄
+#else
+        int fd;//文件描述符
+#endif
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  mmap读取源，打开时整体映射文件，read只是内存拷贝，不产生系统调用
+    **/
+    class MmapSource :public AVIOSource {
+    public:
+        MmapSource();
+        ~MmapSource();
+        bool open(const std::string& path);
+        void close();
+        int read(int64_t offset, unsigned char* buf, int size);
+    private:
+        unsigned char* mapped;//映射地址
+#ifdef _WIN32
+        void* handle;//文件句柄
+        void* mapping;//映射句柄
+#else
+        int fd;//文件描述符
+#endif
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  限速读取源，包装另一个读取源，每次read附加固定延迟并按带宽限速，
+    *                用于在本地模拟NFS等慢速存储，不拥有被包装的读取源。统计只由被包装的读取源计数
+    **/
+    class ThrottledSource :public AVIOSource {
+    public:
+        ThrottledSource(AVIOSource* source, int latencyUs, int64_t bytesPerSecond);
+        ~ThrottledSource();
+        bool open(const std::string& path);
+        void close();
+        int read(int64_t offset, unsigned char* buf, int size);
+        uint64_t getSyscalls();
+        uint64_t getBytesRead();
+    private:
+        AVIOSource* source;//被包装的读取源
+        int latencyUs;//每次读取的固定延迟
+        int64_t bytesPerSecond;//带宽，<=0表示不限速
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  块缓存，按blockSize对齐读取源，LRU淘汰，后台线程顺序预读当前读取位置之后的块
+    **/
+    class AVIOBlockCache {
+    public:
+        AVIOBlockCache(AVIOSource* source, int blockSize, int blockCount, int prefetchBlocks);
+        ~AVIOBlockCache();
+        int read(int64_t offset, unsigned char* buf, int size);
+        void getStats(AVIOStats& stats);
+    private:
+
+        struct Block {
+            int64_t index;
+            int size;
+            unsigned char* data;
+        };
+
+        bool copyFromBlock(int64_t index, int64_t offset, unsigned char* buf, int size, int& copied);
+        void insertBlock(int64_t index, unsigned char* data, int size);
+        int loadBlock(int64_t index, unsigned char*& data);
+        void prefetchThread();
+
+        AVIOSource* source;//读取源，不拥有
+        int blockSize;//块大小
+        int blockCount;//缓存块数上限
+        int prefetchBlocks;//预读块数
+        int64_t blockTotal;//文件总块数
+
+        std::list<Block> lru;//表头为最近使用
+        std::unordered_map<int64_t, std::list<Block>::iterator> blocks;//块下标到lru节点
+        std::unordered_set<int64_t> loading;//正在读取中的块，避免预读线程和读取线程重复读取
+        int64_t prefetchFrom;//预读起始块，-1表示没有预读任务
+
+        bool threadShouldEnd;
+        std::thread* thread;
+        std::mutex mutex;
+        std::condition_variable cv;//预读任务
+        std::condition_variable loaded_cv;//块读取完成
+
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> prefetched;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  MediaIO 拥有读取源、块缓存和AVIOContext，供avformat_open_input作为自定义IO使用，
+    *                open(AVIOSource*)传入的读取源需已经打开，且不转移所有权（便于测试时传入限速读取源）
+    **/
+    class MediaIO {
+    public:
+        MediaIO();
+        ~MediaIO();
+
+        bool open(const std::string& path, uint8_t mode, int blockSize = MEDIAIO_DEFAULT_BLOCK_SIZE,
+            int blockCount = MEDIAIO_DEFAULT_BLOCK_COUNT, int prefetchBlocks = MEDIAIO_DEFAULT_PREFETCH);
+        bool open(AVIOSource* source, int blockSize, int blockCount, int prefetchBlocks);
+        void close();
+        AVIOContext* context();
+        AVIOStats getStats();
+
+        static bool isLocalPath(const std::string& path);
+
+    private:
+
+        bool createContext();
+        static int readPacket(void* opaque, uint8_t* buf, int size);
+        static int64_t seek(void* opaque, int64_t offset, int whence);
+
+        AVIOSource* source;//读取源
+        bool ownsSource;//读取源是否由MediaIO创建（需要释放）
+        AVIOBlockCache* cache;//块缓存，mmap模式下为null
+        AVIOContext* ioContext;//交给ffmpeg的IO上下文
+        int64_t position;//当前读取位置
+        std::atomic<uint64_t> bytesDelivered;
+    };
+
+
+};
+
+
+#endif//_MEDIAIO_H_
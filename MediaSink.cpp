@@ -0,0 +1,220 @@
+#include "MediaSink.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  MediaSink.h的实现
+**/
+
+using namespace MediaUse;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+NullVideoSink::NullVideoSink() :staged(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        开始输出
+* @Param:        @width int 图像宽
+* @Param:        @height int 图像高
+* @Return:       bool 总是成功
+**/
+bool NullVideoSink::open(int width, int height) {
+    (void)width;
+    (void)height;
+    this->staged = 0;
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        结束输出
+* @Param:        void
+* @Return:       void
+**/
+void NullVideoSink::close() {
+    this->staged = 0;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        暂存位置是否空闲
+* @Param:        void
+* @Return:       bool
+**/
+bool NullVideoSink::canStage() {
+    return this->staged == 0;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        暂存一帧（不保存数据）
+* @Param:        @frame const AVDataInfo& 图像
+* @Return:       bool 总是成功
+**/
+bool NullVideoSink::stage(const AVDataInfo& frame) {
+    (void)frame;
+    this->staged++;
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        显示暂存的帧（直接丢弃）
+* @Param:        @pts int64_t 帧的pts
+* @Return:       void
+**/
+void NullVideoSink::present(int64_t pts) {
+    (void)pts;
+    if (this->staged > 0) this->staged--;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        丢弃暂存的帧
+* @Param:        void
+* @Return:       void
+**/
+void NullVideoSink::flush() {
+    this->staged = 0;
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        构造函数
+* @Param:        @path const std::string& WAV文件路径，为空时丢弃音频
+* @Return:       void
+**/
+WavAudioSink::WavAudioSink(const std::string& path) :path(path) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置WAV文件路径，下一次open时生效
+* @Param:        @path const std::string& 为空时丢弃音频
+* @Return:       void
+**/
+void WavAudioSink::setPath(const std::string& path) {
+    this->path = path;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        创建WAV文件
+* @Param:        @sampleRate int 采样率
+* @Param:        @channels int 声道数
+* @Param:        @bufferCount int 请求的缓冲块数（忽略）
+* @Return:       int 1，文件创建失败时返回0
+**/
+int WavAudioSink::open(int sampleRate, int channels, int bufferCount) {
+    (void)bufferCount;
+    if (!this->path.empty() && !this->wav.open(this->path, sampleRate, channels)) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        关闭WAV文件
+* @Param:        void
+* @Return:       void
+**/
+void WavAudioSink::close() {
+    this->wav.close();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        总是可以写入一块，不限速
+* @Param:        void
+* @Return:       int 1
+**/
+int WavAudioSink::writable() {
+    return 1;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        写入一块PCM
+* @Param:        @frame const AVDataInfo& PCM数据
+* @Return:       bool 写入失败返回false
+**/
+bool WavAudioSink::write(const AVDataInfo& frame) {
+    if (!this->wav.isOpen()) return true;
+    return this->wav.write(frame.data, frame.size);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        无操作
+* @Param:        void
+* @Return:       void
+**/
+void WavAudioSink::play() {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        无操作
+* @Param:        void
+* @Return:       void
+**/
+void WavAudioSink::pause() {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        无操作，已写入的数据不能撤回
+* @Param:        void
+* @Return:       void
+**/
+void WavAudioSink::stop() {
+
+}
@@ -0,0 +1,140 @@
+#ifndef _MEDIASINK_H_
+#define _MEDIASINK_H_
+
+/**
+* @File name:    MediaSink.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  PlayerEngine的输出接口：视频输出VideoSink、音频输出AudioSink、主时钟ClockSource，
+*                字幕输出SubtitleSink，以及不依赖界面/音频设备的实现（丢弃输出、写入WAV文件）
+**/
+
+
+#include <string>
+#include <cstdint>
+#include "MediaUse.h"
+#include "WavWriter.h"
+#include "SubtitleDecoder.h"
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  视频输出，所有函数都在引擎的视频线程调用。帧先stage（如上传到PBO）再按时钟present，
+    *                stage需要拷贝数据，返回后帧数据归引擎所有
+    **/
+    class VideoSink {
+    public:
+        virtual ~VideoSink() {}
+        virtual bool open(int width, int height) = 0;//第一帧解码后调用，宽高为RGB24图像尺寸
+        virtual void close() = 0;
+        virtual bool canStage() = 0;//是否还能暂存一帧
+        virtual bool stage(const AVDataInfo& frame) = 0;
+        virtual void present(int64_t pts) = 0;//显示最早暂存的一帧
+        virtual void flush() = 0;//跳转时丢弃所有暂存的帧
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  音频输出，所有函数都在引擎的音频线程调用，数据为S16交错PCM。
+    *                引擎按缓冲块写入，音频时钟为最早一个尚未播放完的缓冲的pts
+    **/
+    class AudioSink {
+    public:
+        virtual ~AudioSink() {}
+        virtual int open(int sampleRate, int channels, int bufferCount) = 0;//返回实际使用的缓冲块数，失败返回0
+        virtual void close() = 0;
+        virtual int writable() = 0;//现在可以写入的缓冲块数（已播放完或尚未使用的）
+        virtual bool write(const AVDataInfo& frame) = 0;
+        virtual void play() = 0;//开始或保持播放（欠载停止后恢复）
+        virtual void pause() = 0;
+        virtual void stop() = 0;//停止并丢弃已写入的数据，跳转时调用
+        virtual void setSpeed(float speed) { (void)speed; }//播放速度（OpenAL下音调随之变化），直播追帧不使用，在PCM上处理
+        virtual bool isSuspended() { return false; }//输出听不到（如混音中静音且不在焦点），引擎可以暂停音频解码
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  字幕输出，所有函数都在引擎的字幕线程调用。事件在解封装读到时就送来（早于显示时间），
+    *                实现可以在这里预先光栅化，显示时按视频帧的pts选择当前的事件
+    **/
+    class SubtitleSink {
+    public:
+        virtual ~SubtitleSink() {}
+        virtual void show(const SubtitleEvent& event) = 0;//新的字幕事件，没有区域时为清除（从event.start起不再显示之前的字幕）
+        virtual void flush() = 0;//跳转或切换字幕流时丢弃所有事件
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  主时钟，视频帧的pts不大于now()时显示，单位us（AV_TIME_BASE）
+    **/
+    class ClockSource {
+    public:
+        virtual ~ClockSource() {}
+        virtual int64_t now() = 0;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  丢弃视频帧，只保留一帧暂存位置，用于无界面的测试和基准
+    **/
+    class NullVideoSink :public VideoSink {
+    public:
+        NullVideoSink();
+        bool open(int width, int height) override;
+        void close() override;
+        bool canStage() override;
+        bool stage(const AVDataInfo& frame) override;
+        void present(int64_t pts) override;
+        void flush() override;
+    private:
+        int staged;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  不限速的音频输出，写入WAV文件（路径为空时丢弃），只有一个缓冲块，时钟即最后写入的帧
+    **/
+    class WavAudioSink :public AudioSink {
+    public:
+        WavAudioSink(const std::string& path = "");
+        void setPath(const std::string& path);
+        int open(int sampleRate, int channels, int bufferCount) override;
+        void close() override;
+        int writable() override;
+        bool write(const AVDataInfo& frame) override;
+        void play() override;
+        void pause() override;
+        void stop() override;
+    private:
+        std::string path;
+        WavWriter wav;
+    };
+
+
+};
+
+
+#endif//_MEDIASINK_H_
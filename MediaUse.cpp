@@ -7,6 +7,14 @@
 * @Description:  MediaUses.h的实现
 **/
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace MediaUse;
 
 
@@ -66,3 +74,18 @@ void AVDataInfo::clear() {
 }
 
 
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        降低当前线程的调度优先级，后台解码不应和播放线程抢占CPU
+* @Param:        void
+* @Return:       void
+**/
+void MediaUse::lowerThreadPriority(){
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+    setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19);
+#endif
+}
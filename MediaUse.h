@@ -6,12 +6,14 @@
 * @Author:       Li
 * @Version:      1.0
 * @Date:         2025-03-07
-* @Description:  供Cpplayer使用的一些数据类型（AVFifoLoop、AVDataInfo、MediaDataQueue）
+* @Description:  供Cpplayer使用的一些数据类型（AVFifoLoop、AVDataInfo、MediaDataQueue、LockFreeRing）以及后台线程的工具函数
 **/
 
 
 #include <queue>
 #include <mutex>
+#include <atomic>
+#include <vector>
 #include<condition_variable>
 
 
@@ -275,10 +277,12 @@ namespace MediaUse {
 		void clearWithDelete();
 		bool empty();
 		size_t size();
+		size_t depth();
 
 	private:
 
         std::queue<T> queue;//实际的队列
+        std::atomic<size_t> count;//队列长度的副本，供统计时无锁读取
         std::mutex mutex;//锁
         std::condition_variable cv;//条件变量
 
@@ -293,7 +297,7 @@ namespace MediaUse {
     * @Return:       void
     **/
 	template<typename T>
-	MediaDataQueue<T>::MediaDataQueue() {
+	MediaDataQueue<T>::MediaDataQueue() :count(0) {
 
 	}
 
@@ -322,6 +326,7 @@ namespace MediaUse {
 	void MediaDataQueue<T>::push(T data) {
 		std::lock_guard<std::mutex> lock(mutex);
 		queue.push(data);
+		count.store(queue.size(), std::memory_order_relaxed);
 		cv.notify_one();
 	}
 
@@ -340,6 +345,7 @@ namespace MediaUse {
 		if (!queue.empty()) {
 			data = queue.front();
 			queue.pop();
+			count.store(queue.size(), std::memory_order_relaxed);
 		}
 		return data;
 	}
@@ -442,6 +448,7 @@ namespace MediaUse {
 	void MediaDataQueue<T>::clear() {
 		std::lock_guard<std::mutex> lock(mutex);
 		std::queue<T>().swap(queue);
+		count.store(0, std::memory_order_relaxed);
 	}
 
     /**
@@ -459,6 +466,7 @@ namespace MediaUse {
 			queue.front().clear();
 			queue.pop();
 		}
+		count.store(0, std::memory_order_relaxed);
 	}
 
     /**
@@ -489,6 +497,170 @@ namespace MediaUse {
 		return queue.size();
 	}
 
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        无锁读取队列长度（最近一次入队/出队后的值），用于统计，不能用于判断能否pop
+    * @Param:        void
+    * @Return:       size_t 队列元素个数
+    **/
+	template<typename T>
+	size_t MediaDataQueue<T>::depth() {
+		return count.load(std::memory_order_relaxed);
+	}
+
+
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  单生产者单消费者无锁环形队列，容量向上取整为2的幂，满时push失败（不阻塞）
+    *                生产者只调用push，消费者只调用pop，setCapacity需要在两端都未使用时调用
+    **/
+	template<typename T>
+	class LockFreeRing {
+	public:
+		LockFreeRing();
+		LockFreeRing(size_t capacity);
+		void setCapacity(size_t capacity);
+		bool push(const T& data);
+		bool pop(T& data);
+		bool empty();
+		size_t size();
+		size_t capacity();
+	private:
+        std::vector<T> buffer;//数据
+        size_t mask;//容量-1
+        std::atomic<size_t> head;//消费者读取位置（单调递增）
+        std::atomic<size_t> tail;//生产者写入位置（单调递增）
+	};
+
+
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        默认构造函数，使用前需要setCapacity
+    * @Param:        void
+    * @Return:       void
+    **/
+	template<typename T>
+	LockFreeRing<T>::LockFreeRing() :mask(0), head(0), tail(0) {
+
+	}
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        带指定容量构造函数
+    * @Param:        @capacity size_t 容量（会向上取整为2的幂）
+    * @Return:       void
+    **/
+	template<typename T>
+	LockFreeRing<T>::LockFreeRing(size_t capacity) :mask(0), head(0), tail(0) {
+		this->setCapacity(capacity);
+	}
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        重新指定容量并清空队列
+    * @Param:        @capacity size_t 容量（会向上取整为2的幂）
+    * @Return:       void
+    **/
+	template<typename T>
+	void LockFreeRing<T>::setCapacity(size_t capacity) {
+		size_t realCapacity = 1;
+		while (realCapacity < capacity) realCapacity <<= 1;
+		buffer.assign(realCapacity, T());
+		mask = realCapacity - 1;
+		head.store(0);
+		tail.store(0);
+	}
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        生产者向队尾写入一个数据，队列已满返回false
+    * @Param:        @data (const T&) 数据
+    * @Return:       bool(success is true)
+    **/
+	template<typename T>
+	bool LockFreeRing<T>::push(const T& data) {
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (buffer.empty() || t - head.load(std::memory_order_acquire) > mask) return false;
+		buffer[t & mask] = data;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        消费者从队头取出一个数据，队列为空返回false
+    * @Param:        @data (T&) 输出数据
+    * @Return:       bool(success is true)
+    **/
+	template<typename T>
+	bool LockFreeRing<T>::pop(T& data) {
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) return false;
+		data = buffer[h & mask];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        判断队列是否为空
+    * @Param:        void
+    * @Return:       bool
+    **/
+	template<typename T>
+	bool LockFreeRing<T>::empty() {
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        获取队列当前元素个数（并发时为近似值）
+    * @Param:        void
+    * @Return:       size_t
+    **/
+	template<typename T>
+	size_t LockFreeRing<T>::size() {
+		size_t h = head.load(std::memory_order_acquire);
+		return tail.load(std::memory_order_acquire) - h;
+	}
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        获取队列容量
+    * @Param:        void
+    * @Return:       size_t
+    **/
+	template<typename T>
+	size_t LockFreeRing<T>::capacity() {
+		return buffer.size();
+	}
+
+
+	//降低当前线程的调度优先级，缩略图、音频分析等后台线程使用，不和播放线程抢占CPU
+	void lowerThreadPriority();
 
 };
 
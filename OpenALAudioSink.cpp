@@ -0,0 +1,258 @@
+#include "OpenALAudioSink.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  OpenALAudioSink.h的实现
+**/
+
+#include<AL/alc.h>
+#include<AL/al.h>
+
+using namespace MediaUse;
+
+
+//类内静态成员初始化
+bool OpenALAudioSink::resourceInitOnce = true;
+ALCdevice* OpenALAudioSink::device = nullptr;
+ALCcontext* OpenALAudioSink::context = nullptr;
+std::mutex OpenALAudioSink::device_mutex;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        类资源初始化，一个进程在类实例化前执行一次，不保证多进程竞争音频播放设备安全性
+* @Param:        void
+* @Return:       void
+**/
+void OpenALAudioSink::resourceInit() {
+    std::lock_guard<std::mutex> lock(device_mutex);
+    if (resourceInitOnce) {
+        device = nullptr;
+        context = nullptr;
+        resourceInitOnce = false;
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        类资源释放，一个进程在不使用该类后执行一次，不保证多进程竞争音频播放设备安全性
+* @Param:        void
+* @Return:       void
+**/
+void OpenALAudioSink::releaseResource() {
+    std::lock_guard<std::mutex> lock(device_mutex);
+    if (resourceInitOnce) {
+        if (context) {
+            alcDestroyContext(context);
+            context = nullptr;
+        }
+        if (device) {
+            alcCloseDevice(device);
+            device = nullptr;
+        }
+        resourceInitOnce = false;
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+OpenALAudioSink::OpenALAudioSink() :source(0), queued(0), sampleRate(0), format(AL_FORMAT_STEREO16), opened(false) {
+    this->mixerChannel = AudioMixer::global().addChannel();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构函数
+* @Param:        void
+* @Return:       void
+**/
+OpenALAudioSink::~OpenALAudioSink() {
+    this->close();
+    AudioMixer::global().removeChannel(this->mixerChannel);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开设备（进程内第一次使用时）并创建source和缓冲块
+* @Param:        @sampleRate int 采样率
+* @Param:        @channels int 声道数（1或2）
+* @Param:        @bufferCount int 缓冲块数
+* @Return:       int 缓冲块数，设备或上下文创建失败返回0
+**/
+int OpenALAudioSink::open(int sampleRate, int channels, int bufferCount) {
+    float sourcePos[3] = { 0.0f,0.0f,0.0f };
+    float sourceVel[3] = { 0.0f,0.0f,0.0f };
+    std::lock_guard<std::mutex> lock(device_mutex);
+    this->close();
+    if (!device) {
+        device = alcOpenDevice(nullptr);
+        if (!device) return 0;
+    }
+    if (!context) {
+        context = alcCreateContext(device, nullptr);
+        if (!context) return 0;
+    }
+    alcMakeContextCurrent(context);
+    this->buffers.assign(bufferCount, 0);
+    alGenBuffers(bufferCount, this->buffers.data());
+    alGenSources(1, &this->source);
+    alSourcef(this->source, AL_PITCH, 1.0f);
+    alSourcefv(this->source, AL_POSITION, sourcePos);
+    alSourcefv(this->source, AL_VELOCITY, sourceVel);
+    alSourcei(this->source, AL_LOOPING, AL_FALSE);
+    this->queued = 0;
+    this->sampleRate = sampleRate;
+    this->format = channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+    this->opened = true;
+    AudioMixer::global().attachSource(this->mixerChannel, this->source);//按通道的音量设置AL_GAIN
+    return bufferCount;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        停止播放并释放source和缓冲块
+* @Param:        void
+* @Return:       void
+**/
+void OpenALAudioSink::close() {
+    if (!this->opened) return;
+    AudioMixer::global().detachSource(this->mixerChannel);
+    alSourceStop(this->source);
+    alSourceUnqueueBuffers(this->source, this->queued, this->buffers.data());
+    alDeleteSources(1, &this->source);
+    alDeleteBuffers((int)this->buffers.size(), this->buffers.data());
+    this->buffers.clear();
+    this->queued = 0;
+    this->opened = false;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        可以写入的缓冲块数：未使用的块加上已播放完的块
+* @Param:        void
+* @Return:       int
+**/
+int OpenALAudioSink::writable() {
+    int processed = 0;
+    alGetSourcei(this->source, AL_BUFFERS_PROCESSED, &processed);
+    return (int)this->buffers.size() - this->queued + processed;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        填充一个缓冲块并入队，先使用未入队过的块，之后取出播放完的块复用
+* @Param:        @frame const AVDataInfo& PCM数据
+* @Return:       bool 没有可用的块返回false
+**/
+bool OpenALAudioSink::write(const AVDataInfo& frame) {
+    unsigned int buffer = 0;
+    if (this->queued < (int)this->buffers.size()) {
+        buffer = this->buffers[this->queued++];
+    }
+    else {
+        alSourceUnqueueBuffers(this->source, 1, &buffer);
+        if (!buffer) return false;
+    }
+    alBufferData(buffer, this->format, frame.data, (int)frame.size, this->sampleRate);
+    alSourceQueueBuffers(this->source, 1, &buffer);
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        开始播放，欠载导致source停止时重新开始
+* @Param:        void
+* @Return:       void
+**/
+void OpenALAudioSink::play() {
+    int state = 0;
+    alGetSourcei(this->source, AL_SOURCE_STATE, &state);
+    if (state != AL_PLAYING) {
+        alSourcePlay(this->source);
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        暂停
+* @Param:        void
+* @Return:       void
+**/
+void OpenALAudioSink::pause() {
+    alSourcePause(this->source);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        停止，所有已入队的块变为播放完，之后的写入会依次复用
+* @Param:        void
+* @Return:       void
+**/
+void OpenALAudioSink::stop() {
+    alSourceStop(this->source);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置播放速度（音调随之变化）
+* @Param:        @speed float 1.0为正常速度
+* @Return:       void
+**/
+void OpenALAudioSink::setSpeed(float speed) {
+    alSourcef(this->source, AL_PITCH, speed);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        混音中是否已挂起（静音且不在焦点），引擎据此暂停音频解码
+* @Param:        void
+* @Return:       bool
+**/
+bool OpenALAudioSink::isSuspended() {
+    return AudioMixer::global().isSuspended(this->mixerChannel);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        在AudioMixer::global()中的通道号，用于设置音量、静音和焦点
+* @Param:        void
+* @Return:       int
+**/
+int OpenALAudioSink::getMixerChannel() {
+    return this->mixerChannel;
+}
@@ -0,0 +1,71 @@
+#ifndef _OPENALAUDIOSINK_H_
+#define _OPENALAUDIOSINK_H_
+
+/**
+* @File name:    OpenALAudioSink.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  基于OpenAL的音频输出（AudioSink实现），进程内所有实例共用一个设备和上下文，每个实例一个source，
+*                音量/静音/焦点由AudioMixer::global()中的通道管理
+**/
+
+
+#include <mutex>
+#include <vector>
+#include "MediaSink.h"
+#include "AudioMixer.h"
+
+struct ALCdevice;
+struct ALCcontext;
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  OpenAL音频输出，缓冲块依次填充入队，播放完的块出队后重新填充
+    **/
+    class OpenALAudioSink :public AudioSink {
+    public:
+        static void resourceInit();
+        static void releaseResource();
+
+        OpenALAudioSink();
+        ~OpenALAudioSink();
+        int open(int sampleRate, int channels, int bufferCount) override;
+        void close() override;
+        int writable() override;
+        bool write(const AVDataInfo& frame) override;
+        void play() override;
+        void pause() override;
+        void stop() override;
+        void setSpeed(float speed) override;
+        bool isSuspended() override;
+        int getMixerChannel();
+
+    private:
+        //资源初始化，避免多次对音频输出设备初始化
+        static bool resourceInitOnce;
+        static ALCdevice* device;
+        static ALCcontext* context;
+        static std::mutex device_mutex;
+
+        unsigned int source;
+        std::vector<unsigned int> buffers;
+        int queued;//已经入队过的缓冲块数，小于buffers.size()时还有未使用的块
+        int sampleRate;
+        int format;
+        bool opened;
+        int mixerChannel;//在AudioMixer::global()中的通道号
+    };
+
+
+};
+
+
+#endif//_OPENALAUDIOSINK_H_
@@ -0,0 +1,383 @@
+#include "PipelineTrace.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  PipelineTrace.h的实现
+**/
+
+#include <chrono>
+#include <cstdio>
+#include <cinttypes>
+#include <algorithm>
+
+using namespace MediaUse;
+
+
+namespace {
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  线程局部的缓冲指针，线程结束时把缓冲标记为可复用（缓冲本身由PipelineTrace持有）
+    **/
+    struct TraceThreadSlot {
+        TraceThreadBuffer* buffer = nullptr;
+        ~TraceThreadSlot() {
+            if (buffer) buffer->released.store(true);
+        }
+    };
+
+    thread_local TraceThreadSlot traceThreadSlot;
+
+    /**
+    * @Author:       Li
+    * @Date:         2026-10-19
+    * @Version:      1.0
+    * @Brief:        写入JSON字符串（转义引号、反斜杠和控制字符）
+    * @Param:        @file (FILE*) 输出文件
+    *                @str (const char*) 字符串
+    * @Return:       void
+    **/
+    void writeJsonString(FILE* file, const char* str) {
+        fputc('"', file);
+        for (; str && *str; str++) {
+            if (*str == '"' || *str == '\\') {
+                fputc('\\', file);
+                fputc(*str, file);
+            }
+            else if ((unsigned char)*str < 0x20) {
+                fprintf(file, "\\u%04x", (unsigned char)*str);
+            }
+            else {
+                fputc(*str, file);
+            }
+        }
+        fputc('"', file);
+    }
+
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取全局单例
+* @Param:        void
+* @Return:       PipelineTrace&
+**/
+PipelineTrace& PipelineTrace::instance() {
+    static PipelineTrace trace;
+    return trace;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        单调时钟
+* @Param:        void
+* @Return:       int64_t ns
+**/
+int64_t PipelineTrace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        构造函数，默认开启记录
+* @Param:        void
+* @Return:       void
+**/
+PipelineTrace::PipelineTrace() :isEnabled(true), nextTid(1), origin(PipelineTrace::now()) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，释放全部线程缓冲
+* @Param:        void
+* @Return:       void
+**/
+PipelineTrace::~PipelineTrace() {
+    for (auto i : this->buffers) {
+        delete i;
+    }
+    this->buffers.clear();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        开启或暂停记录，暂停时记录接口直接返回
+* @Param:        @enabled bool
+* @Return:       void
+**/
+void PipelineTrace::setEnabled(bool enabled) {
+    this->isEnabled.store(enabled);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否正在记录
+* @Param:        void
+* @Return:       bool
+**/
+bool PipelineTrace::enabled() {
+    return this->isEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置当前线程在trace中显示的名字
+* @Param:        @name (const char*) 线程名
+* @Return:       void
+**/
+void PipelineTrace::setThreadName(const char* name) {
+    TraceThreadBuffer* buffer = this->threadBuffer();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    buffer->name = name;
+    this->threadNames.push_back(std::make_pair(buffer->tid, buffer->name));
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        记录一个区间事件
+* @Param:        @name (const char*) 阶段名（静态字符串）
+*                @begin int64_t 开始时间（now()）
+*                @end int64_t 结束时间（now()）
+*                @arg int64_t 附加参数，一般为帧的pts
+* @Return:       void
+**/
+void PipelineTrace::record(const char* name, int64_t begin, int64_t end, int64_t arg) {
+    TraceEvent event;
+    if (!this->enabled()) return;
+    event.name = name;
+    event.begin = begin - this->origin;
+    event.duration = end - begin;
+    event.arg = arg;
+    event.phase = 'X';
+    this->push(event);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        记录一个计数器值（如A-V偏差、队列长度），在trace中显示为折线
+* @Param:        @name (const char*) 计数器名（静态字符串）
+*                @value int64_t 值
+* @Return:       void
+**/
+void PipelineTrace::counter(const char* name, int64_t value) {
+    TraceEvent event;
+    if (!this->enabled()) return;
+    event.name = name;
+    event.begin = PipelineTrace::now() - this->origin;
+    event.duration = value;
+    event.arg = -1;
+    event.phase = 'C';
+    this->push(event);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        记录一个瞬时事件（如跳转、丢帧）
+* @Param:        @name (const char*) 事件名（静态字符串）
+*                @arg int64_t 附加参数
+* @Return:       void
+**/
+void PipelineTrace::instant(const char* name, int64_t arg) {
+    TraceEvent event;
+    if (!this->enabled()) return;
+    event.name = name;
+    event.begin = PipelineTrace::now() - this->origin;
+    event.duration = 0;
+    event.arg = arg;
+    event.phase = 'i';
+    this->push(event);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        取出全部线程缓冲中的事件，腾出缓冲空间，长时间追踪时可定时调用
+* @Param:        void
+* @Return:       void
+**/
+void PipelineTrace::collect() {
+    TraceEvent event;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto i : this->buffers) {
+        while (i->ring.pop(event)) {
+            this->collected.push_back(event);
+        }
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        导出已记录的事件为Chrome trace JSON，导出后清空已导出的事件
+* @Param:        @path (const std::string&) 输出文件路径
+* @Return:       bool 成功返回true
+**/
+bool PipelineTrace::dump(const std::string& path) {
+    FILE* file = nullptr;
+    uint64_t dropped = 0;
+    bool first = true;
+    this->collect();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    file = fopen(path.c_str(), "w");
+    if (!file) return false;
+    std::sort(this->collected.begin(), this->collected.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.begin < b.begin;
+    });
+    for (auto i : this->buffers) {
+        dropped += i->dropped.exchange(0);
+    }
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":%" PRIu64 "},\"traceEvents\":[\n", dropped);
+    for (auto& i : this->threadNames) {
+        fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", i.first);
+        writeJsonString(file, i.second.c_str());
+        fprintf(file, "}}");
+        first = false;
+    }
+    for (auto& i : this->collected) {
+        fprintf(file, "%s{\"ph\":\"%c\",\"name\":", first ? "" : ",\n", i.phase);
+        writeJsonString(file, i.name);
+        fprintf(file, ",\"pid\":1,\"tid\":%u,\"ts\":%" PRId64 ".%03d", i.tid, i.begin / 1000, (int)(i.begin % 1000));
+        if (i.phase == 'X') {
+            fprintf(file, ",\"dur\":%" PRId64 ".%03d", i.duration / 1000, (int)(i.duration % 1000));
+            if (i.arg != -1) fprintf(file, ",\"args\":{\"pts\":%" PRId64 "}", i.arg);
+        }
+        else if (i.phase == 'C') {
+            fprintf(file, ",\"args\":{\"value\":%" PRId64 "}", i.duration);
+        }
+        else {
+            fprintf(file, ",\"s\":\"t\"");
+            if (i.arg != -1) fprintf(file, ",\"args\":{\"arg\":%" PRId64 "}", i.arg);
+        }
+        fputc('}', file);
+        first = false;
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    this->collected.clear();
+    return true;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        丢弃全部已记录的事件
+* @Param:        void
+* @Return:       void
+**/
+void PipelineTrace::clear() {
+    this->collect();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->collected.clear();
+    for (auto i : this->buffers) {
+        i->dropped.store(0);
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取当前线程的缓冲，首次使用时注册（优先复用已结束线程的缓冲，复用前取出其中的事件）
+* @Param:        void
+* @Return:       TraceThreadBuffer*
+**/
+TraceThreadBuffer* PipelineTrace::threadBuffer() {
+    TraceThreadBuffer* buffer = traceThreadSlot.buffer;
+    TraceEvent event;
+    if (buffer) return buffer;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto i : this->buffers) {
+        if (i->released.load()) {
+            while (i->ring.pop(event)) {
+                this->collected.push_back(event);
+            }
+            buffer = i;
+            break;
+        }
+    }
+    if (!buffer) {
+        buffer = new TraceThreadBuffer;
+        buffer->ring.setCapacity(PIPELINETRACE_BUFFER_EVENTS);
+        buffer->dropped.store(0);
+        this->buffers.push_back(buffer);
+    }
+    buffer->tid = this->nextTid++;
+    buffer->name.clear();
+    buffer->released.store(false);
+    traceThreadSlot.buffer = buffer;
+    return buffer;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        写入当前线程的缓冲，缓冲已满时丢弃并计数
+* @Param:        @event (const TraceEvent&) 事件
+* @Return:       void
+**/
+void PipelineTrace::push(const TraceEvent& event) {
+    TraceThreadBuffer* buffer = this->threadBuffer();
+    TraceEvent e = event;
+    e.tid = buffer->tid;
+    if (!buffer->ring.push(e)) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        构造时记录开始时间
+* @Param:        @name (const char*) 阶段名（静态字符串）
+*                @arg int64_t 附加参数，一般为帧的pts
+* @Return:       void
+**/
+TraceZone::TraceZone(const char* name, int64_t arg) :name(name), begin(PipelineTrace::now()), arg(arg) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构时写入区间事件
+* @Param:        void
+* @Return:       void
+**/
+TraceZone::~TraceZone() {
+    PipelineTrace::instance().record(this->name, this->begin, PipelineTrace::now(), this->arg);
+}
@@ -0,0 +1,140 @@
+#ifndef _PIPELINETRACE_H_
+#define _PIPELINETRACE_H_
+
+/**
+* @File name:    PipelineTrace.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  播放流水线追踪（解封装、解码、格式转换、PBO上传、纹理更新、显示、音频缓冲等阶段的耗时），
+*                每个线程写入自己的无锁环形缓冲，按需导出为Chrome/Perfetto trace JSON（chrome://tracing 或 ui.perfetto.dev 打开）
+*                只有定义了CPPPLAYER_TRACE才会编译追踪代码，未定义时CPPPLAYER_TRACE_xxx宏为空
+**/
+
+
+#include <string>
+#include <list>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "MediaUse.h"
+
+
+//每个线程的环形缓冲可容纳的事件数，满了之后新事件被丢弃并计数，dump/collect会取出已有事件腾出空间
+#define PIPELINETRACE_BUFFER_EVENTS     (1 << 16)
+
+
+#ifdef CPPPLAYER_TRACE
+#define CPPPLAYER_TRACE_CONCAT_(a, b)           a##b
+#define CPPPLAYER_TRACE_CONCAT(a, b)            CPPPLAYER_TRACE_CONCAT_(a, b)
+#define CPPPLAYER_TRACE_ZONE(name)              MediaUse::TraceZone CPPPLAYER_TRACE_CONCAT(traceZone, __LINE__)(name)
+#define CPPPLAYER_TRACE_ZONE_ARG(name, arg)     MediaUse::TraceZone CPPPLAYER_TRACE_CONCAT(traceZone, __LINE__)(name, arg)
+#define CPPPLAYER_TRACE_COUNTER(name, value)    MediaUse::PipelineTrace::instance().counter(name, value)
+#define CPPPLAYER_TRACE_INSTANT(name, arg)      MediaUse::PipelineTrace::instance().instant(name, arg)
+#define CPPPLAYER_TRACE_THREAD(name)            MediaUse::PipelineTrace::instance().setThreadName(name)
+#else
+#define CPPPLAYER_TRACE_ZONE(name)
+#define CPPPLAYER_TRACE_ZONE_ARG(name, arg)
+#define CPPPLAYER_TRACE_COUNTER(name, value)
+#define CPPPLAYER_TRACE_INSTANT(name, arg)
+#define CPPPLAYER_TRACE_THREAD(name)
+#endif
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  一条追踪事件，name必须是静态字符串（只保存指针），arg一般为帧的pts（us），-1表示没有
+    **/
+    struct TraceEvent {
+        const char* name;
+        int64_t begin;//ns，相对于PipelineTrace创建时刻
+        int64_t duration;//ns，计数器事件为计数值
+        int64_t arg;
+        uint32_t tid;
+        char phase;//'X'区间 'C'计数器 'i'瞬时
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  单个线程的事件缓冲，线程结束后由下一个新线程复用
+    **/
+    struct TraceThreadBuffer {
+        LockFreeRing<TraceEvent> ring;
+        std::string name;
+        uint32_t tid;
+        std::atomic<bool> released;
+        std::atomic<uint64_t> dropped;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  流水线追踪，全局单例，记录接口线程安全且无锁（首次在线程中使用时注册缓冲需要加锁一次）
+    **/
+    class PipelineTrace {
+    public:
+        static PipelineTrace& instance();
+        static int64_t now();
+
+        void setEnabled(bool enabled);
+        bool enabled();
+        void setThreadName(const char* name);
+        void record(const char* name, int64_t begin, int64_t end, int64_t arg = -1);
+        void counter(const char* name, int64_t value);
+        void instant(const char* name, int64_t arg = -1);
+        void collect();
+        bool dump(const std::string& path);
+        void clear();
+
+    private:
+        PipelineTrace();
+        ~PipelineTrace();
+        PipelineTrace(const PipelineTrace&) = delete;
+        PipelineTrace& operator=(const PipelineTrace&) = delete;
+
+        TraceThreadBuffer* threadBuffer();
+        void push(const TraceEvent& event);
+
+        std::atomic<bool> isEnabled;
+        std::atomic<uint32_t> nextTid;
+        int64_t origin;//创建时刻（ns）
+        std::list<TraceThreadBuffer*> buffers;
+        std::vector<TraceEvent> collected;//已从环形缓冲取出、等待导出的事件
+        std::vector<std::pair<uint32_t, std::string>> threadNames;
+        std::mutex mutex;//保护buffers/collected/threadNames，只在注册线程和导出时使用
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  作用域追踪区间，构造时记录开始时间，析构时写入一条'X'事件
+    **/
+    class TraceZone {
+    public:
+        TraceZone(const char* name, int64_t arg = -1);
+        ~TraceZone();
+    private:
+        const char* name;
+        int64_t begin;
+        int64_t arg;
+    };
+
+
+};
+
+
+#endif//_PIPELINETRACE_H_
@@ -0,0 +1,171 @@
+#include "PlaybackStats.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  PlaybackStats.h的实现
+**/
+
+#include <cstdio>
+#include <cinttypes>
+#include "QualityController.h"
+
+using namespace MediaUse;
+
+
+namespace {
+
+    //直方图区间的上界（us），最后一个区间没有上界
+    const int64_t avBucketEdge[PLAYBACKSTATS_AV_BUCKETS - 1] = { -100000, -40000, -15000, -5000, 5000, 15000, 40000, 100000 };
+
+    const char* avBucketNames[PLAYBACKSTATS_AV_BUCKETS] = {
+        "<-100", "-100~-40", "-40~-15", "-15~-5", "-5~5", "5~15", "15~40", "40~100", ">100"
+    };
+
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+StreamStats::StreamStats() :index(-1), discarded(false), packets(0), bytes(0) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+PlaybackStats::PlaybackStats() :decodeFps(0), renderFps(0), videoDecodeMs(0), audioDecodeMs(0),
+    framesDecoded(0), framesRendered(0), framesDropped(0), framesLate(0), avOffset(0),
+    videoPacketQueue(0), audioDataQueue(0), frameDataQueue(0),
+    frameCacheBytes(0), frameCacheBudget(0), frameCacheHitRate(0), ioCacheHitRate(0),
+    poolPriority(0), poolBusy(0), poolThroughput(0), audioSuspended(false), audioPacketsSkipped(0),
+    background(false), videoPacketsSkipped(0), backgroundSeconds(0), backgroundSavedMs(0),
+    qualityLevel(0), qualityLoad(0), seeks(0), seeksCoalesced(0), seeksPreempted(0), prerollDropped(0), startupOpenMs(-1), firstVideoMs(-1), firstAudioMs(-1),
+    still(false), stillWakes(0), loops(0), audioTrack(-1), audioTrackSwitches(0), subtitleTrack(-1), subtitleEvents(0) {
+    for (int i = 0; i < PLAYBACKSTATS_AV_BUCKETS; i++) {
+        this->avHistogram[i] = 0;
+    }
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        A-V偏差所在的直方图区间
+* @Param:        @offset int64_t A-V偏差（us）
+* @Return:       int [0, PLAYBACKSTATS_AV_BUCKETS)
+**/
+int PlaybackStats::avBucket(int64_t offset) {
+    int i = 0;
+    while (i < PLAYBACKSTATS_AV_BUCKETS - 1 && offset >= avBucketEdge[i]) i++;
+    return i;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        直方图区间的名字（ms）
+* @Param:        @bucket int 区间下标
+* @Return:       const char*
+**/
+const char* PlaybackStats::avBucketName(int bucket) {
+    if (bucket < 0 || bucket >= PLAYBACKSTATS_AV_BUCKETS) return "";
+    return avBucketNames[bucket];
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        转换为多行文本，用于界面叠加显示或日志
+* @Param:        void
+* @Return:       std::string
+**/
+std::string PlaybackStats::toString() const {
+    char buf[256] = { 0 };
+    std::string str;
+    snprintf(buf, sizeof(buf), "decode %.1f fps  %.2f ms/frame (audio %.2f ms)\n", this->decodeFps, this->videoDecodeMs, this->audioDecodeMs);
+    str += buf;
+    snprintf(buf, sizeof(buf), "render %.1f fps  frames %" PRIu64 "  dropped %" PRIu64 "  late %" PRIu64 "\n",
+        this->renderFps, this->framesRendered, this->framesDropped, this->framesLate);
+    str += buf;
+    snprintf(buf, sizeof(buf), "A-V %.1f ms\n", this->avOffset / 1000.0);
+    str += buf;
+    str += "A-V(ms)";
+    for (int i = 0; i < PLAYBACKSTATS_AV_BUCKETS; i++) {
+        snprintf(buf, sizeof(buf), " %s:%" PRIu64, avBucketNames[i], this->avHistogram[i]);
+        str += buf;
+    }
+    str += "\n";
+    snprintf(buf, sizeof(buf), "queue packet %zu  audio %zu  frame %zu\n", this->videoPacketQueue, this->audioDataQueue, this->frameDataQueue);
+    str += buf;
+    snprintf(buf, sizeof(buf), "frame cache %.1f/%.1f MB  hit %.0f%%  io cache hit %.0f%%",
+        this->frameCacheBytes / 1048576.0, this->frameCacheBudget / 1048576.0, this->frameCacheHitRate * 100, this->ioCacheHitRate * 100);
+    str += buf;
+    if (this->poolPriority > 0) {
+        snprintf(buf, sizeof(buf), "\ndecoder pool prio %d  busy %.0f%%  %.0f units/s", this->poolPriority, this->poolBusy * 100, this->poolThroughput);
+        str += buf;
+    }
+    if (this->audioSuspended || this->audioPacketsSkipped > 0) {
+        snprintf(buf, sizeof(buf), "\naudio %s  skipped %" PRIu64 " packets", this->audioSuspended ? "suspended" : "active", this->audioPacketsSkipped);
+        str += buf;
+    }
+    if (this->background || this->videoPacketsSkipped > 0) {
+        snprintf(buf, sizeof(buf), "\nbackground %s  %.1f s  skipped %" PRIu64 " video packets  saved ~%.0f ms decode",
+            this->background ? "on" : "off", this->backgroundSeconds, this->videoPacketsSkipped, this->backgroundSavedMs);
+        str += buf;
+    }
+    if (this->qualityLevel > QUALITYCONTROLLER_LEVEL_FULL) {
+        snprintf(buf, sizeof(buf), "\nquality %s  load %.2f", QualityStats::levelName(this->qualityLevel), this->qualityLoad);
+        str += buf;
+    }
+    if (this->seeks > 0) {
+        snprintf(buf, sizeof(buf), "\nseeks %" PRIu64 "  coalesced %" PRIu64 "  preempted %" PRIu64 "  preroll dropped %" PRIu64,
+            this->seeks, this->seeksCoalesced, this->seeksPreempted, this->prerollDropped);
+        str += buf;
+    }
+    if (this->startupOpenMs >= 0) {
+        snprintf(buf, sizeof(buf), "\nstartup open %.0f ms  first video %.0f ms  first audio %.0f ms", this->startupOpenMs, this->firstVideoMs, this->firstAudioMs);
+        str += buf;
+    }
+    if (this->still) {
+        snprintf(buf, sizeof(buf), "\nvideo still  wakes %" PRIu64, this->stillWakes);
+        str += buf;
+    }
+    if (this->loops > 0) {
+        snprintf(buf, sizeof(buf), "\nseamless loops %" PRIu64, this->loops);
+        str += buf;
+    }
+    if (this->audioTrackSwitches > 0) {
+        snprintf(buf, sizeof(buf), "\naudio track %d  switches %" PRIu64, this->audioTrack, this->audioTrackSwitches);
+        str += buf;
+    }
+    if (this->subtitleTrack >= 0) {
+        snprintf(buf, sizeof(buf), "\nsubtitle track %d  events %" PRIu64, this->subtitleTrack, this->subtitleEvents);
+        str += buf;
+    }
+    if (!this->streams.empty()) {
+        str += "\nstreams";
+        for (size_t i = 0; i < this->streams.size(); i++) {
+            snprintf(buf, sizeof(buf), "  #%d %s%s %" PRIu64 "/%.1fMB", this->streams[i].index, this->streams[i].type.c_str(),
+                this->streams[i].discarded ? "(discard)" : "", this->streams[i].packets, this->streams[i].bytes / 1048576.0);
+            str += buf;
+        }
+    }
+    return str;
+}
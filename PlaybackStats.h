@@ -0,0 +1,137 @@
+#ifndef _PLAYBACKSTATS_H_
+#define _PLAYBACKSTATS_H_
+
+/**
+* @File name:    PlaybackStats.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  CppPlayer运行状态快照（解码/渲染帧率、丢帧、A-V偏差分布、队列深度、缓存占用）
+**/
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+
+#define PLAYBACKSTATS_AV_BUCKETS        (9)//A-V偏差直方图的区间数
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  一个流的解封装统计：av_read_frame返回的packet数和字节数。
+    *                discarded为demuxer直接丢弃（AVDISCARD_ALL）的流，正常情况下它的计数应保持为0或很少
+    **/
+    class StreamStats {
+    public:
+        StreamStats();
+        int index;
+        std::string type;//video/audio/subtitle/data/attachment，封面为cover
+        bool discarded;
+        uint64_t packets;
+        uint64_t bytes;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  运行状态快照，由PlayerEngine::getStats填写，A-V为音频时钟减去视频帧pts（正数表示视频落后）
+    **/
+    class PlaybackStats {
+    public:
+        PlaybackStats();
+        std::string toString() const;
+        static int avBucket(int64_t offset);
+        static const char* avBucketName(int bucket);
+
+        //帧率（最近一个统计窗口）和每帧平均耗时（自打开文件起）
+        double decodeFps;
+        double renderFps;
+        double videoDecodeMs;
+        double audioDecodeMs;
+
+        //累计帧数
+        uint64_t framesDecoded;
+        uint64_t framesRendered;
+        uint64_t framesDropped;//直播追帧丢弃的视频帧
+        uint64_t framesLate;//显示时已落后音频超过1.5帧间隔的视频帧
+
+        //最近一次显示的A-V偏差（us）和分布
+        int64_t avOffset;
+        uint64_t avHistogram[PLAYBACKSTATS_AV_BUCKETS];
+
+        //队列深度
+        size_t videoPacketQueue;
+        size_t audioDataQueue;
+        size_t frameDataQueue;
+
+        //缓存（帧缓存、自定义IO块缓存）占用和命中率
+        size_t frameCacheBytes;
+        size_t frameCacheBudget;
+        double frameCacheHitRate;
+        double ioCacheHitRate;
+
+        //共享解码调度器中的优先级（0表示未使用调度器）、占用率（以一个线程计）和吞吐量（每秒读取的packet+解码的帧）
+        int poolPriority;
+        double poolBusy;
+        double poolThroughput;
+
+        //音频输出是否挂起（听不到时不解码音频），以及因此未解码的音频packet数
+        bool audioSuspended;
+        uint64_t audioPacketsSkipped;
+
+        //是否处于后台模式、后台丢弃的视频packet数、累计后台时间（s）和估计节省的解码时间（ms）
+        bool background;
+        uint64_t videoPacketsSkipped;
+        double backgroundSeconds;
+        double backgroundSavedMs;
+
+        //自适应画质等级（QUALITYCONTROLLER_LEVEL_xxx）和解码负载（解码耗时/帧间隔）
+        int qualityLevel;
+        double qualityLoad;
+
+        //执行的跳转数、合并到后续目标而未执行的请求数、执行中被新目标取代的跳转数
+        uint64_t seeks;
+        uint64_t seeksCoalesced;
+        uint64_t seeksPreempted;
+        uint64_t prerollDropped;//跳转后解码到目标时丢弃（未转换）的视频帧数
+
+        //启动耗时（ms，从avOpen开始）：打开完成、第一帧视频显示、音频开始播放，小于0表示尚未发生
+        double startupOpenMs;
+        double firstVideoMs;
+        double firstAudioMs;
+
+        //静态画面（只有封面或没有视频流）时视频线程挂起，stillWakes为挂起后被唤醒或超时的次数
+        bool still;
+        uint64_t stillWakes;
+
+        //无缝循环衔接的次数
+        uint64_t loops;
+
+        //当前音轨（流下标）和播放中切换音轨的次数
+        int audioTrack;
+        uint64_t audioTrackSwitches;
+
+        //当前字幕流（-1为不显示）和已解码送出的字幕事件数
+        int subtitleTrack;
+        uint64_t subtitleEvents;
+
+        //每个流的解封装统计
+        std::vector<StreamStats> streams;
+    };
+
+
+};
+
+
+#endif//_PLAYBACKSTATS_H_
@@ -0,0 +1,3567 @@
+﻿#include "PlayerEngine.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  PlayerEngine.h的实现
+**/
+
+#include "PipelineTrace.h"
+
+#include<math.h>
+#include<iostream>
+#include<fstream>
+#include<string>
+#include<cstring>
+#include<cinttypes>
+#include<algorithm>
+#include<deque>
+
+extern "C"{
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libavutil/avutil.h"
+#include "libavutil/time.h"
+}
+
+using namespace MediaUse;
+using std::cout;
+using std::endl;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+AudioTrackInfo::AudioTrackInfo() :streamIndex(-1), sampleRate(0), channels(0), selected(false) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+SubtitleTrackInfo::SubtitleTrackInfo() :streamIndex(-1), bitmap(false), selected(false) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数，输出为丢弃（NullVideoSink/WavAudioSink），主时钟为音频时钟
+* @Param:        void
+* @Return:       void
+**/
+PlayerEngine::PlayerEngine(){
+    this->avInit();
+    this->liveMode = false;
+    this->liveLatencyTarget = CPPPLAYER_LIVE_DEFAULT_TARGET * 1000;
+    this->ioMode = MEDIAIO_MODE_DEFAULT;
+    this->ioBlockSize = MEDIAIO_DEFAULT_BLOCK_SIZE;
+    this->ioBlockCount = MEDIAIO_DEFAULT_BLOCK_COUNT;
+    this->ioPrefetchBlocks = MEDIAIO_DEFAULT_PREFETCH;
+    this->ioThrottleLatency = 0;
+    this->ioThrottleBandwidth = 0;
+    this->frameCacheBudget = CPPPLAYER_FRAMECACHE_DEFAULT_BUDGET;
+    this->frameCacheDownscale = 1;
+    this->offlineMode = false;
+    this->fastStart = false;
+    this->seamlessLoop.store(false);
+    this->offlineStartClock.store(0);
+    this->offlineEndClock.store(-1);
+    this->offlineAudioSamples.store(0);
+    this->videoSink = &this->nullVideoSink;
+    this->audioSink = &this->nullAudioSink;
+    this->subtitleSink = nullptr;
+    this->clockSource = this;
+    this->decoderPool = nullptr;
+    this->decoderPoolPriority = DECODERPOOL_PRIORITY_NORMAL;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构函数，等待线程结束并释放资源
+* @Param:        void
+* @Return:       void
+**/
+PlayerEngine::~PlayerEngine(){
+    if (this->isRunning()) {
+        this->avStop();
+    }
+    else {
+        this->avClear();
+    }
+#ifdef CPPPLAYER_DEBUG
+    this->log.close();
+#endif
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置视频输出，avStart之前调用
+* @Param:        @sink (VideoSink *) 为nullptr时丢弃视频
+* @Return:       void
+**/
+void PlayerEngine::setVideoSink(VideoSink* sink){
+    this->videoSink = sink ? sink : &this->nullVideoSink;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置音频输出，avStart之前调用
+* @Param:        @sink (AudioSink *) 为nullptr时不限速丢弃音频
+* @Return:       void
+**/
+void PlayerEngine::setAudioSink(AudioSink* sink){
+    this->audioSink = sink ? sink : &this->nullAudioSink;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置字幕输出，avOpen之前调用
+* @Param:        @sink (SubtitleSink *) 为nullptr时不读取字幕流（默认）
+* @Return:       void
+**/
+void PlayerEngine::setSubtitleSink(SubtitleSink* sink){
+    this->subtitleSink = sink;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置视频同步的主时钟，avStart之前调用
+* @Param:        @clock (ClockSource *) 为nullptr时使用引擎自己的音频时钟
+* @Return:       void
+**/
+void PlayerEngine::setClockSource(ClockSource* clock){
+    this->clockSource = clock ? clock : this;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置播放结束回调（音视频都输出完毕时在解码线程调用）
+* @Param:        @callback (std::function<void()>)
+* @Return:       void
+**/
+void PlayerEngine::setEndCallback(std::function<void()> callback){
+    this->endCallback = callback;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        使用共享解码调度器（多画面同时播放时限制总线程数），avOpen之前调用。
+*                解封装/音频解码和视频解码作为调度器任务运行，解码器不再开启多线程，输出线程仍然独立
+* @Param:        @pool (MediaUse::DecoderPool *) 为nullptr时使用自己的线程（默认）
+*                @priority int 优先级（DECODERPOOL_PRIORITY_xxx），即时间片的权重
+* @Return:       void
+**/
+void PlayerEngine::setDecoderPool(MediaUse::DecoderPool* pool, int priority){
+    this->decoderPool = pool;
+    this->decoderPoolPriority = priority;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        修改在共享解码调度器中的优先级，播放中调用立即生效（如切换到大画面的播放器提高优先级）
+* @Param:        @priority int 优先级（DECODERPOOL_PRIORITY_xxx）
+* @Return:       void
+**/
+void PlayerEngine::setDecoderPriority(int priority){
+    this->decoderPoolPriority = priority;
+    if (this->decoderPool && this->decoderPoolClient >= 0) {
+        this->decoderPool->setPriority(this->decoderPoolClient, priority);
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        音频时钟：正在播放的音频缓冲的pts，没有音频流时为INT64_MAX（视频按帧率定时显示）
+* @Param:        void
+* @Return:       int64_t 单位us
+**/
+int64_t PlayerEngine::now(){
+    return this->audioPts.load();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        设置文件路径，不允许在avOpen期间修改
+* @Param:        @str (const std::string) 文件路径
+* @Return:       void
+**/
+void PlayerEngine::setPath(const std::string str){
+    this->path = str;
+    //this->setWindowTitle(str.c_str());
+#ifdef CPPPLAYER_DEBUG
+    std::string str2;
+    for (auto i = (--str.end()); i != str.begin(); i--) {
+        if (*i == '.') {
+            str2 = str.substr(0, i - str.begin()) + "_log.txt";
+            break;
+        }
+    }
+    this->log.open(str2);
+#endif
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回文件路径
+* @Param:        void
+* @Return:       std::string
+**/
+std::string PlayerEngine::getPath(){
+    return this->path;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        创建子线程，开始解码和播放
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::avStart(){
+    this->offlineStartClock.store(av_gettime_relative());
+    this->offlineEndClock.store(-1);
+    this->offlineAudioSamples.store(0);
+    this->playerShouldEnd = false;
+    if (this->decoderPool) {//解封装/音频解码和视频解码作为任务交给共享调度器，完成时由promise通知join
+        this->decoderPool->start();
+        this->decoderPoolClient = this->decoderPool->addClient(this->path, this->decoderPoolPriority);
+        this->readTaskDone = std::promise<void>();
+        this->ffmpegThread = new std::future<void>(this->readTaskDone.get_future());
+        this->decoderPool->submit(this->decoderPoolClient, [this](int64_t budgetUs, uint64_t& units) {return this->readTask(budgetUs, units); });
+        if (this->videoStream) {
+            this->videoTaskDone = std::promise<void>();
+            this->videoDecodeThread = new std::future<void>(this->videoTaskDone.get_future());
+            this->decoderPool->submit(this->decoderPoolClient, [this](int64_t budgetUs, uint64_t& units) {return this->videoDecodeTask(budgetUs, units); });
+        }
+    }
+    else {
+        this->ffmpegThread = new std::future<void>(std::async(std::launch::async, &PlayerEngine::ffmpegReadThread, this));
+    }
+    this->videoThread = new std::future<void>(std::async(std::launch::async, &PlayerEngine::videoOutputThread, this));
+    this->audioThread = new std::future<void>(std::async(std::launch::async, &PlayerEngine::audioOutputThread, this));
+    if (this->subtitleSink && this->videoStream && !this->getSubtitleTracks().empty()) {
+        this->subtitleThread = new std::future<void>(std::async(std::launch::async, &PlayerEngine::subtitleOutputThread, this));
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        阻塞的方式等待播放结束
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::join(){
+    this->ffmpegThread->wait();
+    this->videoThread->wait();
+    this->audioThread->wait();
+    if (this->videoDecodeThread) this->videoDecodeThread->wait();
+    if (this->subtitleThread) this->subtitleThread->wait();
+    this->avClear();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        结束播放，需要等待线程安全结束
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::avStop(){
+    this->playerShouldEnd = true;
+    this->stillWake();
+    this->join();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        暂停播放，正在暂停的状态不会继续播放
+* @Param:        void
+* @Return:       void
+**/
+bool PlayerEngine::avPause(){
+    if(this->playerStatus.load() == CPPPLAYER_AV_PLAYING){
+        this->playerStatus.store(CPPPLAYER_AV_PAUSE);
+        return true;
+    }
+    return false;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        继续播放，正在播放的状态不会暂停
+* @Param:        void
+* @Return:       void
+**/
+bool PlayerEngine::avResume(){
+    if (this->decoderStatus.load() & (CPPPLAYER_DECODER_BACK | CPPPLAYER_DECODER_ADVANCE | CPPPLAYER_DECODER_GOTO)) {
+        return false;
+    }
+    this->playerStatus.store(CPPPLAYER_AV_PLAYING);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        设置单次快进和推后的时间偏移量
+* @Param:        @x (std::pair<int64_t, AVRational>) <size，单位>时间偏移量
+* @Return:       void
+**/
+void PlayerEngine::setOffset(std::pair<int64_t, AVRational> x){
+    this->offset = x;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        设置当前pts，即执行一次跳转。正在跳转时新的目标直接取代旧的目标
+* @Param:        @x (std::pair<int64_t, AVRational>) 需要跳转到的时间节点
+* @Return:       bool 跳转设置成功返回true，并非跳转完成
+**/
+bool PlayerEngine::setCurrentPts(std::pair<int64_t, AVRational> x){
+    return this->requestSeek(av_rescale_q(x.first, x.second, AVRational{ 1,AV_TIME_BASE }), false);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        提交跳转请求（任意线程）：更新跳转目标并通知解封装任务，不等待上一次跳转完成。
+*                相对跳转在上一次请求尚未完成时以上一次的目标为基准，连续按键累加为一个目标
+* @Param:        @pts int64_t 目标（us），relative时为偏移量
+*                @relative bool 是否相对跳转
+* @Return:       bool 没有在播放时返回false
+**/
+bool PlayerEngine::requestSeek(int64_t pts, bool relative){
+    std::lock_guard<std::mutex> lock(this->seekMutex);
+    int64_t duration = 0;
+    if (!(this->decoderStatus.load() & (CPPPLAYER_DECODER_EOF | CPPPLAYER_DECODER_ING | CPPPLAYER_DECODER_BUSY))) {
+        return false;
+    }
+    if (relative) {
+        if (this->seekGeneration.load() != this->seekCompleted.load()) {
+            pts += this->seekRequestPts.load();
+        }
+        else {
+            pts += this->loopWrapPts((this->videoStream && !this->justCover) ? this->videoPts.load() : this->audioPts.load());
+        }
+    }
+    duration = av_rescale_q(this->duration.first, this->duration.second, AVRational{ 1,AV_TIME_BASE });
+    if (duration > 0 && pts > duration) pts = duration;
+    if (pts < 0) pts = 0;
+    this->seekRequestPts.store(pts);
+    this->seekGeneration.fetch_add(1);
+    this->decoderStatus.store(CPPPLAYER_DECODER_GOTO);
+    this->decoderStatus_cv.notify_all();
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        单次快进，连续调用时偏移量累加
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::avAdvance(){
+    this->requestSeek(av_rescale_q(this->offset.first, this->offset.second, AVRational{ 1,AV_TIME_BASE }), true);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        单次后退，连续调用时偏移量累加
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::avBack(){
+    this->requestSeek(-av_rescale_q(this->offset.first, this->offset.second, AVRational{ 1,AV_TIME_BASE }), true);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        重播
+* @Param:        void
+* @Return:       void
+**/
+bool PlayerEngine::avRestart(){
+    return this->setCurrentPts(std::pair<int64_t, AVRational>(0, AVRational{ 1,AV_TIME_BASE }));
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        提交用户操作（如按键）。快进/后退/重播立即合并到跳转目标（按住方向键为连续拖动），
+*                暂停切换由视频线程每100ms执行最后提交的一个
+* @Param:        @operation uint8_t PLAYERENGINE_OP_xxx
+* @Return:       void
+**/
+void PlayerEngine::postOperation(uint8_t operation){
+    if (operation == PLAYERENGINE_OP_ADVANCE) this->avAdvance();
+    else if (operation == PLAYERENGINE_OP_BACK) this->avBack();
+    else if (operation == PLAYERENGINE_OP_RESTART) this->avRestart();
+    else {
+        this->userOperationQueue.push(operation);
+        this->stillWake();
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        唤醒挂起的视频线程（静态画面时），视频线程没有挂起时无影响
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::stillWake(){
+    {
+        std::lock_guard<std::mutex> lock(this->stillMutex);
+        this->stillWakePending = true;
+    }
+    this->stillCv.notify_all();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        A-B循环检查（视频线程调用），播放到B点时跳转回A点，pts回到B点之前才允许下一次触发
+* @Param:        @pending bool& 已触发跳转、pts尚未回到B点之前
+* @Return:       void
+**/
+void PlayerEngine::loopCheck(bool& pending){
+    int64_t loopPts = this->loopWrapPts(this->audioStream ? this->audioPts.load() : this->videoPts.load());
+    if (this->loopB.load() > 0 && loopPts >= this->loopB.load()) {
+        if (!pending && !(this->decoderStatus.load() & CPPPLAYER_DECODER_BUSY)) {
+            pending = true;
+            this->requestSeek(this->loopA.load(), false);
+        }
+    }
+    else {
+        pending = false;
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        执行队列中最后提交的用户操作（视频线程调用），其余的丢弃
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::operationApply(){
+    uint8_t finalOperation = 0;
+    uint8_t tPlayerStatus = CPPPLAYER_AV_UNKNOW;
+    if (this->userOperationQueue.empty()) return;
+    finalOperation = this->userOperationQueue.back();
+    this->userOperationQueue.clear();
+    tPlayerStatus = this->playerStatus.load();
+    if (finalOperation == PLAYERENGINE_OP_PAUSE_TOGGLE) {
+        if (tPlayerStatus == CPPPLAYER_AV_PLAYING) {
+            this->playerStatus.store(CPPPLAYER_AV_PAUSE);
+        }
+        else if (tPlayerStatus == CPPPLAYER_AV_PAUSE) {
+            this->playerStatus.store(CPPPLAYER_AV_PLAYING);
+        }
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        判断现在是否在运行（解码中或播放中）
+* @Param:        void
+* @Return:       bool 如果三个线程没结束返回true
+**/
+bool PlayerEngine::isRunning(){
+    if(this->ffmpegThread || this->videoThread || this->audioThread){
+        return true;
+    }else{
+        return false;
+    }
+    if(this->ffmpegThread->valid() || this->videoThread->valid() || this->audioThread->valid()){
+        return true;
+    }
+    return false;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        判断是否可以执行（快进/后退/跳转）操作
+* @Param:        void
+* @Return:       bool 如果可以执行返回true
+**/
+bool PlayerEngine::playerCouldBeOperate(){
+    if (this->decoderStatus.load() & (CPPPLAYER_DECODER_ING | CPPPLAYER_DECODER_EOF)) {
+        return true;
+    }
+    return false;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        返回播放状态（播放中/暂停/播放结束），详见头文件CPPPLAYER_DEFINE
+* @Param:        void
+* @Return:       uint8_t
+**/
+uint8_t PlayerEngine::getPlayStatus(){
+    return this->playerStatus.load();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        返回解码状态（解码中/解码结束等），详见头文件CPPPLAYER_DEFINE
+* @Param:        void
+* @Return:       uint8_t
+**/
+uint8_t PlayerEngine::getDecoderStatus(){
+    return this->decoderStatus.load();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        返回当前播放到的时间节点，即pts
+* @Param:        void
+* @Return:       std::pair<int64_t, AVRational>
+**/
+std::pair<int64_t, AVRational> PlayerEngine::getCurrentPts(){
+    if (this->videoStream && !this->justCover) {
+        return std::pair<int64_t, AVRational>(this->loopWrapPts(this->videoPts.load()), AVRational{ 1,AV_TIME_BASE });
+    }
+    return std::pair<int64_t, AVRational>(this->loopWrapPts(this->audioPts.load()), AVRational{ 1,AV_TIME_BASE });
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        返回总时长
+* @Param:        void
+* @Return:       std::pair<int64_t, AVRational>
+**/
+std::pair<int64_t, AVRational> PlayerEngine::getDuration(){
+    return this->duration;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置本地文件的IO模式，下一次avOpen时生效，网络流始终使用ffmpeg默认协议
+* @Param:        @mode uint8_t MEDIAIO_MODE_DEFAULT/MEDIAIO_MODE_CACHE/MEDIAIO_MODE_MMAP
+*                @blockSize int 缓存块大小（字节）
+*                @blockCount int 缓存块数上限
+*                @prefetchBlocks int 每次读取后后台预读的块数
+* @Return:       void
+**/
+void PlayerEngine::setIOMode(uint8_t mode, int blockSize, int blockCount, int prefetchBlocks){
+    this->ioMode = mode;
+    this->ioBlockSize = blockSize;
+    this->ioBlockCount = blockCount;
+    this->ioPrefetchBlocks = prefetchBlocks;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置限速读取，在本地模拟NFS等慢速存储（测试预读缓存用），下一次avOpen时生效，只对本地文件有效。
+*                IO模式为默认时也使用自定义IO（不带块缓存），每次读取都经过限速
+* @Param:        @latencyUs int 每次读取的固定延迟（us），0表示没有延迟
+*                @bytesPerSecond int64_t 带宽，<=0表示不限速；两者都不限时不使用限速读取
+* @Return:       void
+**/
+void PlayerEngine::setIOThrottle(int latencyUs, int64_t bytesPerSecond){
+    this->ioThrottleLatency = latencyUs > 0 ? latencyUs : 0;
+    this->ioThrottleBandwidth = bytesPerSecond > 0 ? bytesPerSecond : 0;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回自定义IO的统计（读取字节数、系统调用次数、缓存命中率），播放结束后返回最后一次的统计。
+*                只读取解封装线程发布的原子计数，不加锁
+* @Param:        void
+* @Return:       MediaUse::AVIOStats
+**/
+MediaUse::AVIOStats PlayerEngine::getIOStats(){
+    AVIOStats stats;
+    stats.bytesRead = this->ioStatBytesRead.load(std::memory_order_relaxed);
+    stats.bytesDelivered = this->ioStatBytesDelivered.load(std::memory_order_relaxed);
+    stats.syscalls = this->ioStatSyscalls.load(std::memory_order_relaxed);
+    stats.cacheHits = this->ioStatCacheHits.load(std::memory_order_relaxed);
+    stats.cacheMisses = this->ioStatCacheMisses.load(std::memory_order_relaxed);
+    stats.prefetched = this->ioStatPrefetched.load(std::memory_order_relaxed);
+    return stats;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置直播模式，下一次avOpen时生效。直播模式下使用nobuffer/low_delay打开，
+*                音频只预缓冲CPPPLAYER_LIVE_AUDIO_BUFFERS个buffer。附加延迟（见getLiveAddedLatency）超过目标时，
+*                音频转换为PCM时用swr_set_compensation少输出CPPPLAYER_LIVE_CATCHUP_RATIO的采样追赶（与音频输出无关，
+*                但播放速度和音调都会升高约5%），降到目标一半以下后恢复；超过两倍目标时直接丢弃整帧音频（会有可听的跳变）
+*                本地测试可使用 ffmpeg -re -i in.mp4 -c copy -f mpegts udp://127.0.0.1:1234 作为直播源
+* @Param:        @live bool 是否为直播
+*                @latencyTargetMs int64_t 目标延迟，单位ms
+* @Return:       void
+**/
+void PlayerEngine::setLiveMode(bool live, int64_t latencyTargetMs){
+    this->liveMode = live;
+    this->liveLatencyTarget = latencyTargetMs * 1000;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        判断是否为直播模式
+* @Param:        void
+* @Return:       bool
+**/
+bool PlayerEngine::isLiveMode(){
+    return this->liveMode;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回直播的附加延迟：第一个packet到达之后播放器累计增加的滞后（当前播放帧的pts相对于第一个packet
+*                到达时刻的落后量），不包含第一个packet到达之前的采集、编码、网络和服务器缓冲延迟，不是端到端延迟。
+*                追帧控制使用这个值
+* @Param:        void
+* @Return:       int64_t 单位us，非直播模式或尚未开始返回0
+**/
+int64_t PlayerEngine::getLiveAddedLatency(){
+    if (!this->liveMode) return 0;
+    return this->liveAddedLatency.load();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回直播的端到端延迟：当前时刻减去当前播放帧在发送端的采集时刻，发送端时刻来自
+*                formatContext->start_time_realtime（RTSP由RTCP发送报告的NTP时间得到），需要发送端和本机时钟同步
+* @Param:        void
+* @Return:       int64_t 单位us，非直播模式或源没有提供发送端时钟时返回-1
+**/
+int64_t PlayerEngine::getLiveEndToEndLatency(){
+    if (!this->liveMode) return -1;
+    return this->liveEndToEnd.load();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        根据当前播放的pts更新直播的附加延迟和端到端延迟
+* @Param:        @pts int64_t 当前播放帧的pts（AV_TIME_BASE）
+* @Return:       void
+**/
+void PlayerEngine::updateLiveLatency(int64_t pts){
+    int64_t startClock = this->liveStartClock.load();
+    int64_t senderClock = this->liveSenderClock.load();
+    if (startClock < 0) return;
+    this->liveAddedLatency.store((av_gettime_relative() - startClock) - (pts - this->liveStartPts.load()));
+    if (senderClock != AV_NOPTS_VALUE) {//pts为0的帧在发送端的采集时刻（unix时间，us）
+        this->liveEndToEnd.store(av_gettime() - (senderClock + pts));
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置已解码帧缓存，下一次avOpen时生效，直播和只有封面的文件不使用缓存
+* @Param:        @budget size_t 视频帧内存预算（字节），0表示关闭缓存（音频缓存同时关闭）
+*                @downscale int 视频帧缩小倍数，大于1时以 宽/downscale x 高/downscale 存储，取出时放大回原尺寸
+* @Return:       void
+**/
+void PlayerEngine::setFrameCache(size_t budget, int downscale){
+    this->frameCacheBudget = budget;
+    this->frameCacheDownscale = downscale;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回帧缓存统计（音视频缓存合计），包括帧命中率和跳转由缓存直接供帧的比例
+* @Param:        void
+* @Return:       MediaUse::FrameCacheStats
+**/
+MediaUse::FrameCacheStats PlayerEngine::getFrameCacheStats(){
+    FrameCacheStats stats;
+    this->videoFrameCache.getStats(stats);
+    this->audioFrameCache.getStats(stats);
+    stats.seeks = this->seekCount.load();
+    stats.seeksFromCache = this->seekFromCache.load();
+    return stats;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置A-B循环，播放到b时跳转回a，区间在帧缓存预算内时重复播放不再经过解码器
+* @Param:        @a (std::pair<int64_t, AVRational>) 循环起点
+*                @b (std::pair<int64_t, AVRational>) 循环终点
+* @Return:       bool 区间无效返回false
+**/
+bool PlayerEngine::setABLoop(std::pair<int64_t, AVRational> a, std::pair<int64_t, AVRational> b){
+    int64_t aPts = av_rescale_q(a.first, a.second, AVRational{ 1,AV_TIME_BASE });
+    int64_t bPts = av_rescale_q(b.first, b.second, AVRational{ 1,AV_TIME_BASE });
+    if (aPts < 0 || bPts <= aPts) return false;
+    this->loopA.store(aPts);
+    this->loopB.store(bPts);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置循环起点（取消已有的终点），之后由setLoopEnd开始循环
+* @Param:        @pts int64_t 循环起点（us）
+* @Return:       void
+**/
+void PlayerEngine::setLoopStart(int64_t pts){
+    this->loopB.store(-1);
+    this->loopA.store(pts);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置循环终点并开始A-B循环，需要已设置起点且终点在起点之后、尚未设置终点
+* @Param:        @pts int64_t 循环终点（us）
+* @Return:       bool 设置成功返回true
+**/
+bool PlayerEngine::setLoopEnd(int64_t pts){
+    if (this->loopB.load() >= 0 || this->loopA.load() < 0 || pts <= this->loopA.load()) return false;
+    this->loopB.store(pts);
+    this->stillWake();
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        取消A-B循环
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::clearABLoop(){
+    this->loopA.store(-1);
+    this->loopB.store(-1);
+    this->stillWake();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回循环起点（A键标记），也作为片段导出的入点
+* @Param:        void
+* @Return:       int64_t 单位us，没有设置返回-1
+**/
+int64_t PlayerEngine::getLoopStart(){
+    return this->loopA.load();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回循环终点（B键标记），也作为片段导出的出点
+* @Param:        void
+* @Return:       int64_t 单位us，没有设置返回-1
+**/
+int64_t PlayerEngine::getLoopEnd(){
+    return this->loopB.load();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        导出流水线追踪为Chrome trace JSON（chrome://tracing 或 ui.perfetto.dev 打开），需要定义CPPPLAYER_TRACE
+* @Param:        @tracePath (const std::string&) 输出路径，为空时使用 文件名_trace.json（与日志同目录）
+* @Return:       bool 成功返回true，未开启追踪返回false
+**/
+bool PlayerEngine::dumpTrace(const std::string& tracePath){
+#ifdef CPPPLAYER_TRACE
+    std::string str = tracePath;
+    if (str.empty()) {
+        str = this->path.substr(0, this->path.find_last_of('.')) + "_trace.json";
+    }
+    return PipelineTrace::instance().dump(str);
+#else
+    (void)tracePath;
+    return false;
+#endif
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置debug日志等级和限频（需要定义CPPPLAYER_DEBUG），默认INFO，每帧的解码日志为DEBUG
+* @Param:        @level uint8_t ASYNCLOGGER_LEVEL_xxx，ASYNCLOGGER_LEVEL_OFF关闭日志
+*                @rateLimitPerSecond uint32_t 同一条消息每秒最多记录的次数，0表示不限频
+* @Return:       void
+**/
+void PlayerEngine::setLogLevel(uint8_t level, uint32_t rateLimitPerSecond){
+#ifdef CPPPLAYER_DEBUG
+    this->log.setLevel(level);
+    this->log.setRateLimit(rateLimitPerSecond);
+#else
+    (void)level;
+    (void)rateLimitPerSecond;
+#endif
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取运行状态快照。计数来自原子变量，但帧缓存、画质控制、音轨、解码调度器的统计会短暂获取各自的锁，
+*                并为每个流分配统计项，不要在每帧绘制中调用，界面按定时器（如200ms）采样。
+*                帧率按调用间隔（至少500ms）计算，应在同一个线程（一般为界面线程）调用
+* @Param:        void
+* @Return:       MediaUse::PlaybackStats
+**/
+MediaUse::PlaybackStats PlayerEngine::getStats(){
+    PlaybackStats stats;
+    FrameCacheStats cacheStats;
+    DecoderPoolStats poolStats;
+    QualityStats qualityStats;
+    int64_t now = av_gettime_relative();
+    stats.framesDecoded = this->statVideoDecoded.load(std::memory_order_relaxed);
+    stats.framesRendered = this->statRendered.load(std::memory_order_relaxed);
+    stats.framesDropped = this->statDropped.load(std::memory_order_relaxed);
+    stats.framesLate = this->statLate.load(std::memory_order_relaxed);
+    stats.avOffset = this->statAvOffset.load(std::memory_order_relaxed);
+    for (int i = 0; i < PLAYBACKSTATS_AV_BUCKETS; i++) {
+        stats.avHistogram[i] = this->statAvHistogram[i].load(std::memory_order_relaxed);
+    }
+    if (stats.framesDecoded) {
+        stats.videoDecodeMs = this->statVideoDecodeUs.load(std::memory_order_relaxed) / 1000.0 / stats.framesDecoded;
+    }
+    if (this->statAudioDecoded.load(std::memory_order_relaxed)) {
+        stats.audioDecodeMs = this->statAudioDecodeUs.load(std::memory_order_relaxed) / 1000.0 / this->statAudioDecoded.load(std::memory_order_relaxed);
+    }
+    if (now - this->statWindowStart >= 500000 || stats.framesDecoded < this->statWindowDecoded) {
+        if (this->statWindowStart > 0 && stats.framesDecoded >= this->statWindowDecoded) {
+            this->statDecodeFps = (stats.framesDecoded - this->statWindowDecoded) * 1000000.0 / (now - this->statWindowStart);
+            this->statRenderFps = (stats.framesRendered - this->statWindowRendered) * 1000000.0 / (now - this->statWindowStart);
+        }
+        this->statWindowStart = now;
+        this->statWindowDecoded = stats.framesDecoded;
+        this->statWindowRendered = stats.framesRendered;
+    }
+    stats.decodeFps = this->statDecodeFps;
+    stats.renderFps = this->statRenderFps;
+    stats.videoPacketQueue = this->videoPacketQueue[this->queueUseIndex.load()].depth();
+    stats.audioDataQueue = this->audioDataQueue[this->queueUseIndex.load()].depth();
+    stats.frameDataQueue = this->statFrameQueue.load(std::memory_order_relaxed);
+    this->videoFrameCache.getStats(cacheStats);
+    this->audioFrameCache.getStats(cacheStats);
+    stats.frameCacheBytes = cacheStats.bytes;
+    stats.frameCacheBudget = cacheStats.budget;
+    stats.frameCacheHitRate = cacheStats.hitRate();
+    stats.ioCacheHitRate = this->getIOStats().hitRate();
+    stats.audioSuspended = this->audioSuspended.load();
+    stats.audioPacketsSkipped = this->statAudioSkipped.load(std::memory_order_relaxed);
+    stats.background = this->isBackground();
+    stats.videoPacketsSkipped = this->statVideoSkipped.load(std::memory_order_relaxed);
+    stats.backgroundSeconds = this->statBackgroundUs.load() / 1000000.0;
+    if (this->backgroundSince.load() >= 0) stats.backgroundSeconds += (now - this->backgroundSince.load()) / 1000000.0;
+    stats.backgroundSavedMs = this->getBackgroundSavedMs();
+    qualityStats = this->qualityController.getStats();
+    stats.qualityLevel = qualityStats.level;
+    stats.qualityLoad = qualityStats.load;
+    stats.seeks = this->seekCount.load();
+    stats.prerollDropped = this->statPrerollDropped.load(std::memory_order_relaxed);
+    stats.seeksCoalesced = this->statSeekCoalesced.load(std::memory_order_relaxed);
+    stats.seeksPreempted = this->statSeekPreempted.load(std::memory_order_relaxed);
+    stats.startupOpenMs = this->startupOpenUs.load() / 1000.0;
+    stats.firstVideoMs = this->startupFirstVideoUs.load() / 1000.0;
+    stats.firstAudioMs = this->startupFirstAudioUs.load() / 1000.0;
+    stats.still = this->isRunning() && (!this->videoStream || this->justCover);
+    stats.stillWakes = this->statStillWakes.load(std::memory_order_relaxed);
+    stats.loops = this->statLoops.load(std::memory_order_relaxed);
+    stats.audioTrack = this->audioStreamIndex;
+    stats.audioTrackSwitches = this->statTrackSwitches.load(std::memory_order_relaxed);
+    stats.subtitleTrack = this->subtitleThread ? this->getSubtitleTrack() : -1;
+    stats.subtitleEvents = this->statSubtitleEvents.load(std::memory_order_relaxed);
+    stats.streams = this->getStreamStats();
+    if (this->decoderPool && this->decoderPoolClient >= 0) {
+        this->decoderPool->getStats(poolStats);
+        for (size_t i = 0; i < poolStats.clients.size(); i++) {
+            if (poolStats.clients[i].client != this->decoderPoolClient) continue;
+            stats.poolPriority = poolStats.clients[i].priority;
+            stats.poolBusy = poolStats.clients[i].busyRatio();
+            stats.poolThroughput = poolStats.clients[i].unitsPerSecond();
+        }
+    }
+    return stats;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置离线模式（尽快处理完整个文件），avOpen之前调用，与直播模式互斥
+*                视频帧不等待主时钟、只有视频时不按帧率定时，音频输出应为不限速的实现（如WavAudioSink）
+* @Param:        @offline bool 是否开启
+* @Return:       void
+**/
+void PlayerEngine::setOfflineMode(bool offline){
+    this->offlineMode = offline;
+    if(offline) this->liveMode = false;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否为离线模式
+* @Param:        void
+* @Return:       bool
+**/
+bool PlayerEngine::isOfflineMode(){
+    return this->offlineMode;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        进入或离开后台模式（窗口不可见时省电）：音频照常播放，视频packet丢弃（或只保留关键帧），
+*                不再解码、转换和上传；离开后台时跳转到当前音频时钟，视频从该位置重新解码同步。
+*                没有音频流（视频自身就是时钟）、只有封面或离线模式时不进入后台
+* @Param:        @background bool 是否进入后台
+*                @mode uint8_t CPPPLAYER_BACKGROUND_DISCARD或CPPPLAYER_BACKGROUND_KEYFRAME
+* @Return:       bool 状态改变返回true
+**/
+bool PlayerEngine::setBackground(bool background, uint8_t mode){
+    int64_t since = 0;
+    if (background) {
+        if (!this->isRunning() || !this->audioStream || !this->videoStream || this->justCover || this->offlineMode) return false;
+        if (mode != CPPPLAYER_BACKGROUND_KEYFRAME) mode = CPPPLAYER_BACKGROUND_DISCARD;
+        if (this->backgroundMode.exchange(mode) == CPPPLAYER_BACKGROUND_OFF) {
+            this->backgroundSince.store(av_gettime_relative());
+            CPPPLAYER_TRACE_INSTANT("background", this->audioPts.load());
+        }
+        return true;
+    }
+    if (this->backgroundMode.exchange(CPPPLAYER_BACKGROUND_OFF) == CPPPLAYER_BACKGROUND_OFF) return false;
+    since = this->backgroundSince.exchange(-1);
+    if (since >= 0) this->statBackgroundUs.fetch_add(av_gettime_relative() - since);
+    CPPPLAYER_TRACE_INSTANT("foreground", this->audioPts.load());
+    this->setCurrentPts(std::pair<int64_t, AVRational>(this->loopWrapPts(this->audioPts.load()), AVRational{ 1,AV_TIME_BASE }));//视频跳转到音频时钟
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置快速启动（avOpen之前调用）：缩短探测、不输出媒体信息，第一帧解码后立即显示，
+*                音频只预缓冲少量数据就开始播放，其余缓冲在播放中补满
+* @Param:        @fast bool 是否开启
+* @Return:       void
+**/
+void PlayerEngine::setFastStart(bool fast){
+    this->fastStart = fast;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否为快速启动
+* @Param:        void
+* @Return:       bool
+**/
+bool PlayerEngine::isFastStart(){
+    return this->fastStart;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置无缝循环，播放中也可以切换：读到文件末尾时直接接上文件开头，不经过播放结束和avRestart的跳转，
+*                直播和离线模式不循环（仍然通知播放结束）
+* @Param:        @loop bool 是否开启
+* @Return:       void
+**/
+void PlayerEngine::setSeamlessLoop(bool loop){
+    this->seamlessLoop.store(loop);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否为无缝循环
+* @Param:        void
+* @Return:       bool
+**/
+bool PlayerEngine::isSeamlessLoop(){
+    return this->seamlessLoop.load();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        无缝循环后时间轴上的pts折回文件内的时间（循环前或未循环时不变）
+* @Param:        @pts int64_t 时间轴上的pts（us）
+* @Return:       int64_t
+**/
+int64_t PlayerEngine::loopWrapPts(int64_t pts){
+    int64_t period = this->loopPeriod.load();
+    int64_t start = this->loopStart.load();
+    if (period <= 0 || pts == INT64_MAX || pts < start + period) return pts;
+    return start + (pts - start) % period;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        无缝循环的衔接（解封装任务读到文件末尾时调用）：取出音频解码器中剩余的帧，给视频线程放入排空标记，
+*                解封装跳回文件开头，之后读取的packet时间戳接在这一遍的末尾
+* @Param:        void
+* @Return:       bool 没有开启无缝循环或无法衔接时返回false（按播放结束处理）
+**/
+bool PlayerEngine::readLoopWrap(){
+    int64_t start = this->formatContext->start_time != AV_NOPTS_VALUE ? this->formatContext->start_time : 0;
+    int64_t pts = 0;
+    int64_t end = 0;
+    AVPacket* marker = nullptr;
+    AVDataInfo pcm;
+    if (!this->seamlessLoop.load() || this->liveMode || this->offlineMode) return false;
+    if (this->audioStream && !this->audioSuspended.load() && avcodec_send_packet(this->audioCodecContext, nullptr) == 0) {//末尾的采样不丢失
+        while (avcodec_receive_frame(this->audioCodecContext, this->readFrame) == 0) {
+            if (this->readFrame->pts == AV_NOPTS_VALUE) continue;
+            pts = av_rescale_q(this->readFrame->pts, this->audioTimeBase, AVRational{ 1, AV_TIME_BASE });
+            end = pts + av_rescale(this->readFrame->nb_samples, AV_TIME_BASE, this->readFrame->sample_rate);
+            if (end <= this->audioSkipUntil.load()) continue;
+            if (this->audioConverter.convert(this->readFrame, pts, pcm) != FRAMECONVERTER_OK) continue;
+            this->loopTailEnd = std::max(this->loopTailEnd, end);
+            this->audioDataQueue[this->queueUseIndex.load()].push(pcm);
+            pcm = AVDataInfo();
+        }
+    }
+    if (this->audioStream) avcodec_flush_buffers(this->audioCodecContext);
+    if (this->loopTailEnd <= start + this->loopOffset.load()) return false;//这一遍没有读到任何内容
+    if (avformat_seek_file(this->formatContext, -1, INT64_MIN, start, INT64_MAX, 0) < 0) {
+        this->messagePrint("ERROR::FFMPEG::LOOP_SEEK_FAILED", CPPPLAYER_COLOR_RED);
+        return false;
+    }
+    this->loopStart.store(start);
+    this->loopPeriod.store(this->loopTailEnd - start - this->loopOffset.load());
+    this->loopOffset.store(this->loopTailEnd - start);
+    this->readVideoDts = INT64_MIN;//下一遍的dts可能小于这一遍最后的dts（B帧的负dts）
+    this->readVideoDtsFloor = INT64_MIN;
+    if (this->videoStream && !this->justCover) {//视频线程解码到标记时取出解码器中剩余的帧并刷新解码器
+        marker = av_packet_alloc();
+        if (marker) this->videoPacketQueue[this->queueUseIndex.load()].push(marker);
+    }
+    this->statLoops.fetch_add(1, std::memory_order_relaxed);
+    CPPPLAYER_TRACE_INSTANT("seamless loop", this->loopTailEnd);
+    this->messagePrint("INFO::FFMPEG::SEAMLESS_LOOP", CPPPLAYER_COLOR_GREEN);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        文件中的全部音轨（avOpen之后调用）
+* @Param:        void
+* @Return:       std::vector<AudioTrackInfo>
+**/
+std::vector<AudioTrackInfo> PlayerEngine::getAudioTracks(){
+    std::vector<AudioTrackInfo> tracks;
+    AudioTrackInfo track;
+    AVStream* stream = nullptr;
+    AVDictionaryEntry* m = nullptr;
+    const AVCodecDescriptor* descriptor = nullptr;
+    int selected = this->getAudioTrack();
+    if (!this->formatContext) return tracks;
+    for (unsigned int i = 0; i < this->formatContext->nb_streams; i++) {
+        stream = this->formatContext->streams[i];
+        if (stream->codecpar->codec_type != AVMEDIA_TYPE_AUDIO) continue;
+        track = AudioTrackInfo();
+        track.streamIndex = (int)i;
+        m = av_dict_get(stream->metadata, "language", nullptr, 0);
+        if (m) track.language = m->value;
+        m = av_dict_get(stream->metadata, "title", nullptr, 0);
+        if (m) track.title = m->value;
+        descriptor = avcodec_descriptor_get(stream->codecpar->codec_id);
+        if (descriptor) track.codec = descriptor->name;
+        track.sampleRate = stream->codecpar->sample_rate;
+        track.channels = stream->codecpar->ch_layout.nb_channels;
+        track.selected = ((int)i == selected);
+        tracks.push_back(track);
+    }
+    return tracks;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        每个流的解封装统计（avOpen之后调用），丢弃的流在打开时和切换音轨时设置
+* @Param:        void
+* @Return:       std::vector<MediaUse::StreamStats>
+**/
+std::vector<MediaUse::StreamStats> PlayerEngine::getStreamStats(){
+    std::vector<StreamStats> streams;
+    StreamStats item;
+    AVStream* stream = nullptr;
+    const char* type = nullptr;
+    if (!this->formatContext) return streams;
+    for (unsigned int i = 0; i < this->formatContext->nb_streams; i++) {
+        stream = this->formatContext->streams[i];
+        item = StreamStats();
+        item.index = (int)i;
+        type = av_get_media_type_string(stream->codecpar->codec_type);
+        item.type = (stream->disposition & AV_DISPOSITION_ATTACHED_PIC) ? "cover" : (type ? type : "unknown");
+        item.discarded = stream->discard >= AVDISCARD_ALL;
+        if (i < CPPPLAYER_STREAM_STATS_MAX) {
+            item.packets = this->statStreamPackets[i].load(std::memory_order_relaxed);
+            item.bytes = this->statStreamBytes[i].load(std::memory_order_relaxed);
+        }
+        streams.push_back(item);
+    }
+    return streams;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        当前（或已请求切换到）的音轨
+* @Param:        void
+* @Return:       int 流下标，没有音频时为-1
+**/
+int PlayerEngine::getAudioTrack(){
+    std::lock_guard<std::mutex> lock(this->audioTrackMutex);
+    if (this->audioTrackPendingIndex >= 0) return this->audioTrackPendingIndex;
+    return this->audioStreamIndex;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        播放中切换音轨，不重新打开文件、视频不跳转。这里只记录请求，新解码器由解封装任务在两次读取之间打开并换上，
+*                不阻塞调用线程（界面线程），从当前音频时钟处重新读取新音轨，新音轨接在音频输出已写入的位置之后
+*                （采样率不同时重采样到原采样率）。连续调用时只保留最后一次请求；需要文件打开时就有音频流
+* @Param:        @streamIndex int getAudioTracks中的streamIndex
+* @Return:       bool 请求成功返回true（已经是该音轨时也返回true），新音轨的解码器打开失败时保持原音轨
+**/
+bool PlayerEngine::setAudioTrack(int streamIndex){
+    if (!this->formatContext || !this->audioStream || this->liveMode || !(this->decoderStatus.load() & (CPPPLAYER_DECODER_EOF | CPPPLAYER_DECODER_ING | CPPPLAYER_DECODER_BUSY))) {
+        return false;
+    }
+    if (streamIndex < 0 || streamIndex >= (int)this->formatContext->nb_streams ||
+        this->formatContext->streams[streamIndex]->codecpar->codec_type != AVMEDIA_TYPE_AUDIO) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->audioTrackMutex);//audioStreamIndex由解封装任务在换上音轨时修改
+        if (streamIndex == this->audioStreamIndex) {//切换回当前音轨时只需要取消未换上的请求
+            this->audioTrackPendingIndex = -1;
+            this->audioTrackReady.store(false);
+            return true;
+        }
+        this->audioTrackPendingIndex = streamIndex;
+        this->audioTrackReady.store(true);
+    }
+    this->decoderStatus_cv.notify_all();
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        文件中的全部字幕流（avOpen之后调用）
+* @Param:        void
+* @Return:       std::vector<SubtitleTrackInfo>
+**/
+std::vector<SubtitleTrackInfo> PlayerEngine::getSubtitleTracks(){
+    std::vector<SubtitleTrackInfo> tracks;
+    SubtitleTrackInfo track;
+    AVStream* stream = nullptr;
+    AVDictionaryEntry* m = nullptr;
+    const AVCodecDescriptor* descriptor = nullptr;
+    int selected = this->getSubtitleTrack();
+    if (!this->formatContext) return tracks;
+    for (unsigned int i = 0; i < this->formatContext->nb_streams; i++) {
+        stream = this->formatContext->streams[i];
+        if (stream->codecpar->codec_type != AVMEDIA_TYPE_SUBTITLE) continue;
+        track = SubtitleTrackInfo();
+        track.streamIndex = (int)i;
+        m = av_dict_get(stream->metadata, "language", nullptr, 0);
+        if (m) track.language = m->value;
+        m = av_dict_get(stream->metadata, "title", nullptr, 0);
+        if (m) track.title = m->value;
+        descriptor = avcodec_descriptor_get(stream->codecpar->codec_id);
+        if (descriptor) {
+            track.codec = descriptor->name;
+            track.bitmap = (descriptor->props & AV_CODEC_PROP_BITMAP_SUB) != 0;
+        }
+        track.selected = ((int)i == selected);
+        tracks.push_back(track);
+    }
+    return tracks;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        当前（或已请求切换到）的字幕流
+* @Param:        void
+* @Return:       int 流下标，不显示字幕时为-1
+**/
+int PlayerEngine::getSubtitleTrack(){
+    return this->subtitleTrackRequest.load();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        播放中切换或关闭字幕，解封装任务在两次读取之间换上，不跳转，新字幕流从之后读到的packet开始显示。
+*                需要设置了字幕输出（字幕线程在运行）
+* @Param:        @streamIndex int getSubtitleTracks中的streamIndex，-1为关闭字幕
+* @Return:       bool 请求成功返回true
+**/
+bool PlayerEngine::setSubtitleTrack(int streamIndex){
+    if (!this->formatContext || !this->subtitleThread) return false;
+    if (streamIndex != -1 && (streamIndex < 0 || streamIndex >= (int)this->formatContext->nb_streams ||
+        this->formatContext->streams[streamIndex]->codecpar->codec_type != AVMEDIA_TYPE_SUBTITLE)) {
+        return false;
+    }
+    this->subtitleTrackRequest.store(streamIndex);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        为音频流创建并打开解码器
+* @Param:        @stream AVStream*
+* @Return:       AVCodecContext* 失败返回nullptr
+**/
+AVCodecContext* PlayerEngine::audioDecoderOpen(AVStream* stream){
+    int ret = 0;
+    AVCodecContext* context = nullptr;
+    const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!codec) {
+        this->messagePrint("ERROR::FFMPEG::CAN_NOT_FIND_AUDIO_DECODER", CPPPLAYER_COLOR_RED);
+        return nullptr;
+    }
+    context = avcodec_alloc_context3(codec);
+    if (!context) {
+        this->messagePrint("ERROR::FFMPEG::AVCODEC_ALLOC_CONTEXT3", CPPPLAYER_COLOR_RED);
+        return nullptr;
+    }
+    ret = avcodec_parameters_to_context(context, stream->codecpar);
+    if (ret < 0) {
+        this->messagePrint("ERROR::FFMPEG::CAN_NOT_COPY_PARAMETERS_TO_AUDIO_CODEC_CONTEXT", CPPPLAYER_COLOR_RED);
+        ffmpegErrorPrint(ret);
+        avcodec_free_context(&context);
+        return nullptr;
+    }
+    context->thread_count = this->decoderPool ? 1 : 8;
+    ret = avcodec_open2(context, nullptr, nullptr);
+    if (ret != 0) {
+        this->messagePrint("ERROR::FFMPEG::CAN_NOT_OPEN_AUDIO_DECODER", CPPPLAYER_COLOR_RED);
+        avcodec_free_context(&context);
+        return nullptr;
+    }
+    context->pkt_timebase = stream->time_base;
+    return context;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        换上setAudioTrack请求的音轨（解封装任务调用）：打开新音轨的解码器，交换解码器和转换，旧音轨改为丢弃，
+*                音频帧队列放入拼接标记，解封装退回到音频时钟处重新读取
+* @Param:        void
+* @Return:       bool 换上了新音轨返回true
+**/
+bool PlayerEngine::readAudioTrackSwitch(){
+    AVCodecContext* context = nullptr;
+    AVStream* stream = nullptr;
+    int index = -1;
+    int64_t splicePts = 0;
+    int64_t target = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->audioTrackMutex);
+        index = this->audioTrackPendingIndex;
+        this->audioTrackPendingIndex = -1;
+        this->audioTrackReady.store(false);
+    }
+    if (index < 0 || index == this->audioStreamIndex) return false;
+    stream = this->formatContext->streams[index];
+    context = this->audioDecoderOpen(stream);
+    if (!context) return false;//打开失败时保持原音轨
+    if (this->audioConverter.open(context, this->audioSampleRate) != 0) {//输出采样率保持不变，音频输出不需要重新打开
+        this->messagePrint("ERROR::FFMPEG::SWR_INIT", CPPPLAYER_COLOR_RED);
+        this->audioConverter.open(this->audioCodecContext, this->audioSampleRate);
+        avcodec_free_context(&context);
+        return false;
+    }
+    this->audioStream->discard = AVDISCARD_ALL;
+    stream->discard = AVDISCARD_DEFAULT;
+    avcodec_free_context(&this->audioCodecContext);
+    this->audioCodecContext = context;
+    this->audioStream = stream;
+    {
+        std::lock_guard<std::mutex> lock(this->audioTrackMutex);
+        this->audioStreamIndex = index;
+    }
+    this->audioTimeBase = stream->time_base;
+    while (!this->audioParked.empty()) {//挂起期间保留的是旧音轨的packet
+        av_packet_free(&this->audioParked.front());
+        this->audioParked.pop_front();
+    }
+    this->audioParkedFlush = false;
+    this->audioFrameCache.clear();
+
+    //音频线程丢弃旧音轨还没写入的帧，直到拼接标记；新音轨从音频时钟开始解码，之前的帧不转换
+    splicePts = this->audioPts.load();
+    this->audioSkipUntil.store(splicePts);
+    this->audioSplicing.store(true);
+    if (!this->liveMode) this->readVideoDtsFloor = this->readVideoDts;//退回重新读取时跳过已经读过的视频packet
+    this->audioDataQueue[this->queueUseIndex.load()].push(AVDataInfo());
+    target = av_rescale_q(splicePts - this->loopOffset.load(), AVRational{ 1, AV_TIME_BASE }, stream->time_base);
+    if (avformat_seek_file(this->formatContext, index, INT64_MIN, target, target, 0) < 0 &&
+        avformat_seek_file(this->formatContext, -1, INT64_MIN, splicePts - this->loopOffset.load(), splicePts - this->loopOffset.load(), 0) < 0) {
+        this->messagePrint("ERROR::FFMPEG::AUDIO_TRACK_SEEK_FAILED", CPPPLAYER_COLOR_RED);//无法退回时新音轨从当前读取位置开始
+    }
+    this->statTrackSwitches.fetch_add(1, std::memory_order_relaxed);
+    CPPPLAYER_TRACE_INSTANT("audio track", splicePts);
+    this->messagePrint("INFO::FFMPEG::AUDIO_TRACK_SWITCHED", CPPPLAYER_COLOR_GREEN);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        从音频帧队列取出一帧（音频线程调用）。切换音轨时丢弃旧音轨还没写入的帧直到拼接标记（空帧），
+*                之后新音轨的帧裁剪到已写入的位置，接上后没有空隙也不重叠
+* @Param:        @index uint8_t 队列下标
+*                @frame (MediaUse::AVDataInfo&) 输出
+* @Return:       bool 队列中没有可以输出的帧返回false
+**/
+bool PlayerEngine::audioPop(uint8_t index, MediaUse::AVDataInfo& frame){
+    while (!this->audioDataQueue[index].empty()) {
+        frame = this->audioDataQueue[index].pop();
+        if (!frame.data) {//拼接标记，之后是新音轨的帧
+            this->audioSplicing.store(false);
+            this->audioSpliceFrom = this->audioWrittenEnd;
+            continue;
+        }
+        if (this->audioSplicing.load()) {
+            frame.clear();
+            continue;
+        }
+        if (this->audioSpliceFrom != INT64_MIN) {
+            if (frame.pts + (int64_t)(frame.size / 4) * AV_TIME_BASE / this->audioSampleRate <= this->audioSpliceFrom) {
+                frame.clear();
+                continue;
+            }
+            AudioFrameConverter::trimFront(frame, this->audioSpliceFrom, this->audioSampleRate);
+            this->audioSpliceFrom = INT64_MIN;
+        }
+        this->audioWrittenEnd = frame.pts + (int64_t)(frame.size / 4) * AV_TIME_BASE / this->audioSampleRate;
+        return true;
+    }
+    return false;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        记录启动过程中的一个时间点（相对于avOpen开始），每次打开只记录第一次
+* @Param:        @mark (std::atomic<int64_t>&) startupXxxUs之一
+*                @name (const char*) 追踪中显示的名称
+* @Return:       void
+**/
+void PlayerEngine::startupMark(std::atomic<int64_t>& mark, const char* name){
+    int64_t expected = -1;
+    (void)name;
+    if (mark.compare_exchange_strong(expected, av_gettime_relative() - this->startupClock.load())) {
+        CPPPLAYER_TRACE_INSTANT(name, mark.load());
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        开启或关闭解码过载时的自适应画质（默认开启），关闭后下一帧恢复原画质
+* @Param:        @enable bool
+* @Return:       void
+**/
+void PlayerEngine::setAdaptiveQuality(bool enable){
+    this->qualityController.setEnabled(enable);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否开启自适应画质
+* @Param:        void
+* @Return:       bool
+**/
+bool PlayerEngine::isAdaptiveQuality(){
+    return this->qualityController.isEnabled();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        自适应画质的当前等级、负载和最近的调整记录
+* @Param:        void
+* @Return:       MediaUse::QualityStats
+**/
+MediaUse::QualityStats PlayerEngine::getQualityStats(){
+    return this->qualityController.getStats();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否处于后台模式
+* @Param:        void
+* @Return:       bool
+**/
+bool PlayerEngine::isBackground(){
+    return this->backgroundMode.load() != CPPPLAYER_BACKGROUND_OFF;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        后台模式节省的解码时间估计：丢弃的视频packet数乘以每帧平均解码（含转换）耗时
+* @Param:        void
+* @Return:       double 单位ms，自打开文件起累计
+**/
+double PlayerEngine::getBackgroundSavedMs(){
+    uint64_t decoded = this->statVideoDecoded.load(std::memory_order_relaxed);
+    if (!decoded) return 0;
+    return this->statVideoSkipped.load(std::memory_order_relaxed) * (this->statVideoDecodeUs.load(std::memory_order_relaxed) / 1000.0 / decoded);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        离线处理的吞吐量报告和运行统计，处理中调用时按当前时刻计算，应在调用getStats的线程调用
+* @Param:        void
+* @Return:       std::string
+**/
+std::string PlayerEngine::getOfflineReport(){
+    return this->offlineSummary() + "\n" + this->getStats().toString();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        查询跳转目标之后的连续缓存区间，音视频都被覆盖且区间不短于CPPPLAYER_FRAMECACHE_MIN_SPAN时命中
+* @Param:        @targetPts int64_t 跳转目标（AV_TIME_BASE）
+*                @audioStart (int64_t&) 输出音频缓存区间的起点
+* @Return:       int64_t 解码器需要继续解码的位置（缓存区间末尾的下一个pts），未命中返回-1
+**/
+int64_t PlayerEngine::frameCacheCoverage(int64_t targetPts, int64_t& audioStart){
+    int64_t resume = INT64_MAX;
+    int64_t end = -1;
+    int64_t start = 0;
+    if (this->liveMode || this->justCover || !this->videoFrameCache.enabled() || this->loopPeriod.load() > 0) return -1;//无缝循环后缓存中是时间轴上的pts
+    if (this->videoStream) {
+        end = this->videoFrameCache.coverage(targetPts, (int64_t)(2.5 * AV_TIME_BASE / this->videoAvgFrame), start);
+        if (end < 0) return -1;
+        resume = end + 1;
+    }
+    if (this->audioStream) {
+        end = this->audioFrameCache.coverage(targetPts, CPPPLAYER_FRAMECACHE_AUDIO_GAP, audioStart);
+        if (end < 0) return -1;
+        resume = std::min(resume, end + 1);
+    }
+    if (resume == INT64_MAX || resume - targetPts < CPPPLAYER_FRAMECACHE_MIN_SPAN) return -1;
+    return resume;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        打印ffmpeg错误代码对应的字符串
+* @Param:        @errEnum int ffmpeg错误代码
+* @Return:       void
+**/
+void PlayerEngine::ffmpegErrorPrint(int errEnum){
+#ifdef CPPPLAYER_DEBUG
+    char buf[1024] = { 0 };
+    if (this->log.getLevel() > ASYNCLOGGER_LEVEL_ERROR) return;
+    av_make_error_string(buf, sizeof(buf) - 1, errEnum);
+    this->log.write(ASYNCLOGGER_LEVEL_ERROR, buf);
+#endif
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        输出运行信息
+* @Param:        @str (const char *) 要打印的字符串
+*                @color (const char *) 控制台字体颜色，详见CPPPLAYER_DEFINE
+* @Return:       void
+**/
+void PlayerEngine::messagePrint(const char* str, const char* color){
+#ifdef CPPPLAYER_DEBUG
+    this->log.write(AsyncLogger::levelOf(str), str);
+    //cout << color << str << CPPPLAYER_COLOR_RESET << endl;
+#endif
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        按自适应画质的当前等级设置解码器和转换（在解码线程调用，等级逐级累加）：
+*                FAST_SCALE起转换用SWS_FAST_BILINEAR，SKIP_LOOP起不做去块滤波，SKIP_IDCT起非参考帧不做IDCT，
+*                SKIP_NONREF起不解码非参考帧（skip_frame按packet在videoDecoderOneFrame中设置），HALF_SIZE时以一半分辨率转换再放大（输出尺寸不变，VideoSink无需重建）
+* @Param:        @converter (MediaUse::VideoFrameConverter&) 本次解码使用的转换
+* @Return:       void
+**/
+void PlayerEngine::qualityApply(MediaUse::VideoFrameConverter& converter){
+    int level = this->qualityController.getLevel();
+    converter.setQuality(level >= QUALITYCONTROLLER_LEVEL_FAST_SCALE, level >= QUALITYCONTROLLER_LEVEL_HALF_SIZE ? 2 : 1);
+    if (level == this->qualityApplied) return;
+    this->videoCodecContext->skip_loop_filter = level >= QUALITYCONTROLLER_LEVEL_SKIP_LOOP ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+    this->videoCodecContext->skip_idct = level >= QUALITYCONTROLLER_LEVEL_SKIP_IDCT ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+    CPPPLAYER_TRACE_INSTANT(QualityStats::levelName(level), this->audioPts.load());
+    this->qualityApplied = level;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        对输入的视频流packet进行解码，并将得到的图像数据入队
+* @Param:        @converter (MediaUse::VideoFrameConverter&) 图像格式转换
+*                @packet (AVPacket*&) 视频流的一个packet
+*                @frame (AVFrame*&) 临时帧指针
+*                @frameDataQueue (std::queue<MediaUse::AVDataInfo>) 图像队列，解码后的图像入队于此
+* @Return:       bool 成功解码一帧图像返回true
+**/
+bool PlayerEngine::videoDecoderOneFrame(MediaUse::VideoFrameConverter& converter, AVPacket*& packet, AVFrame*& frame, std::queue<MediaUse::AVDataInfo>& frameDataQueue){
+    int ret = -1;
+    AVDataInfo rgb;
+    bool successGet = false;
+    int decodedCount = 0;
+    int64_t decodeStart = av_gettime_relative();
+    int64_t lastPts = AV_NOPTS_VALUE;
+    uint64_t generation = this->seekGeneration.load();
+    AVDiscard skipFrame = AVDISCARD_DEFAULT;
+    bool loopDrain = packet && !packet->data && !packet->size;//无缝循环的排空标记
+    this->qualityApply(converter);
+    //跳转后目标之前的packet不会显示，其中的非参考帧不需要解码；画质降级时同样不解码非参考帧
+    if (this->qualityApplied >= QUALITYCONTROLLER_LEVEL_SKIP_NONREF ||
+        (packet && packet->pts != AV_NOPTS_VALUE && av_rescale_q(packet->pts, this->videoTimeBase, AVRational{ 1, AV_TIME_BASE }) < this->videoSkipUntil.load())) {
+        skipFrame = AVDISCARD_NONREF;
+    }
+    this->videoCodecContext->skip_frame = skipFrame;
+    this->videoIsDecoding = true;
+    {
+        CPPPLAYER_TRACE_ZONE("video send_packet");
+        ret = avcodec_send_packet(this->videoCodecContext, packet);//向解码器发送packet
+    }
+    av_packet_free(&packet);//释放packet资源
+    packet = nullptr;
+    if (ret != 0) {
+        this->messagePrint("ERROR::FFMPEG::SEND_PACKET_ERROR", CPPPLAYER_COLOR_RED);
+    }
+    else {
+        while (true) {
+            {
+                CPPPLAYER_TRACE_ZONE("video receive_frame");
+                ret = avcodec_receive_frame(this->videoCodecContext, frame);//循环读取帧数据
+            }
+            if (ret != 0) {
+                this->messagePrint("ERROR::FFMPEG::OPENGL::RECEIVE_FRAME", CPPPLAYER_COLOR_RED);
+                this->ffmpegErrorPrint(ret);
+                break;
+            }
+            this->messagePrint("DEBUG::FFMPEG::OPENGL::RECEIVE_A_FRAME", CPPPLAYER_COLOR_GREEN);
+            if (this->seekGeneration.load() != generation) {//有新的跳转目标，剩下的帧都会被刷新，不再转换（解封装任务随后刷新解码器）
+                break;
+            }
+            if (frame->pts != AV_NOPTS_VALUE && av_rescale_q(frame->pts, this->videoTimeBase, AVRational{ 1, AV_TIME_BASE }) < this->videoSkipUntil.load()) {
+                if (this->seekExact.load()) this->statPrerollDropped.fetch_add(1, std::memory_order_relaxed);
+                continue;//已由帧缓存提供的帧或跳转目标之前的帧不再转换
+            }
+            {
+                CPPPLAYER_TRACE_ZONE_ARG("sws_scale", av_rescale_q(frame->pts, this->videoTimeBase, AVRational{ 1, AV_TIME_BASE }));
+                ret = converter.convert(frame, this->videoWidth, this->videoHeight,
+                    av_rescale_q(frame->pts, this->videoTimeBase, AVRational{ 1, AV_TIME_BASE }), rgb);//图像格式转换
+            }
+            if (ret == FRAMECONVERTER_ERROR_CONTEXT) {
+                this->messagePrint("ERROR::FFMPEG::SWS_GETCACHED_CONTEXT", CPPPLAYER_COLOR_RED);
+                continue;
+            }
+            if (ret == FRAMECONVERTER_ERROR_ALLOC) {
+                this->messagePrint("ERROR::FFMPEG::RGB_BUFFER_ALLOC_FAILED", CPPPLAYER_COLOR_RED);
+                continue;
+            }
+            if (ret != FRAMECONVERTER_OK) {
+                this->messagePrint("ERROR::FFMPEG::SWS_SCALE", CPPPLAYER_COLOR_RED);
+                continue;
+            }
+            //得到的图像数据入队
+            lastPts = rgb.pts;
+            frameDataQueue.push(rgb);
+            rgb = AVDataInfo();
+            successGet = true;
+            decodedCount++;
+        }
+    }
+    if (loopDrain) {//剩余的帧已全部取出，刷新后解码器才能接收文件开头的packet
+        avcodec_flush_buffers(this->videoCodecContext);
+    }
+    this->videoIsDecoding = false;
+    if (decodedCount) {
+        int64_t now = av_gettime_relative();
+        this->statVideoDecoded.fetch_add(decodedCount, std::memory_order_relaxed);
+        this->statVideoDecodeUs.fetch_add(now - decodeStart, std::memory_order_relaxed);
+        if (lastPts != AV_NOPTS_VALUE) this->qualityController.update(now - decodeStart, lastPts, now);
+    }
+    return successGet;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        初始化各个类成员
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::avInit(){
+    this->videoShouldFlush = false;
+    this->audioShouldFlush = false;
+    this->videoReady = false;
+    this->audioReady = false;
+    this->audioIsWaiting = false;
+    this->playerShouldEnd = true;
+    this->justCover = false;
+    this->videoIsDecoding = false;
+    this->videoEnd = false;
+    this->audioEnd = false;
+    this->decoderStatus = CPPPLAYER_DECODER_UNKNOW;
+    this->playerStatus = CPPPLAYER_AV_UNKNOW;
+    this->videoPts.store(0);
+    this->audioPts.store(0);
+    this->liveStartClock.store(-1);
+    this->liveStartPts.store(0);
+    this->liveAddedLatency.store(0);
+    this->liveSenderClock.store(AV_NOPTS_VALUE);
+    this->liveEndToEnd.store(-1);
+    this->liveCatchUp.store(false);
+    this->cacheServeFrom.store(-1);
+    this->cacheServeUntil.store(-1);
+    this->videoSkipUntil.store(INT64_MIN);
+    this->audioSkipUntil.store(INT64_MIN);
+    this->seekExact.store(false);
+    this->statPrerollDropped.store(0);
+    this->seekCount.store(0);
+    this->seekFromCache.store(0);
+    this->seekRequestPts.store(0);
+    this->seekGeneration.store(0);
+    this->seekApplied.store(0);
+    this->seekCompleted.store(0);
+    this->statSeekCoalesced.store(0);
+    this->statSeekPreempted.store(0);
+    this->loopA.store(-1);
+    this->loopB.store(-1);
+    this->statVideoDecoded.store(0);
+    this->statVideoDecodeUs.store(0);
+    this->statAudioDecoded.store(0);
+    this->statAudioDecodeUs.store(0);
+    this->statAudioSkipped.store(0);
+    this->statVideoSkipped.store(0);
+    this->startupClock.store(av_gettime_relative());
+    this->startupOpenUs.store(-1);
+    this->startupFirstVideoUs.store(-1);
+    this->startupFirstAudioUs.store(-1);
+    this->statBackgroundUs.store(0);
+    this->statRendered.store(0);
+    this->statDropped.store(0);
+    this->statLate.store(0);
+    this->statAvOffset.store(0);
+    for (int i = 0; i < PLAYBACKSTATS_AV_BUCKETS; i++) {
+        this->statAvHistogram[i].store(0);
+    }
+    this->statFrameQueue.store(0);
+    this->statWindowStart = 0;
+    this->statWindowDecoded = 0;
+    this->statWindowRendered = 0;
+    this->statDecodeFps = 0;
+    this->statRenderFps = 0;
+    this->videoAvgFrame = 0;
+    this->audioSampleRate = 0;
+    this->videoStreamIndex = -1;
+    this->audioStreamIndex = -1;
+    this->subtitleStreamIndex = -1;
+    this->videoWidth = 0;
+    this->videoHeight = 0;
+    this->duration = std::pair<int64_t, AVRational>(0, AVRational{ 1,AV_TIME_BASE });
+    this->offset = std::pair<int64_t, AVRational>(5, AVRational{ 1,1 });
+    this->videoTimeBase = AVRational{ 1,AV_TIME_BASE };
+    this->audioTimeBase = AVRational{ 1,AV_TIME_BASE };
+    this->formatContext = nullptr;
+    this->videoStream = nullptr;
+    this->audioStream = nullptr;
+    this->videoCodecContext = nullptr;
+    this->audioCodecContext = nullptr;
+    this->mediaIO = nullptr;
+    this->ioStatBytesRead.store(0);
+    this->ioStatBytesDelivered.store(0);
+    this->ioStatSyscalls.store(0);
+    this->ioStatCacheHits.store(0);
+    this->ioStatCacheMisses.store(0);
+    this->ioStatPrefetched.store(0);
+    this->ioSource = nullptr;
+    this->ioThrottle = nullptr;
+    this->ffmpegThread = nullptr;
+    this->videoThread = nullptr;
+    this->audioThread = nullptr;
+    this->videoDecodeThread = nullptr;
+    this->subtitleThread = nullptr;
+    this->decoderPoolClient = -1;
+    this->readPacket = nullptr;
+    this->readFrame = nullptr;
+    this->readPrepared = false;
+    this->readPacketPending = false;
+    this->readAtEof = false;
+    this->readEndNotified = false;
+    this->audioSuspended.store(false);
+    this->audioParkedFlush = false;
+    this->seekTargetPts.store(0);
+    this->backgroundMode.store(CPPPLAYER_BACKGROUND_OFF);
+    this->backgroundSince.store(-1);
+    this->qualityApplied = QUALITYCONTROLLER_LEVEL_FULL;
+    this->readSeekWaiting = false;
+    this->videoTaskFrame = nullptr;
+    this->videoTaskPacketSent = false;
+    this->videoTaskCoverDrained = false;
+    this->videoTaskBusy.store(false);
+    this->videoTaskShouldFlush.store(false);
+    this->stillWakePending = false;
+    this->statStillWakes.store(0);
+    this->loopOffset.store(0);
+    this->loopStart.store(0);
+    this->loopPeriod.store(0);
+    this->loopTailEnd = INT64_MIN;
+    this->statLoops.store(0);
+    this->audioTrackPendingIndex = -1;
+    this->audioTrackReady.store(false);
+    this->audioSplicing.store(false);
+    this->readVideoDts = INT64_MIN;
+    this->readVideoDtsFloor = INT64_MIN;
+    this->audioSpliceFrom = INT64_MIN;
+    this->audioWrittenEnd = INT64_MIN;
+    this->statTrackSwitches.store(0);
+    this->subtitleTrackRequest.store(-1);
+    this->readSubtitlePts = INT64_MIN;
+    this->statSubtitleEvents.store(0);
+    for (int i = 0; i < CPPPLAYER_STREAM_STATS_MAX; i++) {
+        this->statStreamPackets[i].store(0);
+        this->statStreamBytes[i].store(0);
+    }
+    this->queueUseIndex = 0;
+    this->queueFlushIndex = 1;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        创建自定义IO，设置了限速读取时由播放器创建读取源并外包ThrottledSource，
+*                只有块缓存模式带块缓存，默认和mmap模式每次读取都经过限速
+* @Param:        void
+* @Return:       bool 成功返回true，失败时需要调用ioClose
+**/
+bool PlayerEngine::ioOpen(){
+    std::string localPath = this->path;
+    MediaIO* io = new MediaIO;
+    bool ok = false;
+    if (this->ioThrottleLatency <= 0 && this->ioThrottleBandwidth <= 0) {
+        ok = io->open(this->path, this->ioMode, this->ioBlockSize, this->ioBlockCount, this->ioPrefetchBlocks);
+    }
+    else {
+        if (localPath.compare(0, 5, "file:") == 0) localPath = localPath.substr(5);
+        if (this->ioMode == MEDIAIO_MODE_MMAP) {
+            this->ioSource = new MmapSource;
+        }
+        else {
+            this->ioSource = new FileSource;
+        }
+        this->ioThrottle = new ThrottledSource(this->ioSource, this->ioThrottleLatency, this->ioThrottleBandwidth);
+        ok = this->ioThrottle->open(localPath) && io->open(this->ioThrottle, this->ioBlockSize,
+            this->ioMode == MEDIAIO_MODE_CACHE ? this->ioBlockCount : 0, this->ioPrefetchBlocks);
+    }
+    this->mediaIO = io;
+    this->ioPublish();
+    return ok;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        释放自定义IO和限速读取源，释放前发布最后一次统计
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::ioClose(){
+    if (this->mediaIO) {
+        this->ioPublish();
+        delete this->mediaIO;
+        this->mediaIO = nullptr;
+    }
+    if (this->ioThrottle) {//不关闭被包装的读取源
+        delete this->ioThrottle;
+        this->ioThrottle = nullptr;
+    }
+    if (this->ioSource) {
+        delete this->ioSource;
+        this->ioSource = nullptr;
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        把自定义IO的当前统计发布到原子计数，供getIOStats在其他线程读取，只在持有mediaIO的线程调用
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::ioPublish(){
+    AVIOStats stats;
+    if (!this->mediaIO) return;
+    stats = this->mediaIO->getStats();
+    this->ioStatBytesRead.store(stats.bytesRead, std::memory_order_relaxed);
+    this->ioStatBytesDelivered.store(stats.bytesDelivered, std::memory_order_relaxed);
+    this->ioStatSyscalls.store(stats.syscalls, std::memory_order_relaxed);
+    this->ioStatCacheHits.store(stats.cacheHits, std::memory_order_relaxed);
+    this->ioStatCacheMisses.store(stats.cacheMisses, std::memory_order_relaxed);
+    this->ioStatPrefetched.store(stats.prefetched, std::memory_order_relaxed);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        释放或清空资源
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::avClear(){
+    if (this->formatContext) {
+        avformat_free_context(this->formatContext);
+    }
+    this->ioClose();//自定义IO需要在formatContext释放后释放
+    if (this->videoCodecContext) {
+        avcodec_free_context(&this->videoCodecContext);
+    }
+    if (this->audioCodecContext) {
+        avcodec_free_context(&this->audioCodecContext);
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->audioTrackMutex);//取消还没有换上的音轨
+        this->audioTrackPendingIndex = -1;
+        this->audioTrackReady.store(false);
+    }
+    this->audioConverter.release();
+    this->videoFrameCache.clear();
+    this->audioFrameCache.clear();
+    if (this->ffmpegThread) {
+        if(this->ffmpegThread->valid()){
+            this->ffmpegThread->wait();
+        }
+        delete this->ffmpegThread;
+    }
+    if (this->videoThread) {
+        if(this->videoThread->valid()){
+            this->videoThread->wait();
+        }
+        delete this->videoThread;
+    }
+    if (this->audioThread) {
+        if(this->audioThread->valid()){
+            this->audioThread->wait();
+        }
+        delete this->audioThread;
+    }
+    if (this->videoDecodeThread) {
+        if(this->videoDecodeThread->valid()){
+            this->videoDecodeThread->wait();
+        }
+        delete this->videoDecodeThread;
+    }
+    if (this->subtitleThread) {
+        if(this->subtitleThread->valid()){
+            this->subtitleThread->wait();
+        }
+        delete this->subtitleThread;
+    }
+    while (!this->subtitlePacketQueue.empty()) {//字幕线程结束后解封装可能还放入过packet
+        AVPacket* packet = this->subtitlePacketQueue.pop();
+        av_packet_free(&packet);
+    }
+    if (this->decoderPool && this->decoderPoolClient >= 0) {
+        this->decoderPool->removeClient(this->decoderPoolClient);
+    }
+    this->videoShouldFlush = false;
+    this->audioShouldFlush = false;
+    this->videoReady = false;
+    this->audioReady = false;
+    this->audioIsWaiting = false;
+    this->playerShouldEnd = true;
+    this->videoEnd = false;
+    this->audioEnd = false;
+    this->decoderStatus = CPPPLAYER_DECODER_UNKNOW;
+    this->playerStatus = CPPPLAYER_AV_UNKNOW;
+    this->videoPts.store(0);
+    this->audioPts.store(0);
+    this->videoAvgFrame = 0;
+    this->audioSampleRate = 0;
+    this->videoWidth = 0;
+    this->videoHeight = 0;
+    this->userOperationQueue.clear();
+    this->videoTimeBase = AVRational{ 1,AV_TIME_BASE };
+    this->audioTimeBase = AVRational{ 1,AV_TIME_BASE };
+    this->formatContext = nullptr;
+    this->videoStream = nullptr;
+    this->audioStream = nullptr;
+    this->videoCodecContext = nullptr;
+    this->audioCodecContext = nullptr;
+    this->mediaIO = nullptr;
+    this->ioSource = nullptr;
+    this->ioThrottle = nullptr;
+    this->ffmpegThread = nullptr;
+    this->videoThread = nullptr;
+    this->audioThread = nullptr;
+    this->videoDecodeThread = nullptr;
+    this->subtitleThread = nullptr;
+    this->subtitleStreamIndex = -1;
+    this->subtitleTrackRequest.store(-1);
+    this->decoderPoolClient = -1;
+    this->readPrepared = false;
+    this->readPacketPending = false;
+    this->readAtEof = false;
+    this->readEndNotified = false;
+    this->audioSuspended.store(false);
+    this->audioParkedFlush = false;
+    this->seekTargetPts.store(0);
+    this->backgroundMode.store(CPPPLAYER_BACKGROUND_OFF);
+    this->backgroundSince.store(-1);
+    this->qualityApplied = QUALITYCONTROLLER_LEVEL_FULL;
+    this->readSeekWaiting = false;
+    this->videoTaskPacketSent = false;
+    this->videoTaskCoverDrained = false;
+    this->videoTaskShouldFlush.store(false);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        打开文件
+* @Param:        void
+* @Return:       bool 打开成功返回true
+**/
+bool PlayerEngine::avOpen() {
+
+    int ret = 0;
+    int videoIndex = -1;
+    int audioIndex = -1;
+    int subtitleIndex = -1;
+    std::string comment;
+    AVDictionaryEntry* m = nullptr;
+    const AVCodec* videoCodec = nullptr;
+    this->videoStreamIndex = -1;
+    this->audioStreamIndex = -1;
+    AVDictionary*opts = nullptr;
+
+    this->avInit();
+
+    //Use custom IO(block cache or mmap, optionally throttled) for local file
+    if ((this->ioMode != MEDIAIO_MODE_DEFAULT || this->ioThrottleLatency > 0 || this->ioThrottleBandwidth > 0) && MediaIO::isLocalPath(this->path)) {
+        if (this->ioOpen()) {
+            this->formatContext = avformat_alloc_context();
+        }
+        if (this->formatContext) {
+            this->formatContext->pb = this->mediaIO->context();
+            this->formatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+        }
+        else {
+            this->messagePrint("WARNNING::MEDIAIO::OPEN_FAILED_USE_DEFAULT_IO", CPPPLAYER_COLOR_YELLOW);
+            this->ioClose();
+        }
+    }
+
+    //Open input media file
+    av_dict_set(&opts,"stimeout","5000000",0);
+    if (this->liveMode) {//直播不缓冲，缩短探测时间
+        av_dict_set(&opts, "fflags", "nobuffer", 0);
+        av_dict_set(&opts, "probesize", "32768", 0);
+        av_dict_set(&opts, "analyzeduration", "500000", 0);
+    }
+    else if (this->fastStart) {//快速启动缩短探测，音视频参数通常在文件头已经完整
+        av_dict_set(&opts, "probesize", CPPPLAYER_FASTSTART_PROBESIZE, 0);
+        av_dict_set(&opts, "analyzeduration", CPPPLAYER_FASTSTART_ANALYZE, 0);
+    }
+    ret = avformat_open_input(&this->formatContext, path.c_str(), nullptr, &opts);
+    av_dict_free(&opts);
+    if (ret != 0) {
+        this->messagePrint("ERROR::FFMPEG::OPEN_INPUT", CPPPLAYER_COLOR_RED);
+        ffmpegErrorPrint(ret);
+        this->avClear();
+        return false;
+    }
+
+    //Find stream(video or audio)
+    ret = avformat_find_stream_info(this->formatContext, nullptr);
+    if (ret < 0) {
+        this->messagePrint("ERROR::FFMPEG::FIND_STREAM_INFO", CPPPLAYER_COLOR_RED);
+        ffmpegErrorPrint(ret);
+        this->avClear();
+        return false;
+    }
+    //Print media info
+#ifdef CPPPLAYER_DEBUG
+    if (!this->fastStart) av_dump_format(this->formatContext, 0, this->path.c_str(), 0);
+#endif
+
+    //Find video stream and audio stream
+    videoIndex = av_find_best_stream(this->formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    audioIndex = av_find_best_stream(this->formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (videoIndex == AVERROR_STREAM_NOT_FOUND) {
+        this->messagePrint("WARNNING::FFMPEG::NOT_FIND_VIDEO_STREAM", CPPPLAYER_COLOR_YELLOW);
+        videoIndex = -1;
+    }
+    else if (videoIndex == AVERROR_DECODER_NOT_FOUND) {
+        this->messagePrint("WARNNING::FFMPEG::NOT_FIND_VIDEO_STREAM_DECODER", CPPPLAYER_COLOR_YELLOW);
+        videoIndex = -1;
+    }
+    else {
+        this->videoStream = this->formatContext->streams[videoIndex];
+    }
+    if (audioIndex == AVERROR_STREAM_NOT_FOUND) {
+        this->messagePrint("WARNNING::FFMPEG::NOT_FIND_AUDIO_STREAM", CPPPLAYER_COLOR_YELLOW);
+        audioIndex = -1;
+    }
+    else if (audioIndex == AVERROR_DECODER_NOT_FOUND) {
+        this->messagePrint("WARNNING::FFMPEG::NOT_FIND_AUDIO_STREAM_DECODER", CPPPLAYER_COLOR_YELLOW);
+        audioIndex = -1;
+    }
+    else {
+        this->audioStream = this->formatContext->streams[audioIndex];
+    }
+    if (videoIndex == -1 && audioIndex == -1) {
+        this->avClear();
+        return false;
+    }
+
+    //Open video decoder
+    if (this->videoStream && videoIndex != -1) {
+        videoCodec = avcodec_find_decoder(this->videoStream->codecpar->codec_id);
+        if (!videoCodec) {
+            this->messagePrint("ERROR::FFMPEG::CAN_NOT_FIND_VIDEO_DECODER", CPPPLAYER_COLOR_RED);
+            this->videoStream = nullptr;
+            videoIndex = -1;
+        }
+        else {
+            this->videoCodecContext = avcodec_alloc_context3(videoCodec);
+            if (!this->videoCodecContext) {
+                this->messagePrint("ERROR::FFMPEG::AVCODEC_ALLOC_CONTEXT3", CPPPLAYER_COLOR_RED);
+                this->videoStream = nullptr;
+                videoIndex = -1;
+            }
+            else {
+                ret = avcodec_parameters_to_context(this->videoCodecContext, this->videoStream->codecpar);
+                if (ret < 0) {
+                    this->messagePrint("ERROR::FFMPEG::CAN_NOT_COPY_PARAMETERS_TO_VIDEO_CODEC_CONTEXT", CPPPLAYER_COLOR_RED);
+                    ffmpegErrorPrint(ret);
+                    this->videoStream = nullptr;
+                    videoIndex = -1;
+                }
+                else {
+                    this->videoCodecContext->thread_count = this->decoderPool ? 1 : 8;//共享调度器的并行来自多个播放器，不再开解码线程
+                    if (this->liveMode) {//帧级多线程会额外延迟thread_count帧，直播只用片级多线程
+                        this->videoCodecContext->thread_type = FF_THREAD_SLICE;
+                        this->videoCodecContext->flags |= AV_CODEC_FLAG_LOW_DELAY;
+                    }
+                    ret = avcodec_open2(this->videoCodecContext, nullptr, nullptr);
+                    if (ret != 0) {
+                        this->messagePrint("ERROR::FFMPEG::CAN_NOT_OPEN_VIDEO_DECODER", CPPPLAYER_COLOR_RED);
+                        this->videoStream = nullptr;
+                        videoIndex = -1;
+                    }
+                }
+            }
+        }
+    }
+
+    //Open audio decoder
+    if (this->audioStream && audioIndex != -1) {
+        this->audioCodecContext = this->audioDecoderOpen(this->audioStream);
+        if (!this->audioCodecContext) {
+            this->audioStream = nullptr;
+            audioIndex = -1;
+        }
+    }
+
+    //Get media info
+    if (this->videoStream == nullptr && this->audioStream == nullptr) {
+        this->avClear();
+        return false;
+    }
+    if (this->videoStream) {
+        this->videoCodecContext->pkt_timebase = this->videoStream->time_base;
+        if(this->videoStream->nb_frames > 1){
+            if(this->videoStream->avg_frame_rate.num){
+                this->videoAvgFrame = this->videoStream->avg_frame_rate.den ? (float)av_q2d(this->videoStream->avg_frame_rate) : 0.0f;
+            }else{
+                this->videoAvgFrame = this->videoCodecContext->framerate.den ? (float)av_q2d(this->videoCodecContext->framerate) : 0.0f;
+            }
+            if(this->videoAvgFrame == 0.0f) this->videoAvgFrame = 30.0f;
+        }else{
+            this->videoAvgFrame = 0.0f;
+        }
+        this->videoWidth = this->videoCodecContext->width;
+        this->videoHeight = this->videoCodecContext->height;
+    }
+    if (this->audioStream) {
+        this->audioSampleRate = this->audioCodecContext->sample_rate;
+        ret = this->audioConverter.open(this->audioCodecContext);
+        if (ret != 0) {
+            this->messagePrint("ERROR::FFMPEG::SWR_INIT", CPPPLAYER_COLOR_RED);
+            ffmpegErrorPrint(ret);
+        }
+        if (ret != 0) {
+            this->audioStream = nullptr;
+            audioIndex = -1;
+        }
+    }
+    if (this->videoStream == nullptr && this->audioStream == nullptr) {
+        this->avClear();
+        return false;
+    }
+
+    this->videoStreamIndex = videoIndex;
+    this->audioStreamIndex = audioIndex;
+
+    //字幕只在有视频和字幕输出时读取，默认选择与视频流相关的字幕流，解码器由字幕线程按标记打开
+    if (this->subtitleSink && this->videoStream) {
+        subtitleIndex = av_find_best_stream(this->formatContext, AVMEDIA_TYPE_SUBTITLE, -1, videoIndex, nullptr, 0);
+        if (subtitleIndex < 0) subtitleIndex = -1;
+    }
+    this->subtitleStreamIndex = subtitleIndex;
+    this->subtitleTrackRequest.store(subtitleIndex);
+    if (subtitleIndex >= 0) this->subtitleMark(subtitleIndex);
+
+    //不播放的流（其他音轨、未选择的字幕、数据流等）由demuxer直接丢弃
+    for (unsigned int i = 0; i < this->formatContext->nb_streams; i++) {
+        this->formatContext->streams[i]->discard = ((int)i == videoIndex || (int)i == audioIndex || (int)i == subtitleIndex) ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+
+    //判断视频流是否只有一帧
+    if (this->videoStream) {
+        m = av_dict_get(this->videoStream->metadata, "comment", nullptr, 0);
+        if (m) {
+            comment = m->value;
+            comment = comment.substr(0, 5);
+            if (comment == "cover" || comment == "Cover") {
+                this->justCover = true;
+            }
+        }
+        else if (this->videoAvgFrame == 0.0f) {
+            this->justCover = true;
+        }
+    }
+    this->duration.first = this->formatContext->duration;
+    this->duration.second = AVRational{ 1,AV_TIME_BASE };
+
+    //帧缓存，直播和只有封面时不使用
+    if (this->liveMode || this->justCover) {
+        this->videoFrameCache.configure(0);
+        this->audioFrameCache.configure(0);
+    }
+    else {
+        this->videoFrameCache.configure(this->frameCacheBudget, this->frameCacheDownscale, this->videoWidth, this->videoHeight);
+        this->audioFrameCache.configure(this->frameCacheBudget ? CPPPLAYER_FRAMECACHE_AUDIO_BUDGET : 0);
+    }
+
+    //自适应画质，只有封面和离线模式（本来就不限速）时不调整
+    this->qualityController.reset((this->videoStream && this->videoAvgFrame > 0 && !this->justCover && !this->offlineMode) ? AV_TIME_BASE / this->videoAvgFrame : 0);
+
+    this->startupMark(this->startupOpenUs, "open done");
+    return true;
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        ffmpeg解码线程，在该线程中持续读取音视频packet，并对音频packet解码，视频packet由视频线程解码，
+*                快进/后退/重播/跳转操作在该线程首先执行。每一步的工作在readStep中，这里只负责等待
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::ffmpegReadThread(){
+    uint64_t units = 0;
+
+    if (!this->readPrepare()) return;
+    CPPPLAYER_TRACE_THREAD("ffmpeg read/audio decode");
+
+    while (this->readStep(INT64_MAX, units) != DECODERPOOL_TASK_DONE) {
+        if (this->readAtEof && this->readEndNotified) {//播放完毕，一直等待直到外部手动改变状态，或结束播放
+            std::unique_lock<std::mutex> lock(this->decoderStatus_mutex);
+            this->decoderStatus_cv.wait(lock, [this] {return this->decoderStatus.load() != CPPPLAYER_DECODER_EOF || this->seekGeneration.load() != this->seekApplied.load() ||
+                this->audioTrackReady.load() || this->playerShouldEnd; });
+        }
+        else {//等待播放完毕、视频packet队列有空位或音频线程进入等待状态
+            std::this_thread::sleep_for(std::chrono::milliseconds(this->readSeekWaiting ? 1 : 10));
+        }
+    }
+
+    this->readFinish();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        解封装开始前的准备：分配packet和帧，根据音视频流设置初始状态
+* @Param:        void
+* @Return:       bool 分配失败返回false（同时结束播放）
+**/
+bool PlayerEngine::readPrepare(){
+    this->readPacket = av_packet_alloc();
+    if (!this->readPacket) {
+        this->messagePrint("ERROR::FFMPEG::PACKET_ALLOC_FAILED", CPPPLAYER_COLOR_RED);
+        this->playerShouldEnd = true;
+        return false;
+    }
+    this->readFrame = av_frame_alloc();
+    if (!this->readFrame) {
+        this->messagePrint("ERROR::FFMPEG::FRAME_ALLOC_FAILED", CPPPLAYER_COLOR_RED);
+        this->playerShouldEnd = true;
+        av_packet_free(&this->readPacket);
+        return false;
+    }
+
+    if (this->videoStream){
+        this->videoTimeBase = this->videoStream->time_base;
+    }else{
+        this->videoEnd = true;
+    }
+    if (this->audioStream){
+        this->audioTimeBase = this->audioStream->time_base;
+    }
+    else{
+        this->audioPts.store(INT64_MAX);
+        this->audioEnd = true;
+    }
+    this->readPacketPending = false;
+    this->readAtEof = false;
+    this->readEndNotified = false;
+    this->readSeekWaiting = false;
+    this->decoderStatus.store(CPPPLAYER_DECODER_ING);
+    this->playerStatus.store(CPPPLAYER_AV_PLAYING);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        解封装/音频解码的一步：在budgetUs内循环执行跳转、读取packet、解码音频，不阻塞等待，
+*                需要等待（EOF、视频packet队列满、跳转后等待音频线程）时返回DECODERPOOL_TASK_WAIT，由调用者决定如何等待
+* @Param:        @budgetUs int64_t 本次最多执行的时间（us），独立线程时为INT64_MAX
+*                @units uint64_t& 累加完成的工作量（读取的packet数+解码的音频帧数）
+* @Return:       int DECODERPOOL_TASK_AGAIN/WAIT/DONE
+**/
+int PlayerEngine::readStep(int64_t budgetUs, uint64_t& units){
+    int ret = -1;
+    int64_t stepStart = av_gettime_relative();
+    int64_t nowPts = 0;
+    uint64_t generation = 0;
+    unsigned char nowStatus = CPPPLAYER_DECODER_UNKNOW;
+    uint8_t nowMode = CPPPLAYER_BACKGROUND_OFF;
+    AVDataInfo pcm;
+    AVPacket* packet = this->readPacket;
+    AVFrame* frame = this->readFrame;
+    int seekStreamIndex = -1;
+    int64_t resumePts = -1;
+    int64_t audioDecodeStart = 0;
+    int audioDecodedCount = 0;
+    int64_t cacheStart = 0;
+    int64_t trimPts = INT64_MIN;
+    int64_t loopShift = 0;
+    AVDataInfo cachedFrame;
+
+    while (av_gettime_relative() - stepStart < budgetUs) {
+
+        //每次循环读取一次解码状态
+        nowStatus = this->decoderStatus.load();
+        if (nowStatus == CPPPLAYER_DECODER_STOP || this->playerShouldEnd) return DECODERPOOL_TASK_DONE;
+        if (this->seekGeneration.load() != this->seekApplied.load()) {//有新的跳转目标，正在进行的跳转直接放弃
+            if (this->videoShouldFlush || (this->audioStream && this->audioShouldFlush)) {//上一次跳转的队列切换还未被输出线程处理
+                return DECODERPOOL_TASK_WAIT;
+            }
+            {
+                std::lock_guard<std::mutex> lock(this->seekMutex);
+                generation = this->seekGeneration.load();
+                nowPts = this->seekRequestPts.load();
+            }
+            if (this->readSeekWaiting) {//上一次跳转还在等待恢复播放
+                this->statSeekPreempted.fetch_add(1, std::memory_order_relaxed);
+            }
+            this->statSeekCoalesced.fetch_add(generation - this->seekApplied.load() - 1, std::memory_order_relaxed);
+            this->seekApplied.store(generation);
+            this->readSeekWaiting = false;
+            this->decoderStatus.store(CPPPLAYER_DECODER_GOTO);
+            this->seekTargetPts.store(nowPts);
+            this->loopOffset.store(0);//跳转目标是文件内的时间，回到没有循环偏移的时间轴
+            this->loopTailEnd = INT64_MIN;
+            this->readVideoDts = INT64_MIN;
+            this->readVideoDtsFloor = INT64_MIN;
+            this->readSubtitlePts = INT64_MIN;
+            if (this->subtitleStreamIndex >= 0) this->subtitleMark(this->subtitleStreamIndex);//字幕线程丢弃已送出的事件
+            this->audioSplicing.store(false);//拼接标记随旧队列一起清空
+            //跳转目标之后有足够长的连续缓存时，视频线程从缓存取帧，解码器从缓存末尾继续解码
+            this->seekCount++;
+            resumePts = this->frameCacheCoverage(nowPts, cacheStart);
+            if (resumePts >= 0) {
+                this->seekFromCache++;
+                this->cacheServeFrom.store(nowPts);
+                this->cacheServeUntil.store(resumePts);
+                this->videoSkipUntil.store(resumePts);
+                this->audioSkipUntil.store(resumePts);
+                this->seekExact.store(false);
+                nowPts = resumePts;
+                seekStreamIndex = -1;
+            }
+            else {//从关键帧解码到目标，目标之前的帧丢弃（只有封面时保留唯一的一帧）
+                this->cacheServeFrom.store(-1);
+                this->cacheServeUntil.store(-1);
+                this->videoSkipUntil.store(this->justCover ? INT64_MIN : nowPts);
+                this->audioSkipUntil.store(nowPts);
+                this->seekExact.store(true);
+            }
+            if (this->decoderPool && this->videoStream) {//解码器只由视频解码任务使用，在切换队列前通知它刷新
+                this->videoTaskShouldFlush.store(true);
+            }
+            this->queueUseIndex.store(this->queueFlushIndex.exchange(this->queueUseIndex.load()));//更换使用队列和刷新队列下标
+            this->videoShouldFlush = true;
+            this->audioShouldFlush = true;
+            this->stillWake();
+            this->playerStatus.store(CPPPLAYER_AV_PAUSE);
+            if (resumePts >= 0 && this->audioStream) {//缓存的音频帧直接放入新的帧队列
+                while (this->audioFrameCache.get(cacheStart, resumePts, cachedFrame)) {
+                    cacheStart = cachedFrame.pts + 1;
+                    this->audioDataQueue[this->queueUseIndex.load()].push(cachedFrame);
+                }
+                cachedFrame = AVDataInfo();
+            }
+            if (this->videoStream && !this->decoderPool){
+                while(this->videoIsDecoding);
+                avcodec_flush_buffers(this->videoCodecContext);
+            }
+            if (this->audioStream) avcodec_flush_buffers(this->audioCodecContext);
+            while (!this->audioParked.empty()) {//挂起期间保留的音频packet已过时
+                av_packet_free(&this->audioParked.front());
+                this->audioParked.pop_front();
+            }
+            this->audioParkedFlush = false;
+            //根据音视频流状态设置跳转位置
+            CPPPLAYER_TRACE_INSTANT(resumePts >= 0 ? "seek (frame cache)" : "seek", nowPts);
+            avformat_seek_file(this->formatContext, seekStreamIndex, INT64_MIN, nowPts, INT64_MAX, AVSEEK_FLAG_BACKWARD);
+            this->readSeekWaiting = true;//等待音频线程进入等待状态后恢复播放
+            continue;
+        }
+        if (this->readSeekWaiting) {//跳转后等待音频线程进入等待状态
+            if (this->audioStream && !this->audioIsWaiting) return DECODERPOOL_TASK_WAIT;
+            this->readSeekWaiting = false;
+            this->seekCompleted.store(this->seekApplied.load());
+            this->decoderStatus.store(CPPPLAYER_DECODER_ING);
+            this->playerStatus.store(CPPPLAYER_AV_PLAYING);
+            continue;
+        }
+        if (this->audioTrackReady.load() && this->readAudioTrackSwitch()) {//换上新音轨，解封装已退回到音频时钟处
+            if (nowStatus == CPPPLAYER_DECODER_EOF) this->decoderStatus.store(CPPPLAYER_DECODER_ING);
+            continue;
+        }
+        if (this->subtitleTrackRequest.load() != this->subtitleStreamIndex) {//切换字幕流，新的字幕从之后读到的packet开始显示
+            if (this->subtitleStreamIndex >= 0) this->formatContext->streams[this->subtitleStreamIndex]->discard = AVDISCARD_ALL;
+            this->subtitleStreamIndex = this->subtitleTrackRequest.load();
+            if (this->subtitleStreamIndex >= 0) this->formatContext->streams[this->subtitleStreamIndex]->discard = AVDISCARD_DEFAULT;
+            this->readSubtitlePts = INT64_MIN;
+            this->subtitleMark(this->subtitleStreamIndex);
+            continue;
+        }
+        if (nowStatus == CPPPLAYER_DECODER_EOF) {//如果读取完毕，会一直等待状态改变，如快进/跳转等操作，或者音视频全都播放完毕
+            this->readAtEof = true;
+            if (this->videoEnd && this->audioEnd && !this->readEndNotified) {
+                this->readEndNotified = true;
+                if(this->offlineMode) this->offlineFinish();
+                if(this->endCallback) this->endCallback();
+            }//通知播放结束，循环播放需要外部执行avRestart
+            return DECODERPOOL_TASK_WAIT;
+        }
+        if (this->readAtEof) {//离开EOF状态（跳转或重播），重新判断是否播放完毕
+            this->readAtEof = false;
+            this->readEndNotified = false;
+            if(this->videoStream && !this->justCover) this->videoEnd = false;//封面显示后视频就已结束
+            if(this->audioStream) this->audioEnd = false;
+        }
+
+        if (this->readPacketPending) {//视频packet队列有空位或需要跳转时放入
+            if (this->videoPacketQueue[this->queueUseIndex.load()].size() > ((int)this->videoAvgFrame * 4) &&
+                !(nowStatus & (CPPPLAYER_DECODER_ADVANCE | CPPPLAYER_DECODER_BACK))) {
+                return DECODERPOOL_TASK_WAIT;
+            }
+            this->videoPacketQueue[this->queueUseIndex.load()].push(packet);//视频packet交由视频线程自己解码
+            this->readPacket = packet = av_packet_alloc();
+            this->readPacketPending = false;
+            continue;
+        }
+
+        if (!this->audioParked.empty() && !this->audioSuspended.load()) {//音频输出恢复，先解码挂起期间保留的packet
+            if (this->audioParkedFlush) {
+                avcodec_flush_buffers(this->audioCodecContext);
+                this->audioParkedFlush = false;
+            }
+            av_packet_move_ref(packet, this->audioParked.front());
+            av_packet_free(&this->audioParked.front());
+            this->audioParked.pop_front();
+        }
+        else {
+            if (this->backgroundMode.load() != CPPPLAYER_BACKGROUND_OFF &&
+                this->audioDataQueue[this->queueUseIndex.load()].size() > CPPPLAYER_BACKGROUND_AUDIO_AHEAD) {//后台时没有视频packet队列限制读取速度，按音频帧队列限制
+                return DECODERPOOL_TASK_WAIT;
+            }
+            {
+                CPPPLAYER_TRACE_ZONE("demux");
+                ret = av_read_frame(this->formatContext, packet);//读取packet
+            }
+            this->ioPublish();
+            if (ret != 0) {
+                if (ret == AVERROR_EOF && this->readLoopWrap()) continue;//无缝循环，接着读取文件开头
+                this->messagePrint("INFO::FFMPEG::FILE_DECODER_EOF", CPPPLAYER_COLOR_RED);
+                this->ffmpegErrorPrint(ret);
+                this->decoderStatus.store(CPPPLAYER_DECODER_EOF);
+                continue;
+            }
+            units++;
+            if (packet->stream_index < CPPPLAYER_STREAM_STATS_MAX) {
+                this->statStreamPackets[packet->stream_index].fetch_add(1, std::memory_order_relaxed);
+                this->statStreamBytes[packet->stream_index].fetch_add(packet->size, std::memory_order_relaxed);
+            }
+            if (this->loopOffset.load() != 0) {//无缝循环之后的每一遍，时间戳接在上一遍之后
+                loopShift = av_rescale_q(this->loopOffset.load(), AVRational{ 1, AV_TIME_BASE }, this->formatContext->streams[packet->stream_index]->time_base);
+                if (packet->pts != AV_NOPTS_VALUE) packet->pts += loopShift;
+                if (packet->dts != AV_NOPTS_VALUE) packet->dts += loopShift;
+            }
+            if (this->liveMode && this->liveStartClock.load() < 0 && packet->pts != AV_NOPTS_VALUE &&
+                (packet->stream_index == this->videoStreamIndex || packet->stream_index == this->audioStreamIndex)) {//记录第一个packet到达的时刻，用于测量延迟
+                this->liveStartPts.store(av_rescale_q(packet->pts, this->formatContext->streams[packet->stream_index]->time_base, AVRational{ 1,AV_TIME_BASE }));
+                this->liveStartClock.store(av_gettime_relative());
+            }
+            if (this->liveMode && this->formatContext->start_time_realtime != AV_NOPTS_VALUE) {//发送端时钟可能在收到RTCP之后才有
+                this->liveSenderClock.store(this->formatContext->start_time_realtime);
+            }
+            if (this->videoStreamIndex != -1 && packet->stream_index == this->videoStreamIndex) {
+                if (packet->dts != AV_NOPTS_VALUE) {
+                    if (this->readVideoDtsFloor != INT64_MIN) {//切换音轨后解封装退回重新读取，已经读过的视频packet不重复放入
+                        if (packet->dts <= this->readVideoDtsFloor) {
+                            av_packet_unref(packet);
+                            continue;
+                        }
+                        this->readVideoDtsFloor = INT64_MIN;//只在退回后生效一次，之后dts回退（回绕、不连续）的packet照常放入
+                    }
+                    this->readVideoDts = packet->dts;
+                }
+                nowMode = this->backgroundMode.load();
+                if (nowMode == CPPPLAYER_BACKGROUND_DISCARD || (nowMode == CPPPLAYER_BACKGROUND_KEYFRAME && !(packet->flags & AV_PKT_FLAG_KEY))) {//后台模式不解码视频（或只解码关键帧）
+                    av_packet_unref(packet);
+                    this->statVideoSkipped.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                if (this->justCover && this->videoReady) {//跳转后demuxer会重新送出封面，画面已显示，不再解码
+                    av_packet_unref(packet);
+                    continue;
+                }
+                if (!this->audioStream && packet->pts != AV_NOPTS_VALUE) {//没有音频时按视频记录已读取内容的结束时刻
+                    this->loopTailEnd = std::max(this->loopTailEnd, av_rescale_q(packet->pts, this->videoTimeBase, AVRational{ 1, AV_TIME_BASE }) +
+                        (packet->duration > 0 ? av_rescale_q(packet->duration, this->videoTimeBase, AVRational{ 1, AV_TIME_BASE }) : (int64_t)(AV_TIME_BASE / this->videoAvgFrame)));
+                }
+                this->readPacketPending = true;
+                continue;
+            }
+            else if (this->subtitleStreamIndex != -1 && packet->stream_index == this->subtitleStreamIndex) {//字幕packet交由字幕线程解码
+                if (packet->pts != AV_NOPTS_VALUE) {
+                    if (packet->pts <= this->readSubtitlePts) {//切换音轨后退回重新读到的字幕
+                        av_packet_unref(packet);
+                        continue;
+                    }
+                    this->readSubtitlePts = packet->pts;
+                }
+                this->subtitlePacketQueue.push(packet);
+                this->readPacket = packet = av_packet_alloc();
+                continue;
+            }
+            else if (packet->stream_index != this->audioStreamIndex) {
+                av_packet_unref(packet);
+                continue;
+            }
+            else if (this->audioSuspended.load() && packet->stream_index == this->audioStreamIndex) {//音频输出听不到，不解码，只保留主时钟附近的packet
+                this->audioParked.push_back(packet);
+                this->readPacket = packet = av_packet_alloc();
+                this->audioParkedFlush = true;
+                this->statAudioSkipped.fetch_add(1, std::memory_order_relaxed);
+                while (!this->audioParked.empty() && (this->audioParked.size() > CPPPLAYER_AUDIO_PARKED_MAX ||
+                    (this->audioParked.front()->pts != AV_NOPTS_VALUE &&
+                    av_rescale_q(this->audioParked.front()->pts, this->audioTimeBase, AVRational{ 1, AV_TIME_BASE }) < this->audioPts.load() - CPPPLAYER_AUDIO_PARKED_KEEP))) {
+                    av_packet_free(&this->audioParked.front());
+                    this->audioParked.pop_front();
+                }
+                continue;
+            }
+        }
+
+        audioDecodeStart = av_gettime_relative();
+        audioDecodedCount = 0;
+        {
+            CPPPLAYER_TRACE_ZONE("audio send_packet");
+            ret = avcodec_send_packet(this->audioCodecContext, packet);
+        }
+        av_packet_unref(packet);
+        if (ret != 0) {
+            this->messagePrint("ERROR::FFMPEG::SEND_PACKET_ERROR", CPPPLAYER_COLOR_RED);
+            this->ffmpegErrorPrint(ret);
+            continue;
+        }
+        while (true) {
+            {
+                CPPPLAYER_TRACE_ZONE("audio receive_frame");
+                ret = avcodec_receive_frame(this->audioCodecContext, frame);
+            }
+            if (ret != 0) {
+                this->messagePrint("ERROR::FFMPEG::RECEIVE_FRAME", CPPPLAYER_COLOR_RED);
+                ffmpegErrorPrint(ret);
+                if (audioDecodedCount) {
+                    this->statAudioDecoded.fetch_add(audioDecodedCount, std::memory_order_relaxed);
+                    this->statAudioDecodeUs.fetch_add(av_gettime_relative() - audioDecodeStart, std::memory_order_relaxed);
+                }
+                break;
+            }
+            this->messagePrint("DEBUG::FFMPEG::RECEIVE_A_FRAME", CPPPLAYER_COLOR_GREEN);
+            trimPts = INT64_MIN;
+            if (frame->pts != AV_NOPTS_VALUE && av_rescale_q(frame->pts, this->audioTimeBase, AVRational{ 1, AV_TIME_BASE }) < this->audioSkipUntil.load()) {
+                if (!this->seekExact.load() || av_rescale_q(frame->pts, this->audioTimeBase, AVRational{ 1, AV_TIME_BASE }) +
+                    av_rescale(frame->nb_samples, AV_TIME_BASE, frame->sample_rate) <= this->audioSkipUntil.load()) {
+                    continue;//已由帧缓存提供的帧或跳转目标之前的帧不再转换
+                }
+                trimPts = this->audioSkipUntil.load();//跨过跳转目标的帧，转换后裁掉目标之前的采样
+            }
+
+            if (this->liveMode) {//直播落后时在PCM上少输出一部分采样追赶
+                this->audioConverter.setCompensation(this->liveCatchUp.load() ? CPPPLAYER_LIVE_CATCHUP_RATIO : 0.0);
+            }
+            {
+                CPPPLAYER_TRACE_ZONE_ARG("swr_convert", av_rescale_q(frame->pts, this->audioTimeBase, AVRational{ 1, AV_TIME_BASE }));
+                ret = this->audioConverter.convert(frame, av_rescale_q(frame->pts, this->audioTimeBase, AVRational{ 1, AV_TIME_BASE }), pcm);
+            }
+            if (ret == FRAMECONVERTER_ERROR_ALLOC) {
+                this->messagePrint("ERROR::FFMPEG::PCM_BUFFER_ALLOC_FAILED", CPPPLAYER_COLOR_RED);
+                continue;
+            }
+            if (ret != FRAMECONVERTER_OK) {
+                this->messagePrint("ERROR::FFMPEG::SWR_CONVERT", CPPPLAYER_COLOR_RED);
+                continue;
+            }
+            if (trimPts != INT64_MIN) AudioFrameConverter::trimFront(pcm, trimPts, this->audioSampleRate);
+            if (frame->pts != AV_NOPTS_VALUE) {//记录已解码音频的结束时刻，无缝循环时下一遍接在这里
+                this->loopTailEnd = std::max(this->loopTailEnd, av_rescale_q(frame->pts, this->audioTimeBase, AVRational{ 1, AV_TIME_BASE }) +
+                    av_rescale(frame->nb_samples, AV_TIME_BASE, frame->sample_rate));
+            }
+            this->audioDataQueue[this->queueUseIndex.load()].push(pcm);
+            pcm = AVDataInfo();//音频packet解码后的pcm数据通过队列交由音频线程输出
+            audioDecodedCount++;
+            units++;
+        }
+
+    }
+
+    return DECODERPOOL_TASK_AGAIN;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        解封装结束，释放packet、帧和队列中剩余的数据
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::readFinish(){
+    int ret = 0;
+    AVPacket* packet = nullptr;
+    if (this->readPacket) {
+        av_packet_free(&this->readPacket);
+    }
+    if (this->readFrame) {
+        av_frame_free(&this->readFrame);
+    }
+    this->readPacketPending = false;
+    ret = this->videoPacketQueue[0].size();
+    for (int i = 0; i < ret; i++) {
+        packet = this->videoPacketQueue[0].pop();
+        av_packet_free(&packet);
+    }
+    ret = this->videoPacketQueue[1].size();
+    for (int i = 0; i < ret; i++) {
+        packet = this->videoPacketQueue[1].pop();
+        av_packet_free(&packet);
+    }
+    this->audioDataQueue[0].clearWithDelete();
+    this->audioDataQueue[1].clearWithDelete();
+    while (!this->audioParked.empty()) {
+        av_packet_free(&this->audioParked.front());
+        this->audioParked.pop_front();
+    }
+
+    this->messagePrint("INFO::FFMPEG::DECODER_END", CPPPLAYER_COLOR_GREEN);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        共享调度器中的解封装/音频解码任务，第一次调用时准备，结束时释放资源并通知join
+* @Param:        @budgetUs int64_t 时间片（us）
+*                @units uint64_t& 累加完成的工作量
+* @Return:       int DECODERPOOL_TASK_xxx
+**/
+int PlayerEngine::readTask(int64_t budgetUs, uint64_t& units){
+    int ret = DECODERPOOL_TASK_DONE;
+    if (budgetUs == DECODERPOOL_BUDGET_CANCEL) {//调度器停止，结束播放
+        this->playerShouldEnd = true;
+        this->readFinish();
+        this->readTaskDone.set_value();
+        return DECODERPOOL_TASK_DONE;
+    }
+    if (!this->readPrepared) {
+        this->readPrepared = true;
+        if (!this->readPrepare()) {
+            this->readTaskDone.set_value();
+            return DECODERPOOL_TASK_DONE;
+        }
+    }
+    ret = this->readStep(budgetUs, units);
+    if (ret == DECODERPOOL_TASK_DONE) {
+        this->readFinish();
+        this->readTaskDone.set_value();
+    }
+    return ret;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        共享调度器中的视频解码任务，把videoPacketQueue中的packet解码到videoFrameQueue，
+*                帧队列达到预存帧数（5帧，直播2帧）时等待视频线程取走
+* @Param:        @budgetUs int64_t 时间片（us）
+*                @units uint64_t& 累加解码的帧数
+* @Return:       int DECODERPOOL_TASK_xxx
+**/
+int PlayerEngine::videoDecodeTask(int64_t budgetUs, uint64_t& units){
+    int64_t stepStart = av_gettime_relative();
+    uint8_t index = 0;
+    size_t limit = this->liveMode ? CPPPLAYER_LIVE_RENDER_QUEUE : 5;
+    AVPacket* packet = nullptr;
+    std::queue<AVDataInfo> decoded;
+
+    if (this->playerShouldEnd || budgetUs == DECODERPOOL_BUDGET_CANCEL) {//结束播放或调度器停止
+        this->playerShouldEnd = true;
+        if (this->videoTaskFrame) {
+            av_frame_free(&this->videoTaskFrame);
+        }
+        this->videoFrameQueue[0].clearWithDelete();
+        this->videoFrameQueue[1].clearWithDelete();
+        this->videoTaskConverter.release();
+        this->videoTaskDone.set_value();
+        return DECODERPOOL_TASK_DONE;
+    }
+    if (this->decoderStatus.load() == CPPPLAYER_DECODER_UNKNOW) return DECODERPOOL_TASK_WAIT;//解封装尚未开始
+    if (!this->videoTaskFrame) {
+        this->videoTaskFrame = av_frame_alloc();
+        if (!this->videoTaskFrame) {
+            this->messagePrint("ERROR::FFMPEG::FRAME_ALLOC_FAILED", CPPPLAYER_COLOR_RED);
+            this->playerShouldEnd = true;
+            return DECODERPOOL_TASK_AGAIN;
+        }
+    }
+
+    while (av_gettime_relative() - stepStart < budgetUs && !this->playerShouldEnd) {
+        this->videoTaskBusy.store(true);//先置忙再取下标，视频线程刷新时等待本次解码的帧入队
+        index = this->queueUseIndex.load();
+        if (this->videoTaskShouldFlush.exchange(false)) {//跳转后第一次取到新队列下标时在本任务中刷新解码器，不与解码并发
+            avcodec_flush_buffers(this->videoCodecContext);
+        }
+        if (this->videoShouldFlush || this->videoFrameQueue[index].size() >= limit) {
+            this->videoTaskBusy.store(false);
+            return DECODERPOOL_TASK_WAIT;
+        }
+        if (this->videoPacketQueue[index].empty()) {
+            if (this->justCover && this->videoTaskPacketSent && !this->videoTaskCoverDrained && !this->videoReady && this->videoFrameQueue[index].empty()) {
+                this->videoTaskCoverDrained = true;//只有一张图片时可能需要刷新解码器才能得到图像，送入空packet取出全部剩余帧
+                packet = nullptr;
+                this->videoDecoderOneFrame(this->videoTaskConverter, packet, this->videoTaskFrame, decoded);
+            }
+            while (!decoded.empty()) {
+                this->videoFrameQueue[index].push(decoded.front());
+                decoded.pop();
+                units++;
+            }
+            this->videoTaskBusy.store(false);
+            return DECODERPOOL_TASK_WAIT;
+        }
+        packet = this->videoPacketQueue[index].pop();
+        this->videoTaskPacketSent = true;
+        this->videoDecoderOneFrame(this->videoTaskConverter, packet, this->videoTaskFrame, decoded);
+        while (!decoded.empty()) {
+            this->videoFrameQueue[index].push(decoded.front());
+            decoded.pop();
+            units++;
+        }
+        this->videoTaskBusy.store(false);
+    }
+
+    return DECODERPOOL_TASK_AGAIN;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        视频输出线程，同时也负责用户操作的响应（即使没有视频流也能够响应），
+*                该线程自己解码packet获取帧数据，帧交给VideoSink暂存，到主时钟（默认音频时钟）时显示
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::videoOutputThread(){
+    int ret = -1;
+    uint8_t tempIndex = 0;
+    AVPacket* packet = nullptr;
+    AVFrame* frame = av_frame_alloc();
+    VideoFrameConverter videoConverter;
+    std::queue<AVDataInfo> frameDataQueue;
+    std::queue<AVDataInfo> decodedAhead;
+    std::deque<int64_t> stagedPts;
+    AVDataInfo cachedFrame;
+    int64_t cacheCursor = 0;
+    int64_t cacheUntil = 0;
+    int64_t avOffset = 0;
+    int64_t presentPts = 0;
+    bool loopPending = false;
+    bool sinkOpened = false;
+    bool shouldCheckKey = false;
+    VideoSink* sink = this->videoSink;
+    ClockSource* clock = this->clockSource;
+    std::chrono::time_point<std::chrono::system_clock> startC = std::chrono::system_clock::now();
+    std::chrono::time_point<std::chrono::system_clock> nowC = std::chrono::system_clock::now();
+    std::chrono::milliseconds startM;
+    std::chrono::milliseconds nowM;
+    size_t renderQueueSize = this->liveMode ? CPPPLAYER_LIVE_RENDER_QUEUE : 5;
+
+#ifdef CPPPLAYER_DEBUG
+    double max = 0;
+#endif
+
+    if (this->decoderPool) {//共享调度器模式由视频解码任务解码，本线程只取帧输出
+        if (this->videoStream && !this->videoFrameQueue[this->queueUseIndex.load()].waitFor(10000)) {
+            goto VIDEOOUTPUTTHREAD_END;
+        }
+    }
+    else if (this->videoStream && !this->videoPacketQueue[this->queueUseIndex.load()].waitFor(10000)) {//没有视频流时不等待
+        goto VIDEOOUTPUTTHREAD_END;
+    }
+    if(this->audioStream && !this->fastStart){
+        for (int i = 0; i < 1000; i++) {
+            if (this->audioReady)break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (!this->audioReady) {
+            goto VIDEOOUTPUTTHREAD_END;
+        }
+    }
+    if (this->decoderPool && this->videoStream) {
+        frameDataQueue.push(this->videoFrameQueue[this->queueUseIndex.load()].pop());
+    }
+    while (true && this->videoStream && !this->decoderPool) {//预先解码一帧图像
+        if (this->videoPacketQueue[this->queueUseIndex.load()].empty()) {
+            if (!this->videoPacketQueue[this->queueUseIndex.load()].waitFor(100)) {
+                packet = nullptr;//只有一张图片时可能需要刷新解码器才能得到图像，送入空packet取出全部剩余帧
+                if (this->justCover && this->videoDecoderOneFrame(videoConverter, packet, frame, frameDataQueue)) break;
+                goto VIDEOOUTPUTTHREAD_END;
+            }
+        }
+        packet = this->videoPacketQueue[this->queueUseIndex.load()].pop();
+        if (this->videoDecoderOneFrame(videoConverter, packet, frame, frameDataQueue)) {
+            break;
+        }
+    }
+
+    CPPPLAYER_TRACE_THREAD("video output/video decode");
+    if (this->videoStream) {
+        if (!sink->open(this->videoWidth, this->videoHeight)) {
+            this->messagePrint("ERROR::VIDEO_SINK::OPEN_FAILED", CPPPLAYER_COLOR_RED);
+            goto VIDEOOUTPUTTHREAD_END;
+        }
+        sinkOpened = true;
+        if (sink->stage(frameDataQueue.front())) {
+            stagedPts.push_back(frameDataQueue.front().pts);
+            frameDataQueue.front().clear();
+            frameDataQueue.pop();
+        }
+        if (this->fastStart && !stagedPts.empty()) {//快速启动：第一帧不等主时钟，解码后立即显示
+            presentPts = stagedPts.front();
+            stagedPts.pop_front();
+            sink->present(presentPts);
+            this->startupMark(this->startupFirstVideoUs, "first video");
+            this->statRendered.fetch_add(1, std::memory_order_relaxed);
+            this->videoPts.store(presentPts);
+        }
+    }
+    this->videoReady = true;
+    if (this->audioStream && this->fastStart) {//第一帧已显示，再等待音频开始
+        for (int i = 0; i < 10000; i++) {
+            if (this->audioReady || this->playerShouldEnd)break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!this->audioReady) {
+            goto VIDEOOUTPUTTHREAD_END;
+        }
+    }
+
+    startC = std::chrono::system_clock::now();
+    nowC = std::chrono::system_clock::now();
+    while(!this->playerShouldEnd){
+        this->statFrameQueue.store(frameDataQueue.size(), std::memory_order_relaxed);
+        if(this->videoShouldFlush){
+            ret = this->videoPacketQueue[this->queueFlushIndex.load()].size();
+            while(ret-- > 0){
+                packet = this->videoPacketQueue[this->queueFlushIndex.load()].pop();
+                av_packet_free(&packet);
+            }
+            this->videoShouldFlush = false;
+            while(!frameDataQueue.empty()){//已解码未显示的帧放入缓存
+                this->videoFrameCache.insert(frameDataQueue.front());
+                frameDataQueue.pop();
+            }
+            while(!decodedAhead.empty()){
+                this->videoFrameCache.insert(decodedAhead.front());
+                decodedAhead.pop();
+            }
+            if(this->decoderPool){//解码任务可能正在向旧的帧队列写入，等它完成后再清空
+                while(this->videoTaskBusy.load());
+                while(!this->videoFrameQueue[this->queueFlushIndex.load()].empty()){
+                    cachedFrame = this->videoFrameQueue[this->queueFlushIndex.load()].pop();
+                    this->videoFrameCache.insert(cachedFrame);
+                }
+                cachedFrame = AVDataInfo();
+            }
+            cacheCursor = this->cacheServeFrom.load();
+            cacheUntil = this->cacheServeUntil.load();
+            if(cacheCursor < 0) cacheCursor = cacheUntil = 0;
+            if(sinkOpened) sink->flush();
+            stagedPts.clear();
+        }
+
+        //直播落后时，已经过时的帧（下一帧也已到显示时间）直接丢弃，不再暂存
+        if(this->liveMode && this->audioStream){
+            while(frameDataQueue.size() > 1 && frameDataQueue.back().pts <= clock->now()){
+                CPPPLAYER_TRACE_INSTANT("live drop video", frameDataQueue.front().pts);
+                this->statDropped.fetch_add(1, std::memory_order_relaxed);
+                frameDataQueue.front().clear();
+                frameDataQueue.pop();
+            }
+        }
+
+        //输出有空位时暂存下一帧（如上传到PBO），与显示交替进行
+        if(sinkOpened && !frameDataQueue.empty() && sink->canStage()){
+            if(sink->stage(frameDataQueue.front())){
+                stagedPts.push_back(frameDataQueue.front().pts);
+                this->videoFrameCache.insert(frameDataQueue.front());//暂存后的帧放入缓存，供之后的后退或循环使用
+                frameDataQueue.pop();
+            }
+        }
+        if(!stagedPts.empty() && (this->offlineMode || stagedPts.front() <= clock->now())){//离线模式不等待主时钟
+            presentPts = stagedPts.front();
+            stagedPts.pop_front();
+            sink->present(presentPts);
+            if(this->startupFirstVideoUs.load() < 0) this->startupMark(this->startupFirstVideoUs, "first video");
+            this->statRendered.fetch_add(1, std::memory_order_relaxed);
+            if(this->audioStream && !this->offlineMode){
+                avOffset = clock->now() - presentPts;
+                this->statAvOffset.store(avOffset, std::memory_order_relaxed);
+                this->statAvHistogram[PlaybackStats::avBucket(avOffset)].fetch_add(1, std::memory_order_relaxed);
+                if(this->videoAvgFrame > 0 && avOffset > 1500000 / this->videoAvgFrame){
+                    this->statLate.fetch_add(1, std::memory_order_relaxed);
+                }
+                CPPPLAYER_TRACE_COUNTER("A-V (us)", avOffset);
+            }
+            this->videoPts.store(presentPts);
+            if(!this->audioStream && this->liveMode){
+                this->updateLiveLatency(presentPts);
+            }
+            if(!this->audioStream && !this->justCover && !this->offlineMode){//如果只有视频流，则需要定时播放，直播落后时不等待
+                if(!this->liveMode || this->liveAddedLatency.load() <= this->liveLatencyTarget){
+                    std::this_thread::sleep_for(std::chrono::milliseconds((int)(1000 / this->videoAvgFrame) - 3));
+                }
+            }
+        }
+
+        tempIndex = this->queueUseIndex.load();
+        if (cacheCursor < cacheUntil && frameDataQueue.size() < renderQueueSize) {//跳转命中缓存时从缓存取帧
+            if (this->videoFrameCache.get(cacheCursor, cacheUntil, cachedFrame)) {
+                cacheCursor = cachedFrame.pts + 1;
+                frameDataQueue.push(cachedFrame);
+                cachedFrame = AVDataInfo();
+            }
+            else {
+                cacheCursor = cacheUntil;
+            }
+            if (cacheCursor >= cacheUntil) {//缓存区间取完，接上解码器在此期间解码好的帧
+                while (!decodedAhead.empty()) {
+                    frameDataQueue.push(decodedAhead.front());
+                    decodedAhead.pop();
+                }
+            }
+        }
+        else if (this->decoderPool && cacheCursor >= cacheUntil && !this->videoFrameQueue[tempIndex].empty() && frameDataQueue.size() < renderQueueSize) {//取解码任务已解码好的帧
+            frameDataQueue.push(this->videoFrameQueue[tempIndex].pop());
+        }
+        else if (!this->decoderPool && cacheCursor < cacheUntil && decodedAhead.size() < renderQueueSize && !this->videoPacketQueue[tempIndex].empty()) {//同时解码器在后台追赶到缓存区间末尾
+            packet = this->videoPacketQueue[tempIndex].pop();
+            this->videoDecoderOneFrame(videoConverter, packet, frame, decodedAhead);
+        }
+        else if (!this->decoderPool && cacheCursor >= cacheUntil && !this->videoPacketQueue[tempIndex].empty() && frameDataQueue.size() < renderQueueSize) {//预存5帧画面（直播2帧），保持流畅性和低内存消耗，帧数过高(帧间隔+传输时间<=解码时间)可能造成卡顿
+            while (true) {
+                if (this->videoPacketQueue[tempIndex].empty()) {
+                    if (this->videoShouldFlush || this->playerShouldEnd || this->decoderStatus.load() == CPPPLAYER_DECODER_EOF)break;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                else {
+                    packet = this->videoPacketQueue[tempIndex].pop();
+                    if (this->videoDecoderOneFrame(videoConverter, packet, frame, frameDataQueue)) {
+                        break;
+                    }
+                }
+            }
+        }
+        else if (cacheCursor >= cacheUntil && (!this->videoStream || (this->justCover && frameDataQueue.empty() && stagedPts.empty() &&
+            this->videoPacketQueue[tempIndex].empty() && this->videoFrameQueue[tempIndex].empty()))) {//静态画面（封面已显示或没有视频流）：不再轮询，挂起到有跳转、用户操作或结束时再处理
+            this->videoEnd = true;
+            this->loopCheck(loopPending);
+            this->operationApply();
+            std::unique_lock<std::mutex> lock(this->stillMutex);
+            this->stillCv.wait_for(lock, std::chrono::milliseconds(this->loopB.load() > 0 ? CPPPLAYER_STILL_LOOP_POLL : CPPPLAYER_STILL_PARK_MS),
+                [this] {return this->stillWakePending || this->playerShouldEnd; });
+            this->stillWakePending = false;
+            this->statStillWakes.fetch_add(1, std::memory_order_relaxed);
+        }else{
+            if(!shouldCheckKey){
+                startC = std::chrono::system_clock::now();
+                startM = std::chrono::duration_cast<std::chrono::milliseconds>(startC.time_since_epoch());
+                shouldCheckKey = true;
+                this->loopCheck(loopPending);
+#ifdef CPPPLAYER_DEBUG
+            if (!this->offlineMode) {//离线模式没有A-V，也避免输出混入stdout
+                max = (this->audioPts - this->videoPts) / 1000000.0f > max ? (this->audioPts - this->videoPts) / 1000000.0f : max;
+                cout << '\r' << "A-V: " << (this->audioPts - this->videoPts) / 1000000.0f << "   " << max;
+            }
+#endif
+            }else{
+                //100ms检查一次是否播放完毕，并不会造成多大的延迟
+                if(frameDataQueue.empty() && stagedPts.empty() && this->videoPacketQueue[tempIndex].empty() && this->decoderStatus.load() == CPPPLAYER_DECODER_EOF &&
+                    this->videoFrameQueue[tempIndex].empty() && !this->videoTaskBusy.load()){
+                    this->videoEnd = true;
+                }
+                nowC = std::chrono::system_clock::now();
+                nowM = std::chrono::duration_cast<std::chrono::milliseconds>(nowC.time_since_epoch());
+                if (nowM.count() - startM.count() >= 100) {
+                    this->operationApply();
+                    shouldCheckKey = false;
+                }
+            }
+            if(this->decoderPool || this->backgroundMode.load() != CPPPLAYER_BACKGROUND_OFF){//共享调度器模式下画面很多、后台模式下没有新帧，没有帧可取时让出CPU，避免输出线程空转
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+VIDEOOUTPUTTHREAD_END:
+    this->playerShouldEnd = true;
+    if(sinkOpened){
+        sink->close();
+    }
+    this->playerStatus.store(CPPPLAYER_AV_STOP);
+    this->audioDataQueue[this->queueUseIndex.load()].notify_all();
+    this->decoderStatus_cv.notify_all();
+    if (packet) {
+        av_packet_free(&packet);
+    }
+    if (frame) {
+        av_frame_free(&frame);
+    }
+    while (!frameDataQueue.empty()) {
+        frameDataQueue.front().clear();
+        frameDataQueue.pop();
+    }
+    while (!decodedAhead.empty()) {
+        decodedAhead.front().clear();
+        decodedAhead.pop();
+    }
+
+    this->messagePrint("INFO::VIDEO::OUTPUT_END", CPPPLAYER_COLOR_GREEN);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2025-03-26
+* @Version:      1.0
+* @Brief:        音频输出线程，只要没有其他操作，会一直按AudioSink的消耗速度持续写入
+*                如果暂停，那么audioPlayingQueue将不会更新，视频线程将一直获取到静止的pts而不更新画面，从而达到音视频都暂停的效果
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::audioOutputThread(){
+    int bufferCount = this->liveMode ? CPPPLAYER_LIVE_AUDIO_BUFFERS : 8;
+    int prerollWaitMs = this->liveMode ? 5 : 50;
+    size_t prerollCount = 0;
+    int ret = -1;
+    unsigned char nowStatus = CPPPLAYER_AV_UNKNOW;
+    bool audioShortBuffer = false;
+    uint8_t tempIndex = 0;
+    AVDataInfo frame;
+    AudioSink* sink = this->audioSink;
+    bool suspended = false;
+    int64_t suspendClock = 0;
+    int64_t suspendPts = 0;
+    int64_t frameEnd = 0;
+    AVDataInfo pending;
+
+    if(!this->audioStream) return;
+    if (!this->audioDataQueue[this->queueUseIndex.load()].waitFor(10000)) {
+        this->playerShouldEnd = true;
+        return;
+    }
+
+    CPPPLAYER_TRACE_THREAD("audio output");
+    bufferCount = sink->open(this->audioSampleRate, 2, bufferCount);
+    if (bufferCount <= 0) {
+        this->messagePrint("ERROR::AUDIO_SINK::OPEN_FAILED", CPPPLAYER_COLOR_RED);
+        this->playerShouldEnd = true;
+        return;
+    }
+
+    //预缓冲，快速启动时只填几块就开始播放，其余缓冲由下面的循环在播放中补满
+    prerollCount = (size_t)bufferCount;
+    if (this->fastStart && !this->offlineMode) {
+        prerollCount = (size_t)std::min(bufferCount, CPPPLAYER_FASTSTART_AUDIO_PREROLL);
+        prerollWaitMs = CPPPLAYER_FASTSTART_PREROLL_POLL;
+    }
+    ret = 100;
+    while(ret && this->audioDataQueue[this->queueUseIndex.load()].size() < prerollCount){
+        std::this_thread::sleep_for(std::chrono::milliseconds(prerollWaitMs));
+        ret--;
+    }
+    this->audioPlayingQueue.setCapacity(bufferCount);
+    if(ret == 0){
+        prerollCount = this->audioDataQueue[this->queueUseIndex.load()].size();
+    }
+    ret = -1;
+    for (size_t i = 0; i < prerollCount; i++) {
+        if (!this->audioPop(this->queueUseIndex.load(), frame)) break;
+        sink->write(frame);
+        if (this->offlineMode) this->offlineAudioSamples.fetch_add(frame.size / 4, std::memory_order_relaxed);
+        this->audioPlayingQueue.push(frame.pts);
+        this->audioFrameCache.insert(frame);
+    }
+    this->audioPts.store(this->audioPlayingQueue.front());
+    this->audioReady = true;
+    while (!this->videoReady && !this->playerShouldEnd)std::this_thread::sleep_for(std::chrono::milliseconds(this->fastStart ? 1 : 5));
+    sink->play();
+    this->startupMark(this->startupFirstAudioUs, "first audio");
+
+    while (!this->playerShouldEnd) {
+        nowStatus = this->playerStatus.load();
+        if (nowStatus != CPPPLAYER_AV_PLAYING) {
+            this->audioIsWaiting = true;
+            sink->pause();
+            do {
+                if (this->audioShouldFlush) {//跳转操作时，刷新当前帧队列，并更换到另一个帧队列
+                    sink->stop();
+                    this->audioDataQueue[this->queueFlushIndex.load()].clearWithDelete();
+                    ret = this->audioPlayingQueue.size();
+                    while (ret-- > 0) {
+                        this->audioPlayingQueue.pop();
+                    }
+                    this->audioShouldFlush = false;
+                    this->audioSpliceFrom = INT64_MIN;//跳转后的帧不需要再接到切换音轨时的位置
+                    audioShortBuffer = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                nowStatus = this->playerStatus.load();
+            } while ((nowStatus != CPPPLAYER_AV_PLAYING && nowStatus != CPPPLAYER_AV_STOP) || this->audioShouldFlush);
+            if (suspended) {//挂起时不写入，时钟从跳转目标（或暂停时的位置）重新计时
+                suspendPts = audioShortBuffer ? this->seekTargetPts.load() : this->audioPts.load();
+                suspendClock = av_gettime_relative();
+                this->audioPts.store(suspendPts);
+                if (audioShortBuffer) pending.clear();
+                audioShortBuffer = false;
+            }
+            if (audioShortBuffer) {
+                ret = std::min(2, sink->writable());//跳转时不需要等待全部缓冲区填满，先填充2个缓冲更新音频pts，视频得以显示，降低跳转延迟
+                while (ret > 0) {
+                    if (this->audioDataQueue[this->queueUseIndex.load()].empty()) {
+                        if (this->playerStatus.load() != CPPPLAYER_AV_PLAYING || this->playerShouldEnd || this->audioShouldFlush || sink->isSuspended()) {
+                            break;
+                        }
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    else {
+                        if (!this->audioPop(this->queueUseIndex.load(), frame)) continue;
+                        sink->write(frame);
+                        if (this->offlineMode) this->offlineAudioSamples.fetch_add(frame.size / 4, std::memory_order_relaxed);
+                        this->audioFrameCache.insert(frame);
+                        this->audioPlayingQueue.push(frame.pts);
+                        ret--;
+                    }
+                }
+                this->audioPts.store(this->audioPlayingQueue.front());
+                audioShortBuffer = false;
+            }
+            this->audioIsWaiting = false;
+            if (!suspended) sink->play();
+        }
+
+        if (!suspended && !this->offlineMode && sink->isSuspended()) {//输出听不到，停止写入并暂停音频解码，主时钟改为按墙上时钟推进
+            suspended = true;
+            this->audioSuspended.store(true);
+            sink->stop();
+            suspendPts = this->audioPlayingQueue.empty() ? this->seekTargetPts.load() : this->audioPts.load();//跳转后还没有写入时从跳转目标开始
+            suspendClock = av_gettime_relative();
+            ret = this->audioPlayingQueue.size();
+            while (ret-- > 0) {
+                this->audioPlayingQueue.pop();
+            }
+            CPPPLAYER_TRACE_INSTANT("audio suspend", suspendPts);
+        }
+        if (suspended) {
+            tempIndex = this->queueUseIndex.load();
+            this->audioSuspended.store(sink->isSuspended());
+            this->audioPts.store(suspendPts + av_gettime_relative() - suspendClock);
+            while (true) {//丢弃已经播放时刻已过的帧，保留第一个还没播放完的帧
+                if (!pending.data) {
+                    if (this->audioDataQueue[tempIndex].empty()) break;
+                    if (!this->audioPop(tempIndex, pending)) break;
+                }
+                frameEnd = pending.pts + (int64_t)(pending.size / 4) * AV_TIME_BASE / this->audioSampleRate;
+                if (frameEnd > this->audioPts.load()) break;
+                pending.clear();
+            }
+            if (!this->audioSuspended.load() && pending.data && pending.pts <= this->audioPts.load()) {//恢复：主时钟到达第一帧时重新开始写入
+                CPPPLAYER_TRACE_INSTANT("audio resume", pending.pts);
+                sink->write(pending);
+                this->audioPlayingQueue.push(pending.pts);
+                this->audioFrameCache.insert(pending);
+                pending = AVDataInfo();
+                sink->play();
+                this->audioPts.store(this->audioPlayingQueue.front());
+                suspended = false;
+            }
+            else {
+                if (!pending.data && this->audioDataQueue[tempIndex].empty() && this->decoderStatus.load() == CPPPLAYER_DECODER_EOF) {
+                    this->audioEnd = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(CPPPLAYER_AUDIO_SUSPEND_POLL));
+                continue;
+            }
+        }
+
+        tempIndex = this->queueUseIndex.load();
+        ret = sink->writable();
+        if (ret <= 0 && this->decoderPool) {//共享调度器模式下缓冲都在播放时让出CPU，避免输出线程空转
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        while (ret > 0) {
+            if (this->audioDataQueue[tempIndex].empty()) {
+                if(this->decoderStatus.load() == CPPPLAYER_DECODER_EOF){
+                    this->audioEnd = true;
+                    break;
+                }
+                if (this->playerStatus.load() != CPPPLAYER_AV_PLAYING || this->playerShouldEnd || this->audioShouldFlush) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            else {
+                if (!this->audioPop(tempIndex, frame)) continue;
+                if (this->liveMode && this->liveStartClock.load() >= 0 &&
+                    (av_gettime_relative() - this->liveStartClock.load()) - (frame.pts - this->liveStartPts.load()) > 2 * this->liveLatencyTarget) {
+                    CPPPLAYER_TRACE_INSTANT("live drop audio", frame.pts);
+                    delete[] frame.data;//严重落后，直接丢弃这一帧追赶
+                    continue;
+                }
+                {
+                    CPPPLAYER_TRACE_ZONE_ARG("audio write", frame.pts);
+                    sink->write(frame);
+                }
+                if (this->offlineMode) this->offlineAudioSamples.fetch_add(frame.size / 4, std::memory_order_relaxed);
+                this->audioFrameCache.insert(frame);
+                if (this->audioPlayingQueue.full()) this->audioPlayingQueue.pop();//写入的缓冲替换了一个已播放完的缓冲
+                this->audioPlayingQueue.push(frame.pts);
+                ret -= 1;
+            }
+        }
+
+        sink->play();
+        this->audioPts.store(this->audioPlayingQueue.front());
+        if (this->liveMode) {//延迟超过目标时解封装线程在PCM上追赶，降到目标一半以下后恢复
+            this->updateLiveLatency(this->audioPts.load());
+            if (!this->liveCatchUp.load() && this->liveAddedLatency.load() > this->liveLatencyTarget) {
+                CPPPLAYER_TRACE_INSTANT("live catch-up", this->audioPts.load());
+                this->liveCatchUp.store(true);
+            }
+            else if (this->liveCatchUp.load() && this->liveAddedLatency.load() < this->liveLatencyTarget / 2) {
+                this->liveCatchUp.store(false);
+            }
+        }
+    }
+
+    sink->close();
+    pending.clear();
+    this->audioSuspended.store(false);
+
+    this->messagePrint("INFO::AUDIO::OUTPUT_END", CPPPLAYER_COLOR_GREEN);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        给字幕线程放入标记（没有数据的packet）：stream_index与正在使用的流相同时刷新解码器，不同时换用该流（-1为关闭），
+*                两种情况都先清除字幕输出中的事件
+* @Param:        @streamIndex int 之后使用的字幕流
+* @Return:       void
+**/
+void PlayerEngine::subtitleMark(int streamIndex){
+    AVPacket* marker = av_packet_alloc();
+    if (!marker) return;
+    marker->stream_index = streamIndex;
+    this->subtitlePacketQueue.push(marker);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        字幕线程，解码字幕packet并把事件交给字幕输出。解封装领先播放几秒，事件在显示之前就已送出，
+*                字幕输出可以提前光栅化，显示时不再有解码和绘制文字的开销
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::subtitleOutputThread(){
+    SubtitleDecoder decoder;
+    SubtitleEvent event;
+    AVPacket* packet = nullptr;
+    int ret = 0;
+
+    while (!this->playerShouldEnd) {
+        if (!this->subtitlePacketQueue.waitFor(CPPPLAYER_SUBTITLE_POLL)) continue;
+        packet = this->subtitlePacketQueue.pop();
+        if (!packet) continue;
+        if (!packet->data) {//跳转或切换字幕流的标记
+            this->subtitleSink->flush();
+            if (packet->stream_index == decoder.getStreamIndex()) {
+                decoder.flush();
+            }
+            else if (packet->stream_index >= 0) {
+                ret = decoder.open(this->formatContext->streams[packet->stream_index], packet->stream_index, this->videoWidth, this->videoHeight);
+                if (ret != SUBTITLEDECODER_OK) {
+                    this->messagePrint("ERROR::FFMPEG::CAN_NOT_OPEN_SUBTITLE_DECODER", CPPPLAYER_COLOR_RED);
+                }
+            }
+            else {
+                decoder.release();
+            }
+            av_packet_free(&packet);
+            continue;
+        }
+        if (packet->stream_index == decoder.getStreamIndex()) {//标记之前放入的旧字幕流packet直接丢弃
+            CPPPLAYER_TRACE_ZONE("subtitle decode");
+            if (decoder.decode(packet, event)) {
+                this->subtitleSink->show(event);
+                this->statSubtitleEvents.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        av_packet_free(&packet);
+    }
+    this->subtitleSink->flush();
+    this->messagePrint("INFO::SUBTITLE::THREAD_END", CPPPLAYER_COLOR_GREEN);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        离线处理结束（音视频都已输出完毕），记录结束时刻并输出吞吐量
+* @Param:        void
+* @Return:       void
+**/
+void PlayerEngine::offlineFinish(){
+    this->offlineEndClock.store(av_gettime_relative());
+    this->messagePrint(("INFO::OFFLINE::" + this->offlineSummary()).c_str(), CPPPLAYER_COLOR_GREEN);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        离线处理的吞吐量：耗时、处理的媒体时长及倍速、视频帧率、音频采样数
+* @Param:        void
+* @Return:       std::string 单行文本
+**/
+std::string PlayerEngine::offlineSummary(){
+    char buf[160] = { 0 };
+    int64_t end = this->offlineEndClock.load();
+    double wall = ((end >= 0 ? end : av_gettime_relative()) - this->offlineStartClock.load()) / 1000000.0;
+    uint64_t frames = this->statRendered.load(std::memory_order_relaxed);
+    uint64_t samples = this->offlineAudioSamples.load(std::memory_order_relaxed);
+    double media = 0;
+    if (samples && this->audioSampleRate) {
+        media = (double)samples / this->audioSampleRate;
+    }
+    else if (this->videoAvgFrame > 0) {
+        media = frames / this->videoAvgFrame;
+    }
+    snprintf(buf, sizeof(buf), "%.2fs for %.2fs media (%.1fx) video %" PRIu64 " frames %.1ffps audio %" PRIu64 " samples",
+        wall, media, wall > 0 ? media / wall : 0.0, frames, wall > 0 ? frames / wall : 0.0, samples);
+    return buf;
+}
@@ -0,0 +1,583 @@
+#ifndef _PLAYERENGINE_H_
+#define _PLAYERENGINE_H_
+
+/**
+* @File name:    PlayerEngine.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  不依赖Qt的播放引擎：解封装、解码、音视频同步、跳转/循环/帧缓存，
+*                输出通过VideoSink/AudioSink接口，主时钟可由ClockSource替换（默认为音频时钟）
+**/
+
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <queue>
+#include <deque>
+#include <vector>
+#include <functional>
+extern "C" {
+#include "libavutil/avutil.h"
+}
+#include "MediaUse.h"
+#include "MediaIO.h"
+#include "FrameCache.h"
+#include "AsyncLogger.h"
+#include "PlaybackStats.h"
+#include "FrameConverter.h"
+#include "MediaSink.h"
+#include "DecoderPool.h"
+#include "QualityController.h"
+
+struct AVFormatContext;
+struct AVStream;
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2025-03-26
+* @Description:  解码器状态和播放状态的define
+**/
+#define CPPPLAYER_DEFINE
+#define CPPPLAYER_DECODER_UNKNOW     (0x00)
+#define CPPPLAYER_DECODER_EOF		 (0x01)
+#define CPPPLAYER_DECODER_ADVANCE	 (0x02)
+#define CPPPLAYER_DECODER_BACK		 (0x04)
+#define CPPPLAYER_DECODER_PAUSE		 (0x08)
+#define CPPPLAYER_DECODER_STOP		 (0x10)
+#define CPPPLAYER_DECODER_ING		 (0x20)
+#define CPPPLAYER_DECODER_GOTO		 (0x40)
+#define CPPPLAYER_DECODER_BUSY       (0x46)
+
+#define CPPPLAYER_AV_UNKNOW			 (0x00)
+#define CPPPLAYER_AV_PLAYING	     (0x01)
+#define CPPPLAYER_AV_PAUSE			 (0x02)
+#define CPPPLAYER_AV_STOP			 (0x04)
+#define CPPPLAYER_AV_CHANGE			 (0x08)
+#define CPPPLAYER_AV_A_FRAME         (0x10)
+
+//用户操作（postOperation），跳转类操作立即合并到跳转目标，暂停切换在视频线程每100ms取最后一个执行
+#define PLAYERENGINE_OP_PAUSE_TOGGLE (0x01)
+#define PLAYERENGINE_OP_BACK         (0x02)
+#define PLAYERENGINE_OP_ADVANCE      (0x03)
+#define PLAYERENGINE_OP_RESTART      (0x04)
+
+//std::cout输出字符颜色修改
+#define CPPPLAYER_COLOR_RESET		"\033[0m"
+#define CPPPLAYER_COLOR_RED			"\033[31m"
+#define CPPPLAYER_COLOR_GREEN		"\033[32m"
+#define CPPPLAYER_COLOR_YELLOW		"\033[33m"
+#define CPPPLAYER_COLOR_BLUE		"\033[33m"
+
+//直播模式参数：音频预缓冲数、渲染预存帧数、追帧时重采样少输出的采样比例（音调同样升高约5%）、默认目标延迟(ms)
+#define CPPPLAYER_LIVE_AUDIO_BUFFERS    (3)
+#define CPPPLAYER_LIVE_RENDER_QUEUE     (2)
+#define CPPPLAYER_LIVE_CATCHUP_RATIO    (0.05)
+#define CPPPLAYER_LIVE_DEFAULT_TARGET   (200)
+
+//已解码帧缓存：默认视频内存预算、音频内存预算、跳转由缓存供帧所需的最短连续区间(us)、音频帧视为连续的最大间隔(us)
+#define CPPPLAYER_FRAMECACHE_DEFAULT_BUDGET  (256 * 1024 * 1024)
+#define CPPPLAYER_FRAMECACHE_AUDIO_BUDGET    (32 * 1024 * 1024)
+#define CPPPLAYER_FRAMECACHE_MIN_SPAN        (1000000)
+#define CPPPLAYER_FRAMECACHE_AUDIO_GAP       (100000)
+
+//音频输出挂起时：最多保留的音频packet数、早于主时钟多久(us)的packet直接丢弃、挂起时音频线程的轮询间隔(ms)
+#define CPPPLAYER_AUDIO_PARKED_MAX      (512)
+#define CPPPLAYER_AUDIO_PARKED_KEEP     (200000)
+#define CPPPLAYER_AUDIO_SUSPEND_POLL    (5)
+
+//后台模式（窗口隐藏或最小化）：不解码视频、只解码关键帧；后台时音频最多预先解码的帧数（没有视频packet队列限制读取速度）
+#define CPPPLAYER_BACKGROUND_OFF        (0)
+#define CPPPLAYER_BACKGROUND_DISCARD    (1)
+#define CPPPLAYER_BACKGROUND_KEYFRAME   (2)
+#define CPPPLAYER_BACKGROUND_AUDIO_AHEAD (256)
+
+//快速启动：音频预缓冲块数（其余缓冲在播放中补满）、预缓冲轮询间隔(ms)、缩短的探测大小(byte)和分析时长(us)
+#define CPPPLAYER_FASTSTART_AUDIO_PREROLL   (2)
+#define CPPPLAYER_FASTSTART_PREROLL_POLL    (2)
+#define CPPPLAYER_FASTSTART_PROBESIZE       "1048576"
+#define CPPPLAYER_FASTSTART_ANALYZE         "1000000"
+
+//按流统计解封装的packet数和字节数，下标超过该值的流不统计
+#define CPPPLAYER_STREAM_STATS_MAX          (32)
+
+//静态画面（只有封面或没有视频流）时视频线程挂起等待的最长时间（ms），A-B循环时为CPPPLAYER_STILL_LOOP_POLL
+#define CPPPLAYER_STILL_PARK_MS             (500)
+#define CPPPLAYER_STILL_LOOP_POLL           (100)
+
+//字幕线程等待字幕packet的超时（ms），超时后检查是否结束
+#define CPPPLAYER_SUBTITLE_POLL             (100)
+
+//define开启debug，不需要请注释
+#define CPPPLAYER_DEBUG
+
+//define开启流水线追踪（各阶段耗时，按F9导出为Chrome trace JSON），需要时取消注释
+//#define CPPPLAYER_TRACE
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  文件中的一条音轨，streamIndex用于setAudioTrack，语言和标题来自流的metadata（没有时为空）
+    **/
+    class AudioTrackInfo {
+    public:
+        AudioTrackInfo();
+        int streamIndex;
+        std::string language;
+        std::string title;
+        std::string codec;
+        int sampleRate;
+        int channels;
+        bool selected;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  文件中的一条字幕，streamIndex用于setSubtitleTrack，bitmap表示图形字幕（PGS/DVB/DVD）
+    **/
+    class SubtitleTrackInfo {
+    public:
+        SubtitleTrackInfo();
+        int streamIndex;
+        std::string language;
+        std::string title;
+        std::string codec;
+        bool bitmap;
+        bool selected;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  播放引擎，三个线程：解封装/音频解码、视频解码/输出（同时响应用户操作）、音频输出。
+    *                使用共享解码调度器（setDecoderPool）时解封装/音频解码和视频解码由调度器的任务执行，只保留两个输出线程。
+    *                未设置输出时视频丢弃（NullVideoSink），音频不限速丢弃（WavAudioSink）；设置了字幕输出且文件有字幕流时另有字幕线程
+    **/
+    class PlayerEngine :public ClockSource {
+    public:
+        PlayerEngine();
+        ~PlayerEngine();
+
+        void setVideoSink(VideoSink* sink);
+        void setAudioSink(AudioSink* sink);
+        void setSubtitleSink(SubtitleSink* sink);
+        void setClockSource(ClockSource* clock);
+        void setEndCallback(std::function<void()> callback);
+        void setDecoderPool(MediaUse::DecoderPool* pool, int priority = DECODERPOOL_PRIORITY_NORMAL);
+        void setDecoderPriority(int priority);
+        int64_t now() override;
+
+        void setPath(const std::string str);
+        std::string getPath();
+        bool avOpen();
+        void avStart();
+        void join();
+        void avStop();
+        bool avPause();
+        bool avResume();
+        void setOffset(std::pair<int64_t, AVRational> x);
+        bool setCurrentPts(std::pair<int64_t, AVRational> x);
+        void avAdvance();
+        void avBack();
+        bool avRestart();
+        void postOperation(uint8_t operation);
+        bool isRunning();
+        bool playerCouldBeOperate();
+        uint8_t getPlayStatus();
+        uint8_t getDecoderStatus();
+        std::pair<int64_t, AVRational> getCurrentPts();
+        std::pair<int64_t, AVRational> getDuration();
+        void setIOMode(uint8_t mode, int blockSize = MEDIAIO_DEFAULT_BLOCK_SIZE, int blockCount = MEDIAIO_DEFAULT_BLOCK_COUNT, int prefetchBlocks = MEDIAIO_DEFAULT_PREFETCH);
+        void setIOThrottle(int latencyUs, int64_t bytesPerSecond);
+        MediaUse::AVIOStats getIOStats();
+        void setLiveMode(bool live, int64_t latencyTargetMs = CPPPLAYER_LIVE_DEFAULT_TARGET);
+        bool isLiveMode();
+        int64_t getLiveAddedLatency();
+        int64_t getLiveEndToEndLatency();
+        void setFrameCache(size_t budget, int downscale = 1);
+        MediaUse::FrameCacheStats getFrameCacheStats();
+        bool setABLoop(std::pair<int64_t, AVRational> a, std::pair<int64_t, AVRational> b);
+        void setLoopStart(int64_t pts);
+        bool setLoopEnd(int64_t pts);
+        void clearABLoop();
+        int64_t getLoopStart();
+        int64_t getLoopEnd();
+        bool dumpTrace(const std::string& tracePath = "");
+        void setLogLevel(uint8_t level, uint32_t rateLimitPerSecond = ASYNCLOGGER_RATE_LIMIT);
+        MediaUse::PlaybackStats getStats();
+        void setOfflineMode(bool offline);
+        bool isOfflineMode();
+        bool setBackground(bool background, uint8_t mode = CPPPLAYER_BACKGROUND_DISCARD);
+        bool isBackground();
+        double getBackgroundSavedMs();
+        void setFastStart(bool fast);
+        bool isFastStart();
+        void setSeamlessLoop(bool loop);
+        bool isSeamlessLoop();
+        std::vector<AudioTrackInfo> getAudioTracks();
+        int getAudioTrack();
+        bool setAudioTrack(int streamIndex);
+        std::vector<SubtitleTrackInfo> getSubtitleTracks();
+        int getSubtitleTrack();
+        bool setSubtitleTrack(int streamIndex);
+        std::vector<MediaUse::StreamStats> getStreamStats();
+        void setAdaptiveQuality(bool enable);
+        bool isAdaptiveQuality();
+        MediaUse::QualityStats getQualityStats();
+        std::string getOfflineReport();
+        void messagePrint(const char* str, const char* color);
+
+    private:
+
+        bool videoDecoderOneFrame(MediaUse::VideoFrameConverter& converter, AVPacket*& packet, AVFrame*& frame, std::queue<MediaUse::AVDataInfo>& frameDataQueue);
+        void avClear();
+        void avInit();
+        bool ioOpen();
+        void ioClose();
+        void ioPublish();
+        void ffmpegErrorPrint(int errEnum);
+        void updateLiveLatency(int64_t pts);
+        int64_t frameCacheCoverage(int64_t targetPts, int64_t& audioStart);
+
+        void ffmpegReadThread();
+        bool readPrepare();
+        int readStep(int64_t budgetUs, uint64_t& units);
+        void readFinish();
+        int readTask(int64_t budgetUs, uint64_t& units);
+        int videoDecodeTask(int64_t budgetUs, uint64_t& units);
+        void videoOutputThread();
+        void audioOutputThread();
+        void subtitleOutputThread();
+        void subtitleMark(int streamIndex);
+        void offlineFinish();
+        std::string offlineSummary();
+        void qualityApply(MediaUse::VideoFrameConverter& converter);
+        void startupMark(std::atomic<int64_t>& mark, const char* name);
+        bool requestSeek(int64_t pts, bool relative);
+        void stillWake();
+        void loopCheck(bool& pending);
+        void operationApply();
+        bool readLoopWrap();
+        AVCodecContext* audioDecoderOpen(AVStream* stream);
+        bool readAudioTrackSwitch();
+        bool audioPop(uint8_t index, MediaUse::AVDataInfo& frame);
+        int64_t loopWrapPts(int64_t pts);
+
+        //跳转时给视频或音频输出线程刷新信号，即告诉线程队列的数据是过时或超时的，需要清空和切换队列
+        bool videoShouldFlush;
+        bool audioShouldFlush;
+
+        //表示视频或音频输出准备完毕，随时可以开始
+        bool videoReady;
+        bool audioReady;
+
+        //表示音频线程正在等待某些条件而暂停输出
+        bool audioIsWaiting;
+
+        //表示是否该结束播放和解码了，用于控制整个播放器的随时退出
+        bool playerShouldEnd;
+
+        //表示视频流是否只有一张图片（或mp3封面）
+        bool justCover;
+
+        //直播模式（RTSP/UDP等），减少预缓冲并在延迟超过目标时追帧
+        bool liveMode;
+
+        //视频线程当前是否在使用解码器，避免在使用解码器时解码线程对解码器进行刷新操作导致视频解码异常
+        bool videoIsDecoding;
+
+        //判断音视频是否播放完毕，以便在设置循环播放模式下重新解码播放
+        bool videoEnd;
+        bool audioEnd;
+
+        //对在多线程中经常读写的变量操作原子化
+        std::atomic<uint8_t> queueUseIndex;
+        std::atomic<uint8_t> queueFlushIndex;
+        std::atomic<uint8_t> decoderStatus;
+        std::atomic<uint8_t> playerStatus;
+        std::atomic<int64_t> videoPts;
+        std::atomic<int64_t> audioPts;
+
+        //直播延迟测量：第一个packet到达的时钟和pts（us），当前播放帧相对于到达时刻的附加延迟（us），
+        //发送端时钟（start_time_realtime，AV_NOPTS_VALUE表示没有）和由它得到的端到端延迟（us，-1表示没有）
+        std::atomic<int64_t> liveStartClock;
+        std::atomic<int64_t> liveStartPts;
+        std::atomic<int64_t> liveAddedLatency;
+        std::atomic<int64_t> liveSenderClock;
+        std::atomic<int64_t> liveEndToEnd;
+
+        //直播追帧：音频线程根据附加延迟设置，解封装线程转换音频时据此设置重采样补偿
+        std::atomic<bool> liveCatchUp;
+        int64_t liveLatencyTarget;
+
+        //已解码帧缓存，跳转目标之后有足够长的连续缓存时由缓存直接供帧，解码器从缓存区间末尾继续解码
+        //cacheServeFrom/Until为视频线程需要从缓存取帧的区间（-1表示不使用），videoSkipUntil/audioSkipUntil之前的帧解码后直接丢弃
+        MediaUse::FrameCache videoFrameCache;
+        MediaUse::FrameCache audioFrameCache;
+        size_t frameCacheBudget;
+        int frameCacheDownscale;
+        std::atomic<int64_t> cacheServeFrom;
+        std::atomic<int64_t> cacheServeUntil;
+        std::atomic<int64_t> videoSkipUntil;
+        std::atomic<int64_t> audioSkipUntil;
+
+        //精确跳转：videoSkipUntil/audioSkipUntil为跳转目标（而非缓存末尾）时为true，
+        //目标之前的视频帧解码后不转换直接丢弃（非参考帧不解码），跨过目标的音频帧裁剪到目标采样
+        std::atomic<bool> seekExact;
+        std::atomic<uint64_t> statPrerollDropped;
+        std::atomic<uint64_t> seekCount;
+        std::atomic<uint64_t> seekFromCache;
+
+        //A-B循环区间（us），-1表示未设置
+        std::atomic<int64_t> loopA;
+        std::atomic<int64_t> loopB;
+
+        //运行统计，各线程只做relaxed原子累加，getStats时汇总，解码耗时单位为us
+        std::atomic<uint64_t> statVideoDecoded;
+        std::atomic<uint64_t> statVideoDecodeUs;
+        std::atomic<uint64_t> statAudioDecoded;
+        std::atomic<uint64_t> statAudioDecodeUs;
+        std::atomic<uint64_t> statRendered;
+        std::atomic<uint64_t> statDropped;
+        std::atomic<uint64_t> statLate;
+        std::atomic<int64_t> statAvOffset;
+        std::atomic<uint64_t> statAvHistogram[PLAYBACKSTATS_AV_BUCKETS];
+        std::atomic<size_t> statFrameQueue;
+
+        //帧率统计窗口，只在调用getStats的线程（界面线程）使用
+        int64_t statWindowStart;
+        uint64_t statWindowDecoded;
+        uint64_t statWindowRendered;
+        double statDecodeFps;
+        double statRenderFps;
+
+        //离线模式：不按时钟和帧率限速，吞吐量按offlineStartClock到offlineEndClock计算（us）
+        bool offlineMode;
+        std::atomic<int64_t> offlineStartClock;
+        std::atomic<int64_t> offlineEndClock;
+        std::atomic<uint64_t> offlineAudioSamples;
+
+        //文件解码信息
+        float videoAvgFrame;
+        int audioSampleRate;
+        int videoStreamIndex;
+        int audioStreamIndex;
+        int subtitleStreamIndex;
+        int videoWidth;
+        int videoHeight;
+
+        //文件路径或地址
+        std::string path;
+
+        //自定义IO设置（MEDIAIO_MODE_xxx，块大小、块数、预读块数），在avOpen时生效
+        uint8_t ioMode;
+        int ioBlockSize;
+        int ioBlockCount;
+        int ioPrefetchBlocks;
+
+        //自定义IO，仅本地文件且ioMode不为默认时使用，只在打开/解封装线程访问。
+        //统计由解封装线程每读取一个packet发布到ioStatXxx（avClear时发布最后一次），getIOStats只读取这些原子计数
+        MediaUse::MediaIO* mediaIO;
+        std::atomic<uint64_t> ioStatBytesRead;
+        std::atomic<uint64_t> ioStatBytesDelivered;
+        std::atomic<uint64_t> ioStatSyscalls;
+        std::atomic<uint64_t> ioStatCacheHits;
+        std::atomic<uint64_t> ioStatCacheMisses;
+        std::atomic<uint64_t> ioStatPrefetched;
+
+        //限速读取（测试用，模拟慢速存储），设置后本地文件的自定义IO读取源外包一层ThrottledSource，两者由播放器持有
+        int ioThrottleLatency;
+        int64_t ioThrottleBandwidth;
+        MediaUse::AVIOSource* ioSource;
+        MediaUse::AVIOSource* ioThrottle;
+
+        //音视频时长 <size,单位>
+        std::pair<int64_t, AVRational> duration;
+
+        //单次前进或后退偏移时长
+        std::pair<int64_t, AVRational> offset;
+
+        //跳转请求：每次请求更新seekRequestPts（us）并递增seekGeneration，解封装任务发现与seekApplied不同时立即跳转，
+        //正在进行的跳转（等待音频线程、解码到目标）被新的目标取代；seekCompleted为最近一次恢复播放的请求，
+        //与seekGeneration不同时快进/后退以seekRequestPts为基准累加。seekMutex保护目标与序号的一致性
+        std::mutex seekMutex;
+        std::atomic<int64_t> seekRequestPts;
+        std::atomic<uint64_t> seekGeneration;
+        std::atomic<uint64_t> seekApplied;
+        std::atomic<uint64_t> seekCompleted;
+        std::atomic<uint64_t> statSeekCoalesced;
+        std::atomic<uint64_t> statSeekPreempted;
+
+        //FFmpeg资源
+        AVRational videoTimeBase;
+        AVRational audioTimeBase;
+        AVFormatContext* formatContext;
+        AVStream* videoStream;
+        AVStream* audioStream;
+        AVCodecContext* videoCodecContext;
+        AVCodecContext* audioCodecContext;
+        MediaUse::AudioFrameConverter audioConverter;
+
+        //输出和主时钟，avStart之前设置，播放中不可更换
+        VideoSink* videoSink;
+        AudioSink* audioSink;
+        SubtitleSink* subtitleSink;
+        ClockSource* clockSource;
+        NullVideoSink nullVideoSink;
+        WavAudioSink nullAudioSink;
+
+        //音视频都播放完毕时在解码线程调用，循环播放需要在回调之外（如另一个线程）执行avRestart
+        std::function<void()> endCallback;
+
+        //视频流包队列、音频流帧队列，采用双队列机制，确保跳转时ffmpeg无需等待两个子线程放弃或清空当前队列，直接读取和解码到另一个队列
+        MediaUse::MediaDataQueue<AVPacket*> videoPacketQueue[2];
+        MediaUse::MediaDataQueue<MediaUse::AVDataInfo> audioDataQueue[2];
+
+        //用户操作队列（PLAYERENGINE_OP_xxx）
+        MediaUse::MediaDataQueue<uint8_t> userOperationQueue;
+
+        //用于当前音频播放帧的pts存储，即音频输出每写入一个缓冲块，audioPlayingQueue同步push一个（满时先pop已播放完的）
+        MediaUse::AVFifoLoop<int64_t> audioPlayingQueue;
+
+        //三个线程，每次更换文件播放会重新new；使用共享调度器时ffmpegThread和videoDecodeThread为调度器任务的完成信号
+        std::future<void>* ffmpegThread;
+        std::future<void>* videoThread;
+        std::future<void>* audioThread;
+        std::future<void>* videoDecodeThread;
+        std::future<void>* subtitleThread;
+
+        //共享解码调度器（为空时使用自己的线程），avStart时注册为调用者，解封装/音频解码和视频解码作为两个任务运行
+        MediaUse::DecoderPool* decoderPool;
+        int decoderPoolPriority;
+        int decoderPoolClient;
+        std::promise<void> readTaskDone;
+        std::promise<void> videoTaskDone;
+
+        //解封装跨越多次调用（调度器时间片）保存的状态：读取用的packet、因队列满尚未放入的视频packet、
+        //是否处于EOF、是否已通知播放结束、跳转后是否在等待音频线程
+        AVPacket* readPacket;
+        AVFrame* readFrame;
+        bool readPrepared;
+        bool readPacketPending;
+        bool readAtEof;
+        bool readEndNotified;
+        bool readSeekWaiting;
+
+        //音频输出挂起（AudioSink::isSuspended，如混音中静音且不在焦点）时不解码音频，主时钟由音频线程按墙上时钟推进。
+        //audioParked为挂起期间保留的最近的音频packet（解封装任务使用），恢复时先刷新解码器再解码它们；
+        //seekTargetPts为最近一次跳转的目标（us），挂起期间跳转后作为时钟起点
+        std::atomic<bool> audioSuspended;
+        std::deque<AVPacket*> audioParked;
+        bool audioParkedFlush;
+        std::atomic<int64_t> seekTargetPts;
+        std::atomic<uint64_t> statAudioSkipped;
+
+        //后台模式（CPPPLAYER_BACKGROUND_xxx），音频照常播放，视频packet按模式丢弃；回到前台时跳转到音频时钟重新同步
+        //statVideoSkipped为后台丢弃的视频packet数，backgroundSince为进入后台的时刻（-1表示在前台），statBackgroundUs为累计后台时间
+        std::atomic<uint8_t> backgroundMode;
+        std::atomic<uint64_t> statVideoSkipped;
+        std::atomic<int64_t> backgroundSince;
+        std::atomic<int64_t> statBackgroundUs;
+
+        //自适应画质：解码线程每次解码后把耗时交给控制器，等级变化时在解码线程设置解码器的skip_xxx和转换质量，
+        //qualityApplied为已设置到解码器的等级，只在解码线程（或调度器的视频解码任务）中使用
+        MediaUse::QualityController qualityController;
+        int qualityApplied;
+
+        //快速启动：第一帧解码后立即显示，不等待音频预缓冲；音频只预缓冲CPPPLAYER_FASTSTART_AUDIO_PREROLL块就开始播放
+        //startupClock为avOpen开始的时刻，startupOpenUs/FirstVideoUs/FirstAudioUs为从该时刻到打开完成、第一帧显示、音频开始播放的时间，-1表示尚未发生
+        bool fastStart;
+        std::atomic<int64_t> startupClock;
+        std::atomic<int64_t> startupOpenUs;
+        std::atomic<int64_t> startupFirstVideoUs;
+        std::atomic<int64_t> startupFirstAudioUs;
+
+        //无缝循环：读到文件末尾时不进入EOF，取出音频解码器剩余的帧并给视频线程放入排空标记（空packet），解封装跳回开头继续读取，
+        //之后的packet时间戳加上loopOffset（us）接在上一遍末尾loopTailEnd之后，音频采样连续、视频按时钟衔接，开头部分在上一遍播完前就已读取解码。
+        //loopStart/loopPeriod为文件开始时刻和一遍的时长，对外的播放位置按它们折回文件内的时间；跳转后loopOffset清零
+        std::atomic<bool> seamlessLoop;
+        std::atomic<int64_t> loopOffset;
+        std::atomic<int64_t> loopStart;
+        std::atomic<int64_t> loopPeriod;
+        int64_t loopTailEnd;
+        std::atomic<uint64_t> statLoops;
+
+        //音轨切换：setAudioTrack只把请求的流下标放入audioTrackPendingIndex（audioTrackMutex保护，audioStreamIndex的修改也在锁内），
+        //解封装任务在两次读取之间打开新音轨的解码器并换上，然后把解封装退回到音频时钟处重新读取新音轨，重新读到的视频packet（dts不大于readVideoDtsFloor）不重复放入队列，视频不跳转。
+        //readVideoDts为最近读到的视频dts；readVideoDtsFloor只在换上音轨时设置，第一个超过它的packet之后清除（INT64_MIN），直播不使用。
+        //audioSplicing期间音频线程丢弃旧音轨尚未写入的帧，直到拼接标记（空帧）；之后新音轨的帧从已写入的位置audioSpliceFrom接上。
+        //audioWrittenEnd为音频线程最近取出的帧的结束时刻，audioSpliceFrom/audioWrittenEnd只在音频线程使用
+        std::mutex audioTrackMutex;
+        int audioTrackPendingIndex;
+        std::atomic<bool> audioTrackReady;
+        std::atomic<bool> audioSplicing;
+        int64_t readVideoDts;
+        int64_t readVideoDtsFloor;
+        int64_t audioSpliceFrom;
+        int64_t audioWrittenEnd;
+        std::atomic<uint64_t> statTrackSwitches;
+
+        //字幕：解封装任务把subtitleStreamIndex的packet放入subtitlePacketQueue，字幕线程解码后交给subtitleSink（事件早于显示时间送出）。
+        //跳转和切换字幕流时放入标记（没有数据的packet，stream_index为之后使用的字幕流，-1为关闭），字幕线程据此刷新或重新打开解码器。
+        //subtitleTrackRequest为setSubtitleTrack请求的流，解封装任务在两次读取之间换上；readSubtitlePts用于切换音轨退回重新读取时去重
+        MediaUse::MediaDataQueue<AVPacket*> subtitlePacketQueue;
+        std::atomic<int> subtitleTrackRequest;
+        int64_t readSubtitlePts;
+        std::atomic<uint64_t> statSubtitleEvents;
+
+        //每个流av_read_frame返回的packet数和字节数，用于确认不播放的流（AVDISCARD_ALL）不再被读取和解析
+        std::atomic<uint64_t> statStreamPackets[CPPPLAYER_STREAM_STATS_MAX];
+        std::atomic<uint64_t> statStreamBytes[CPPPLAYER_STREAM_STATS_MAX];
+
+        //调度器模式的视频解码任务：解码后的帧放入videoFrameQueue（与videoPacketQueue对应的双队列），视频线程只负责输出
+        //videoTaskBusy在任务取下标到帧入队期间为true，视频线程刷新队列前需要等待
+        //videoTaskShouldFlush由跳转在切换队列前置位，任务取下标后刷新解码器（解码器只在任务中使用）
+        MediaUse::MediaDataQueue<MediaUse::AVDataInfo> videoFrameQueue[2];
+        MediaUse::VideoFrameConverter videoTaskConverter;
+        AVFrame* videoTaskFrame;
+        bool videoTaskPacketSent;
+        bool videoTaskCoverDrained;
+        std::atomic<bool> videoTaskBusy;
+        std::atomic<bool> videoTaskShouldFlush;
+
+        //解码状态锁，ffmpeg线程解码完后会使用条件变量等待其他信号激活
+        std::mutex decoderStatus_mutex;
+        std::condition_variable decoderStatus_cv;
+
+        //静态画面时视频线程画面已上传，不再轮询，在stillCv上挂起；跳转、用户操作、A-B循环变化和结束时由stillWake唤醒
+        //（窗口大小变化由界面线程用已上传的纹理重绘，不需要唤醒）。statStillWakes为挂起后被唤醒或超时的次数
+        std::mutex stillMutex;
+        std::condition_variable stillCv;
+        bool stillWakePending;
+        std::atomic<uint64_t> statStillWakes;
+
+        //debug日志，异步写入 文件名_log.txt
+#ifdef CPPPLAYER_DEBUG
+        MediaUse::AsyncLogger log;
+#endif
+    };
+
+
+};
+
+
+#endif//_PLAYERENGINE_H_
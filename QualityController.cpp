@@ -0,0 +1,265 @@
+#include "QualityController.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  QualityController.h的实现
+**/
+
+#include <cstdio>
+#include <cinttypes>
+#include <algorithm>
+
+using namespace MediaUse;
+
+
+static const char* qualityLevelNames[QUALITYCONTROLLER_LEVEL_MAX + 1] = {
+    "full", "fast scale", "skip loop filter", "skip idct", "skip non-ref", "half size"
+};
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+QualityDecision::QualityDecision() :time(0), pts(0), from(0), to(0), load(0) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+QualityStats::QualityStats() :enabled(false), level(QUALITYCONTROLLER_LEVEL_FULL), load(0), restoreHoldUs(0), degrades(0), restores(0) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        画质等级的名称
+* @Param:        @level int QUALITYCONTROLLER_LEVEL_xxx
+* @Return:       const char*
+**/
+const char* QualityStats::levelName(int level) {
+    if (level < 0 || level > QUALITYCONTROLLER_LEVEL_MAX) return "unknown";
+    return qualityLevelNames[level];
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        转换为可读文本（一行状态，之后每行一个决策）
+* @Param:        void
+* @Return:       std::string
+**/
+std::string QualityStats::toString() const {
+    char buf[256] = { 0 };
+    std::string str;
+    snprintf(buf, sizeof(buf), "quality %s (%d/%d)  load %.2f  down %" PRIu64 "  up %" PRIu64 "  up hold %.1f s%s",
+        levelName(this->level), this->level, QUALITYCONTROLLER_LEVEL_MAX, this->load, this->degrades, this->restores,
+        this->restoreHoldUs / 1000000.0, this->enabled ? "" : "  (disabled)");
+    str += buf;
+    for (size_t i = 0; i < this->decisions.size(); i++) {
+        snprintf(buf, sizeof(buf), "\n  %.1f s  pts %.2f s  %s -> %s  load %.2f", this->decisions[i].time / 1000000.0, this->decisions[i].pts / 1000000.0,
+            levelName(this->decisions[i].from), levelName(this->decisions[i].to), this->decisions[i].load);
+        str += buf;
+    }
+    return str;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数，默认开启
+* @Param:        void
+* @Return:       void
+**/
+QualityController::QualityController() :enabled(true) {
+    this->reset(0);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        开启或关闭，关闭时立即回到原画质
+* @Param:        @enable bool
+* @Return:       void
+**/
+void QualityController::setEnabled(bool enable) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->enabled = enable;
+    if (!enable) this->level = QUALITYCONTROLLER_LEVEL_FULL;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否开启
+* @Param:        void
+* @Return:       bool
+**/
+bool QualityController::isEnabled() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->enabled;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开新文件时重置为原画质并清空统计
+* @Param:        @frameIntervalUs double 标称帧间隔（us），不大于0时不做调整
+* @Return:       void
+**/
+void QualityController::reset(double frameIntervalUs) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->level = QUALITYCONTROLLER_LEVEL_FULL;
+    this->frameIntervalUs = frameIntervalUs;
+    this->load = 0;
+    this->lastPts = INT64_MIN;
+    this->startTime = -1;
+    this->overSince = -1;
+    this->underSince = -1;
+    this->lastRestore = -1;
+    this->restoreHoldUs = QUALITYCONTROLLER_RESTORE_HOLD_US;
+    this->degrades = 0;
+    this->restores = 0;
+    this->decisions.clear();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        记录一帧的解码耗时并决定画质等级。负载样本为耗时除以与上一帧的pts间隔（不解码非参考帧时间隔变大，负载随之下降），
+*                pts间隔异常（跳转、乱序）时使用标称帧间隔。负载持续过高降一级，持续有余量升一级，
+*                升级后很快又需要降级时下次升级的等待时间加倍，避免在两个等级间来回切换
+* @Param:        @costUs int64_t 这一帧解码和转换的耗时（us）
+*                @pts int64_t 这一帧的pts（us）
+*                @now int64_t 当前时刻（us）
+* @Return:       int 应使用的等级
+**/
+int QualityController::update(int64_t costUs, int64_t pts, int64_t now) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    double interval = this->frameIntervalUs;
+    double sample = 0;
+    if (!this->enabled || this->frameIntervalUs <= 0) return this->level;
+    if (this->startTime < 0) this->startTime = now;
+    if (this->lastPts != INT64_MIN && pts > this->lastPts && pts - this->lastPts <= 8 * this->frameIntervalUs) {
+        interval = (double)(pts - this->lastPts);
+    }
+    this->lastPts = pts;
+    sample = costUs / interval;
+    this->load = this->load * (1 - QUALITYCONTROLLER_EWMA_ALPHA) + sample * QUALITYCONTROLLER_EWMA_ALPHA;
+
+    if (this->load > QUALITYCONTROLLER_DEGRADE_LOAD) {
+        this->underSince = -1;
+        if (this->overSince < 0) this->overSince = now;
+        if (now - this->overSince >= QUALITYCONTROLLER_DEGRADE_HOLD_US && this->level < QUALITYCONTROLLER_LEVEL_MAX) {
+            if (this->lastRestore >= 0 && now - this->lastRestore < 2 * this->restoreHoldUs) {//刚升级就又过载，下次升级等更久
+                this->restoreHoldUs = std::min<int64_t>(this->restoreHoldUs * 2, QUALITYCONTROLLER_RESTORE_HOLD_MAX_US);
+            }
+            this->change(this->level + 1, pts, now);
+            this->degrades++;
+        }
+    }
+    else if (this->load < QUALITYCONTROLLER_RESTORE_LOAD) {
+        this->overSince = -1;
+        if (this->underSince < 0) this->underSince = now;
+        if (now - this->underSince >= this->restoreHoldUs && this->level > QUALITYCONTROLLER_LEVEL_FULL) {
+            this->change(this->level - 1, pts, now);
+            this->lastRestore = now;
+            this->restores++;
+        }
+    }
+    else {
+        this->overSince = -1;
+        this->underSince = -1;
+    }
+    return this->level;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        当前等级
+* @Param:        void
+* @Return:       int QUALITYCONTROLLER_LEVEL_xxx
+**/
+int QualityController::getLevel() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->level;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        状态快照
+* @Param:        void
+* @Return:       QualityStats
+**/
+QualityStats QualityController::getStats() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    QualityStats stats;
+    stats.enabled = this->enabled;
+    stats.level = this->level;
+    stats.load = this->load;
+    stats.restoreHoldUs = this->restoreHoldUs;
+    stats.degrades = this->degrades;
+    stats.restores = this->restores;
+    stats.decisions = this->decisions;
+    return stats;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        切换等级并记录决策，重新开始计时（调用时持有mutex）
+* @Param:        @to int 新等级
+*                @pts int64_t
+*                @now int64_t
+* @Return:       void
+**/
+void QualityController::change(int to, int64_t pts, int64_t now) {
+    QualityDecision decision;
+    decision.time = now - this->startTime;
+    decision.pts = pts;
+    decision.from = this->level;
+    decision.to = to;
+    decision.load = this->load;
+    if (this->decisions.size() >= QUALITYCONTROLLER_HISTORY) this->decisions.erase(this->decisions.begin());
+    this->decisions.push_back(decision);
+    this->level = to;
+    this->overSince = -1;
+    this->underSince = -1;
+}
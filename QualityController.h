@@ -0,0 +1,122 @@
+#ifndef _QUALITYCONTROLLER_H_
+#define _QUALITYCONTROLLER_H_
+
+/**
+* @File name:    QualityController.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  解码过载时的自适应画质控制：比较每帧解码（含转换）耗时与帧间隔，持续过载时逐级降低画质，
+*                持续有余量时逐级恢复，带滞回和回退，不依赖Qt
+**/
+
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+
+//画质等级，逐级累加
+#define QUALITYCONTROLLER_LEVEL_FULL            (0)//原画质
+#define QUALITYCONTROLLER_LEVEL_FAST_SCALE      (1)//转换使用SWS_FAST_BILINEAR
+#define QUALITYCONTROLLER_LEVEL_SKIP_LOOP       (2)//skip_loop_filter = AVDISCARD_ALL（不做去块滤波）
+#define QUALITYCONTROLLER_LEVEL_SKIP_IDCT       (3)//skip_idct = AVDISCARD_NONREF（非参考帧不做IDCT）
+#define QUALITYCONTROLLER_LEVEL_SKIP_NONREF     (4)//skip_frame = AVDISCARD_NONREF（不解码非参考帧，帧率下降）
+#define QUALITYCONTROLLER_LEVEL_HALF_SIZE       (5)//以一半分辨率转换后放大
+#define QUALITYCONTROLLER_LEVEL_MAX             (5)
+
+//负载为解码耗时/帧间隔的指数平均；超过DEGRADE持续DEGRADE_HOLD降一级，低于RESTORE持续RESTORE_HOLD升一级
+#define QUALITYCONTROLLER_DEGRADE_LOAD          (0.85)
+#define QUALITYCONTROLLER_RESTORE_LOAD          (0.45)
+#define QUALITYCONTROLLER_DEGRADE_HOLD_US       (1000000)
+#define QUALITYCONTROLLER_RESTORE_HOLD_US       (4000000)
+#define QUALITYCONTROLLER_RESTORE_HOLD_MAX_US   (64000000)//恢复后很快又过载时等待时间加倍，最多到此值
+#define QUALITYCONTROLLER_EWMA_ALPHA            (0.1)
+#define QUALITYCONTROLLER_HISTORY               (32)//保留的最近决策数
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  一次画质调整，time为相对于reset的时间（us），load为调整时的负载
+    **/
+    class QualityDecision {
+    public:
+        QualityDecision();
+        int64_t time;
+        int64_t pts;
+        int from;
+        int to;
+        double load;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  自适应画质状态快照
+    **/
+    class QualityStats {
+    public:
+        QualityStats();
+        std::string toString() const;
+        static const char* levelName(int level);
+        bool enabled;
+        int level;
+        double load;
+        int64_t restoreHoldUs;//当前升级所需的持续时间（含回退加倍）
+        uint64_t degrades;
+        uint64_t restores;
+        std::vector<QualityDecision> decisions;//最近的决策，最早的在前
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  自适应画质控制器，线程安全。解码线程每解码一帧调用update，按返回的等级设置解码器和转换，
+    *                界面线程通过getStats读取
+    **/
+    class QualityController {
+    public:
+        QualityController();
+
+        void setEnabled(bool enable);
+        bool isEnabled();
+        void reset(double frameIntervalUs);
+        int update(int64_t costUs, int64_t pts, int64_t now);
+        int getLevel();
+        QualityStats getStats();
+
+    private:
+        void change(int to, int64_t pts, int64_t now);
+
+        bool enabled;
+        int level;
+        double frameIntervalUs;//标称帧间隔，pts间隔不可用时使用
+        double load;
+        int64_t lastPts;
+        int64_t startTime;//reset后第一次update的时刻，-1表示尚未开始
+        int64_t overSince;//负载持续高于DEGRADE的起始时刻，-1表示没有
+        int64_t underSince;
+        int64_t lastRestore;//最近一次升级的时刻，-1表示没有
+        int64_t restoreHoldUs;
+        uint64_t degrades;
+        uint64_t restores;
+        std::vector<QualityDecision> decisions;
+        std::mutex mutex;
+    };
+
+
+};
+
+
+#endif//_QUALITYCONTROLLER_H_
@@ -0,0 +1,269 @@
+#include "SubtitleDecoder.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  SubtitleDecoder.h的实现
+**/
+
+extern "C"{
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+}
+
+#include <cstring>
+
+using namespace MediaUse;
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+SubtitleRect::SubtitleRect() :x(0), y(0), width(0), height(0) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+SubtitleEvent::SubtitleEvent() :start(0), end(INT64_MAX), canvasWidth(0), canvasHeight(0), bitmap(false) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+SubtitleDecoder::SubtitleDecoder() :context(nullptr), streamIndex(-1), canvasWidth(0), canvasHeight(0) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构函数
+* @Param:        void
+* @Return:       void
+**/
+SubtitleDecoder::~SubtitleDecoder() {
+    this->release();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开字幕流的解码器，已打开时先释放。图形字幕的画布为解码器给出的宽高（PGS解码后才知道），没有时（如部分DVB字幕）使用视频大小
+* @Param:        @stream AVStream* 字幕流
+*                @streamIndex int 流下标
+*                @videoWidth int 视频宽
+*                @videoHeight int 视频高
+* @Return:       int SUBTITLEDECODER_OK 或 SUBTITLEDECODER_ERROR_xxx
+**/
+int SubtitleDecoder::open(AVStream* stream, int streamIndex, int videoWidth, int videoHeight) {
+    const AVCodec* codec = nullptr;
+    this->release();
+    codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!codec) return SUBTITLEDECODER_ERROR_DECODER;
+    this->context = avcodec_alloc_context3(codec);
+    if (!this->context) return SUBTITLEDECODER_ERROR_ALLOC;
+    if (avcodec_parameters_to_context(this->context, stream->codecpar) < 0) {
+        this->release();
+        return SUBTITLEDECODER_ERROR_DECODER;
+    }
+    this->context->pkt_timebase = stream->time_base;//AVSubtitle::pts和由packet时长得到的结束时间都需要
+    if (avcodec_open2(this->context, codec, nullptr) != 0) {
+        this->release();
+        return SUBTITLEDECODER_ERROR_DECODER;
+    }
+    this->streamIndex = streamIndex;
+    this->canvasWidth = videoWidth;
+    this->canvasHeight = videoHeight;
+    return SUBTITLEDECODER_OK;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        解码一个packet，得到完整的字幕事件时返回true。图形区域按调色板转换为RGBA（非预乘），
+*                文本区域优先取ASS行中的文本并去掉样式标签
+* @Param:        @packet AVPacket* 字幕packet（时间戳为流的time_base）
+*                @event SubtitleEvent& 输出
+* @Return:       bool
+**/
+bool SubtitleDecoder::decode(AVPacket* packet, SubtitleEvent& event) {
+    AVSubtitle sub;
+    AVSubtitleRect* rect = nullptr;
+    int got = 0;
+    int64_t pts = AV_NOPTS_VALUE;
+    const uint32_t* palette = nullptr;
+    const uint8_t* line = nullptr;
+    unsigned char* dst = nullptr;
+    uint32_t color = 0;
+    if (!this->context) return false;
+    memset(&sub, 0, sizeof(sub));
+    if (avcodec_decode_subtitle2(this->context, &sub, &got, packet) < 0 || !got) return false;
+
+    pts = sub.pts;
+    if (pts == AV_NOPTS_VALUE && packet->pts != AV_NOPTS_VALUE) {
+        pts = av_rescale_q(packet->pts, this->context->pkt_timebase, AVRational{ 1, AV_TIME_BASE });
+    }
+    if (pts == AV_NOPTS_VALUE) {//没有时间戳无法显示
+        avsubtitle_free(&sub);
+        return false;
+    }
+    event = SubtitleEvent();
+    event.start = pts + (int64_t)sub.start_display_time * 1000;
+    if (sub.end_display_time > sub.start_display_time && sub.end_display_time != UINT32_MAX) {
+        event.end = pts + (int64_t)sub.end_display_time * 1000;
+    }
+    else if (packet->duration > 0) {
+        event.end = event.start + av_rescale_q(packet->duration, this->context->pkt_timebase, AVRational{ 1, AV_TIME_BASE });
+    }
+    event.canvasWidth = this->context->width > 0 ? this->context->width : this->canvasWidth;
+    event.canvasHeight = this->context->height > 0 ? this->context->height : this->canvasHeight;
+    event.bitmap = (sub.format == 0);
+
+    for (unsigned int i = 0; i < sub.num_rects; i++) {
+        rect = sub.rects[i];
+        SubtitleRect item;
+        if (rect->type == SUBTITLE_BITMAP) {
+            if (rect->w <= 0 || rect->h <= 0 || !rect->data[0] || !rect->data[1]) continue;
+            item.x = rect->x;
+            item.y = rect->y;
+            item.width = rect->w;
+            item.height = rect->h;
+            item.rgba.resize((size_t)rect->w * rect->h * 4);
+            palette = (const uint32_t*)rect->data[1];//PAL8，调色板为本机字节序的0xAARRGGBB
+            for (int y = 0; y < rect->h; y++) {
+                line = rect->data[0] + (size_t)y * rect->linesize[0];
+                dst = item.rgba.data() + (size_t)y * rect->w * 4;
+                for (int x = 0; x < rect->w; x++) {
+                    color = line[x] < rect->nb_colors ? palette[line[x]] : 0;
+                    dst[0] = (color >> 16) & 0xff;
+                    dst[1] = (color >> 8) & 0xff;
+                    dst[2] = color & 0xff;
+                    dst[3] = (color >> 24) & 0xff;
+                    dst += 4;
+                }
+            }
+        }
+        else {
+            item.text = rect->ass ? assText(rect->ass) : (rect->text ? rect->text : "");
+            if (item.text.empty()) continue;
+        }
+        event.rects.push_back(item);
+    }
+    if (!event.bitmap && event.end == INT64_MAX && !event.rects.empty()) {//文本字幕都应有时长，缺失时给默认值
+        event.end = event.start + SUBTITLEDECODER_DEFAULT_DURATION;
+    }
+    avsubtitle_free(&sub);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        跳转后刷新解码器（丢弃不完整的显示集合）
+* @Param:        void
+* @Return:       void
+**/
+void SubtitleDecoder::flush() {
+    if (this->context) avcodec_flush_buffers(this->context);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        释放解码器
+* @Param:        void
+* @Return:       void
+**/
+void SubtitleDecoder::release() {
+    if (this->context) {
+        avcodec_free_context(&this->context);
+    }
+    this->streamIndex = -1;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        当前打开的流下标
+* @Param:        void
+* @Return:       int 没有打开时为-1
+**/
+int SubtitleDecoder::getStreamIndex() {
+    return this->streamIndex;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        从解码器输出的ASS行（ReadOrder,Layer,Style,Name,MarginL,MarginR,MarginV,Effect,Text）取出显示的文本，
+*                去掉{}中的样式标签，\N和\n换行，\h为空格
+* @Param:        @ass (const char*) ASS行
+* @Return:       std::string
+**/
+std::string SubtitleDecoder::assText(const char* ass) {
+    std::string text;
+    const char* p = ass;
+    int commas = 0;
+    while (*p && commas < 8) {
+        if (*p == ',') commas++;
+        p++;
+    }
+    if (commas < 8) p = ass;//不是对话行格式，整行作为文本
+    while (*p) {
+        if (*p == '{') {
+            while (*p && *p != '}') p++;
+            if (*p) p++;
+            continue;
+        }
+        if (*p == '\\' && (p[1] == 'N' || p[1] == 'n')) {
+            text += '\n';
+            p += 2;
+            continue;
+        }
+        if (*p == '\\' && p[1] == 'h') {
+            text += ' ';
+            p += 2;
+            continue;
+        }
+        if (*p != '\r') text += *p;
+        p++;
+    }
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.pop_back();
+    return text;
+}
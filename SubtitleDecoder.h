@@ -0,0 +1,101 @@
+#ifndef _SUBTITLEDECODER_H_
+#define _SUBTITLEDECODER_H_
+
+/**
+* @File name:    SubtitleDecoder.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  字幕解码：文本字幕（SubRip/ASS等）取出纯文本，图形字幕（PGS/DVB/DVD）调色板转换为RGBA，
+*                得到带显示时间的字幕事件，由引擎的字幕线程交给SubtitleSink光栅化和显示，不依赖Qt
+**/
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct AVCodecContext;
+struct AVStream;
+struct AVPacket;
+
+
+#define SUBTITLEDECODER_OK                  (0)
+#define SUBTITLEDECODER_ERROR_DECODER       (-1)//找不到或无法打开解码器
+#define SUBTITLEDECODER_ERROR_ALLOC         (-2)//解码器上下文分配失败
+
+#define SUBTITLEDECODER_DEFAULT_DURATION    (5000000)//文本字幕没有结束时间时显示的时长（us）
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  字幕事件中的一个区域：图形字幕为画布上x/y处width*height的RGBA图像，文本字幕只有text（多行以\n分隔）
+    **/
+    class SubtitleRect {
+    public:
+        SubtitleRect();
+        int x;
+        int y;
+        int width;
+        int height;
+        std::vector<unsigned char> rgba;
+        std::string text;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  一个字幕事件，start/end为显示区间（us，与视频帧的pts同一时间轴），end为INT64_MAX时显示到下一个事件。
+    *                没有区域的事件表示清除（PGS/DVB用空的显示集合结束上一条字幕）；canvasWidth/Height为图形字幕坐标所在的画布大小
+    **/
+    class SubtitleEvent {
+    public:
+        SubtitleEvent();
+        int64_t start;
+        int64_t end;
+        int canvasWidth;
+        int canvasHeight;
+        bool bitmap;
+        std::vector<SubtitleRect> rects;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  单个字幕流的解码器，open后使用，非线程安全（只在字幕线程使用）
+    **/
+    class SubtitleDecoder {
+    public:
+        SubtitleDecoder();
+        ~SubtitleDecoder();
+        int open(AVStream* stream, int streamIndex, int videoWidth, int videoHeight);
+        bool decode(AVPacket* packet, SubtitleEvent& event);
+        void flush();
+        void release();
+        int getStreamIndex();
+        static std::string assText(const char* ass);
+    private:
+        SubtitleDecoder(const SubtitleDecoder&) = delete;
+        SubtitleDecoder& operator=(const SubtitleDecoder&) = delete;
+
+        AVCodecContext* context;
+        int streamIndex;
+        int canvasWidth;//解码器没有给出画布大小时使用的视频大小
+        int canvasHeight;
+    };
+
+
+};
+
+
+#endif//_SUBTITLEDECODER_H_
@@ -0,0 +1,566 @@
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  ThumbnailService.h的实现
+**/
+
+#include "ThumbnailService.h"
+
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <cstring>
+#include <sys/stat.h>
+#include "MediaUse.h"
+
+extern "C"{
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libswscale/swscale.h"
+#include "libavutil/avutil.h"
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+ThumbnailService::ThumbnailService()
+    :formatContext(nullptr), codecContext(nullptr), swsContext(nullptr), packet(nullptr), frame(nullptr), streamIndex(-1),
+    thumbWidth(0), thumbHeight(0), duration(0), slotInterval(THUMBNAIL_MIN_INTERVAL), slotCount(0),
+    memoryBudget(THUMBNAIL_DEFAULT_MEMORY), memoryUsage(0), fillSlot(0), threadShouldEnd(true), thread(nullptr) {
+
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        稀构函数，结束工作线程并释放资源
+* @Param:        void
+* @Return:       void
+**/
+ThumbnailService::~ThumbnailService(){
+    this->close();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        启动低优先级工作线程，文件的打开和解码器的准备都在工作线程中进行，不阻塞调用线程（UI线程），
+*                打开成功后getDuration才大于0，失败（如没有视频流）时一直为0
+* @Param:        @path (const std::string&) 文件路径
+*                @thumbWidth int 缩略图宽度，高度按画面比例计算
+*                @memoryBudget size_t 内存缓存上限（字节）
+*                @diskCacheDir (const std::string&) 磁盘缓存目录（需已存在），为空不使用磁盘缓存
+* @Return:       bool 路径为空返回false
+**/
+bool ThumbnailService::open(const std::string& path, int thumbWidth, size_t memoryBudget, const std::string& diskCacheDir){
+    this->close();
+    if (path.empty()) return false;
+
+    this->path = path;
+    this->thumbWidth = (thumbWidth > 0 ? thumbWidth : THUMBNAIL_DEFAULT_WIDTH) & ~1;
+    this->memoryBudget = memoryBudget;
+    this->diskCacheDir = diskCacheDir;
+    this->fillSlot = 0;
+    this->threadShouldEnd = false;
+    this->thread = new std::thread(&ThumbnailService::workerThread, this);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        打开文件并准备只解码关键帧的解码器，计算缩略图尺寸和槽位，只在工作线程调用。
+*                close可以通过中断回调结束阻塞的打开和读取
+* @Param:        void
+* @Return:       bool 打开成功返回true（文件没有视频流返回false）
+**/
+bool ThumbnailService::openDecoder(){
+    int ret = 0;
+    const AVCodec* codec = nullptr;
+    AVStream* stream = nullptr;
+    struct stat st;
+    std::ostringstream key;
+    int width = 0;
+    int height = 0;
+    int64_t duration = 0;
+    int64_t interval = 0;
+
+    this->formatContext = avformat_alloc_context();
+    if (!this->formatContext) return false;
+    this->formatContext->interrupt_callback.callback = [](void* opaque) -> int {
+        return ((ThumbnailService*)opaque)->threadShouldEnd.load() ? 1 : 0;
+    };
+    this->formatContext->interrupt_callback.opaque = this;
+    ret = avformat_open_input(&this->formatContext, this->path.c_str(), nullptr, nullptr);
+    if (ret != 0) {
+        this->formatContext = nullptr;
+        return false;
+    }
+    ret = avformat_find_stream_info(this->formatContext, nullptr);
+    if (ret < 0) {
+        this->releaseDecoder();
+        return false;
+    }
+    this->streamIndex = av_find_best_stream(this->formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (this->streamIndex < 0) {
+        this->releaseDecoder();
+        return false;
+    }
+    //只读取视频流，其他流不解析
+    for (unsigned int i = 0; i < this->formatContext->nb_streams; i++) {
+        if ((int)i != this->streamIndex) this->formatContext->streams[i]->discard = AVDISCARD_ALL;
+    }
+    stream = this->formatContext->streams[this->streamIndex];
+    codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (codec) this->codecContext = avcodec_alloc_context3(codec);
+    if (!this->codecContext || avcodec_parameters_to_context(this->codecContext, stream->codecpar) < 0) {
+        this->releaseDecoder();
+        return false;
+    }
+    this->codecContext->thread_count = 1;
+    this->codecContext->skip_frame = AVDISCARD_NONKEY;//只解码关键帧
+    this->codecContext->pkt_timebase = stream->time_base;
+    if (avcodec_open2(this->codecContext, nullptr, nullptr) != 0 || this->codecContext->width <= 0) {
+        this->releaseDecoder();
+        return false;
+    }
+    this->packet = av_packet_alloc();
+    this->frame = av_frame_alloc();
+    if (!this->packet || !this->frame) {
+        this->releaseDecoder();
+        return false;
+    }
+
+    //缩略图尺寸，宽高取偶数
+    width = this->thumbWidth;
+    height = (int)((int64_t)width * this->codecContext->height / this->codecContext->width) & ~1;
+    if (height < 2) height = 2;
+
+    //按时长等分槽位
+    duration = this->formatContext->duration > 0 ? this->formatContext->duration : 0;
+    interval = duration / THUMBNAIL_MAX_SLOTS;
+    if (interval < THUMBNAIL_MIN_INTERVAL) interval = THUMBNAIL_MIN_INTERVAL;
+
+    //文件标识：路径+大小+修改时间，文件变化后磁盘缓存自然失效
+    if (!this->diskCacheDir.empty() && stat(this->path.c_str(), &st) == 0) {
+        key << std::hex << std::hash<std::string>()(this->path) << '_' << (long long)st.st_size << '_' << (long long)st.st_mtime
+            << '_' << width;
+        this->fileKey = key.str();
+    }
+    else {
+        this->diskCacheDir.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->thumbHeight = height;
+    this->slotInterval = interval;
+    this->slotCount = (int)(duration / interval) + 1;
+    this->duration = duration;
+    this->memoryUsage = 0;
+    this->failed.assign(this->slotCount, false);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        结束工作线程，释放解码器和内存缓存（磁盘缓存保留）
+* @Param:        void
+* @Return:       void
+**/
+void ThumbnailService::close(){
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->threadShouldEnd = true;
+        this->cv.notify_all();
+    }
+    if (this->thread) {
+        this->thread->join();
+        delete this->thread;
+        this->thread = nullptr;
+    }
+    this->releaseDecoder();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->lru.clear();
+    this->slotMap.clear();
+    this->pending.clear();
+    this->failed.clear();
+    this->memoryUsage = 0;
+    this->slotCount = 0;
+    this->duration = 0;
+    this->thumbHeight = 0;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        请求指定时间的缩略图（异步），最新的请求优先处理
+* @Param:        @pts int64_t 时间（AV_TIME_BASE）
+* @Return:       void
+**/
+void ThumbnailService::request(int64_t pts){
+    std::lock_guard<std::mutex> lock(this->mutex);
+    int slot = this->slotOf(pts);
+    if (slot < 0 || this->slotMap.count(slot) || this->failed[slot]) return;
+    this->pending.remove(slot);
+    this->pending.push_front(slot);
+    while (this->pending.size() > THUMBNAIL_MAX_PENDING) {
+        this->pending.pop_back();
+    }
+    this->cv.notify_one();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        获取指定时间的缩略图，没有时使用前后两个槽位内最近的缩略图，并请求准确的槽位
+* @Param:        @pts int64_t 时间（AV_TIME_BASE）
+*                @rgb (std::vector<unsigned char>&) 输出RGB24数据，尺寸为getWidth()*getHeight()
+*                @framePts (int64_t *) 输出缩略图实际对应的关键帧时间，可为null
+* @Return:       bool 有可用缩略图返回true
+**/
+bool ThumbnailService::getThumbnail(int64_t pts, std::vector<unsigned char>& rgb, int64_t* framePts){
+    std::unique_lock<std::mutex> lock(this->mutex);
+    int slot = this->slotOf(pts);
+    int offsets[5] = { 0,-1,1,-2,2 };
+    if (slot < 0) return false;
+    for (int i = 0; i < 5; i++) {
+        auto it = this->slotMap.find(slot + offsets[i]);
+        if (it == this->slotMap.end()) continue;
+        this->lru.splice(this->lru.begin(), this->lru, it->second);
+        rgb = it->second->rgb;
+        if (framePts) *framePts = it->second->pts;
+        lock.unlock();
+        if (i != 0) this->request(pts);
+        return true;
+    }
+    lock.unlock();
+    this->request(pts);
+    return false;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回缩略图宽度
+* @Param:        void
+* @Return:       int
+**/
+int ThumbnailService::getWidth(){
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->thumbWidth;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回缩略图高度
+* @Param:        void
+* @Return:       int
+**/
+int ThumbnailService::getHeight(){
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->thumbHeight;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回文件时长
+* @Param:        void
+* @Return:       int64_t 单位us
+**/
+int64_t ThumbnailService::getDuration(){
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->duration;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回内存缓存当前占用
+* @Param:        void
+* @Return:       size_t 字节
+**/
+size_t ThumbnailService::getMemoryUsage(){
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->memoryUsage;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        时间对应的槽位，需要持有mutex
+* @Param:        @pts int64_t 时间（AV_TIME_BASE）
+* @Return:       int 槽位，没有打开文件时返回-1
+**/
+int ThumbnailService::slotOf(int64_t pts){
+    int64_t slot = 0;
+    if (this->slotCount <= 0) return -1;
+    slot = (pts + this->slotInterval / 2) / this->slotInterval;
+    if (slot < 0) slot = 0;
+    if (slot >= this->slotCount) slot = this->slotCount - 1;
+    return (int)slot;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        跳转到槽位时间之前的关键帧并解码一帧，缩放为缩略图，只在工作线程调用
+* @Param:        @slot int 槽位
+*                @thumb (Thumbnail&) 输出
+* @Return:       bool 成功返回true
+**/
+bool ThumbnailService::decodeSlot(int slot, Thumbnail& thumb){
+    AVStream* stream = this->formatContext->streams[this->streamIndex];
+    int64_t target = av_rescale_q(slot * this->slotInterval, AVRational{ 1,AV_TIME_BASE }, stream->time_base);
+    int ret = 0;
+    int readCount = 0;
+    bool eof = false;
+    uint8_t* data[4] = { nullptr };
+    int lines[4] = { 0 };
+
+    if (stream->start_time != AV_NOPTS_VALUE) target += stream->start_time;
+    if (avformat_seek_file(this->formatContext, this->streamIndex, INT64_MIN, target, target, AVSEEK_FLAG_BACKWARD) < 0) {
+        avformat_seek_file(this->formatContext, this->streamIndex, INT64_MIN, target, INT64_MAX, 0);
+    }
+    avcodec_flush_buffers(this->codecContext);
+
+    while (!this->threadShouldEnd && readCount < 1000) {
+        ret = avcodec_receive_frame(this->codecContext, this->frame);
+        if (ret == 0) break;
+        if (ret != AVERROR(EAGAIN) || eof) return false;
+        ret = av_read_frame(this->formatContext, this->packet);
+        readCount++;
+        if (ret < 0) {
+            eof = true;
+            avcodec_send_packet(this->codecContext, nullptr);//冲刷解码器
+            continue;
+        }
+        if (this->packet->stream_index == this->streamIndex) {
+            avcodec_send_packet(this->codecContext, this->packet);
+        }
+        av_packet_unref(this->packet);
+    }
+    if (ret != 0) return false;
+
+    this->swsContext = sws_getCachedContext(this->swsContext,
+        this->frame->width, this->frame->height, (AVPixelFormat)this->frame->format,
+        this->thumbWidth, this->thumbHeight, AV_PIX_FMT_RGB24,
+        SWS_AREA, nullptr, nullptr, nullptr);
+    if (!this->swsContext) {
+        av_frame_unref(this->frame);
+        return false;
+    }
+    thumb.slot = slot;
+    thumb.pts = this->frame->best_effort_timestamp == AV_NOPTS_VALUE ? slot * this->slotInterval :
+        av_rescale_q(this->frame->best_effort_timestamp - (stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0), stream->time_base, AVRational{ 1,AV_TIME_BASE });
+    thumb.rgb.resize((size_t)this->thumbWidth * this->thumbHeight * 3);
+    data[0] = thumb.rgb.data();
+    lines[0] = this->thumbWidth * 3;
+    ret = sws_scale(this->swsContext, this->frame->data, this->frame->linesize, 0, this->frame->height, data, lines);
+    av_frame_unref(this->frame);
+    return ret > 0;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        磁盘缓存文件路径
+* @Param:        @slot int 槽位
+* @Return:       std::string
+**/
+std::string ThumbnailService::diskPath(int slot){
+    return this->diskCacheDir + "/" + this->fileKey + "_" + std::to_string(slot) + ".thumb";
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        从磁盘缓存读取缩略图，文件格式为 宽(int32) 高(int32) pts(int64) RGB24数据
+* @Param:        @slot int 槽位
+*                @thumb (Thumbnail&) 输出
+* @Return:       bool 成功返回true
+**/
+bool ThumbnailService::loadFromDisk(int slot, Thumbnail& thumb){
+    int32_t width = 0;
+    int32_t height = 0;
+    int64_t pts = 0;
+    if (this->diskCacheDir.empty()) return false;
+    std::ifstream f(this->diskPath(slot), std::ios_base::in | std::ios_base::binary);
+    if (!f.is_open()) return false;
+    f.read((char*)&width, sizeof(width));
+    f.read((char*)&height, sizeof(height));
+    f.read((char*)&pts, sizeof(pts));
+    if (!f || width != this->thumbWidth || height != this->thumbHeight) return false;
+    thumb.slot = slot;
+    thumb.pts = pts;
+    thumb.rgb.resize((size_t)width * height * 3);
+    f.read((char*)thumb.rgb.data(), thumb.rgb.size());
+    return (bool)f;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        缩略图写入磁盘缓存
+* @Param:        @thumb (const Thumbnail&) 缩略图
+* @Return:       void
+**/
+void ThumbnailService::saveToDisk(const Thumbnail& thumb){
+    int32_t width = this->thumbWidth;
+    int32_t height = this->thumbHeight;
+    if (this->diskCacheDir.empty()) return;
+    std::ofstream f(this->diskPath(thumb.slot), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!f.is_open()) return;
+    f.write((const char*)&width, sizeof(width));
+    f.write((const char*)&height, sizeof(height));
+    f.write((const char*)&thumb.pts, sizeof(thumb.pts));
+    f.write((const char*)thumb.rgb.data(), thumb.rgb.size());
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        缩略图插入内存LRU，超出预算时淘汰最久未使用的，需要持有mutex
+* @Param:        @thumb (Thumbnail&) 缩略图，数据会被移动
+* @Return:       void
+**/
+void ThumbnailService::insert(Thumbnail& thumb){
+    if (this->slotMap.count(thumb.slot)) return;
+    this->memoryUsage += thumb.rgb.size();
+    this->lru.push_front(Thumbnail());
+    this->lru.front().slot = thumb.slot;
+    this->lru.front().pts = thumb.pts;
+    this->lru.front().rgb.swap(thumb.rgb);
+    this->slotMap[thumb.slot] = this->lru.begin();
+    while (this->memoryUsage > this->memoryBudget && this->lru.size() > 1) {
+        this->memoryUsage -= this->lru.back().rgb.size();
+        this->slotMap.erase(this->lru.back().slot);
+        this->lru.pop_back();
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        工作线程，先打开文件，之后优先处理最新请求，空闲时按顺序填充槽位直到内存预算用完
+* @Param:        void
+* @Return:       void
+**/
+void ThumbnailService::workerThread(){
+    int slot = -1;
+    bool ok = false;
+    size_t thumbSize = 0;
+    Thumbnail thumb;
+
+    MediaUse::lowerThreadPriority();
+
+    if (!this->openDecoder()) {//打开失败时没有槽位，请求和获取都直接返回
+        this->releaseDecoder();
+        return;
+    }
+    thumbSize = (size_t)this->thumbWidth * this->thumbHeight * 3;
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (!this->threadShouldEnd) {
+        this->cv.wait(lock, [this] {return this->threadShouldEnd || !this->pending.empty() || this->fillSlot < this->slotCount; });
+        if (this->threadShouldEnd) break;
+        if (!this->pending.empty()) {
+            slot = this->pending.front();
+            this->pending.pop_front();
+        }
+        else if (this->memoryUsage + thumbSize > this->memoryBudget) {
+            this->fillSlot = this->slotCount;//内存已满，不再后台填充，避免LRU反复淘汰
+            continue;
+        }
+        else {
+            slot = this->fillSlot++;
+        }
+        if (this->slotMap.count(slot) || this->failed[slot]) continue;
+
+        lock.unlock();
+        ok = this->loadFromDisk(slot, thumb);
+        if (!ok) {
+            ok = this->decodeSlot(slot, thumb);
+            if (ok) this->saveToDisk(thumb);
+        }
+        lock.lock();
+        if (ok) {
+            this->insert(thumb);
+        }
+        else {
+            this->failed[slot] = true;
+        }
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        释放ffmpeg资源
+* @Param:        void
+* @Return:       void
+**/
+void ThumbnailService::releaseDecoder(){
+    if (this->packet) {
+        av_packet_free(&this->packet);
+    }
+    if (this->frame) {
+        av_frame_free(&this->frame);
+    }
+    if (this->swsContext) {
+        sws_freeContext(this->swsContext);
+        this->swsContext = nullptr;
+    }
+    if (this->codecContext) {
+        avcodec_free_context(&this->codecContext);
+    }
+    if (this->formatContext) {
+        avformat_close_input(&this->formatContext);
+    }
+    this->streamIndex = -1;
+}
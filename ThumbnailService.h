@@ -0,0 +1,124 @@
+#ifndef THUMBNAILSERVICE_H
+#define THUMBNAILSERVICE_H
+
+
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  ThumbnailService类的声明
+**/
+
+
+#include <string>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+struct SwsContext;
+
+
+#define THUMBNAIL_DEFAULT_WIDTH          (160)
+#define THUMBNAIL_DEFAULT_MEMORY         (32 * 1024 * 1024)
+#define THUMBNAIL_MIN_INTERVAL           (1000000)//两个缩略图槽位的最小间隔（us）
+#define THUMBNAIL_MAX_SLOTS              (400)//一个文件最多的缩略图槽位数
+#define THUMBNAIL_MAX_PENDING            (4)//最多保留的未处理请求数，鼠标快速移动时旧请求会被丢弃
+
+
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  缩略图服务，使用独立的解封装器和解码器在低优先级线程中只解码关键帧，
+*                缩放后按槽位（时长等分）存入内存LRU，可选按文件标识（路径+大小+修改时间）缓存到磁盘，
+*                用于进度条悬停预览，不影响播放使用的解码器。文件在工作线程中打开，open不阻塞调用线程
+**/
+class ThumbnailService {
+public:
+
+    ThumbnailService();
+    ~ThumbnailService();
+
+    bool open(const std::string& path, int thumbWidth = THUMBNAIL_DEFAULT_WIDTH,
+        size_t memoryBudget = THUMBNAIL_DEFAULT_MEMORY, const std::string& diskCacheDir = "");
+    void close();
+    void request(int64_t pts);
+    bool getThumbnail(int64_t pts, std::vector<unsigned char>& rgb, int64_t* framePts = nullptr);
+    int getWidth();
+    int getHeight();
+    int64_t getDuration();
+    size_t getMemoryUsage();
+
+private:
+
+    struct Thumbnail {
+        int slot;
+        int64_t pts;
+        std::vector<unsigned char> rgb;
+    };
+
+    bool openDecoder();
+    int slotOf(int64_t pts);
+    bool decodeSlot(int slot, Thumbnail& thumb);
+    bool loadFromDisk(int slot, Thumbnail& thumb);
+    void saveToDisk(const Thumbnail& thumb);
+    std::string diskPath(int slot);
+    void insert(Thumbnail& thumb);
+    void workerThread();
+    void releaseDecoder();
+
+    //独立的ffmpeg资源，只在工作线程中使用
+    AVFormatContext* formatContext;
+    AVCodecContext* codecContext;
+    SwsContext* swsContext;
+    AVPacket* packet;
+    AVFrame* frame;
+    int streamIndex;
+
+    //文件路径，工作线程启动后在其中打开
+    std::string path;
+
+    //缩略图尺寸、槽位间隔和数量，工作线程打开文件后在mutex保护下设置，打开前duration为0
+    int thumbWidth;
+    int thumbHeight;
+    int64_t duration;
+    int64_t slotInterval;
+    int slotCount;
+
+    //内存LRU，表头为最近使用
+    size_t memoryBudget;
+    size_t memoryUsage;
+    std::list<Thumbnail> lru;
+    std::unordered_map<int, std::list<Thumbnail>::iterator> slotMap;
+
+    //磁盘缓存目录和文件标识，目录为空表示不使用磁盘缓存
+    std::string diskCacheDir;
+    std::string fileKey;
+
+    //请求队列（表头为最新请求），空闲时后台按顺序填充槽位
+    std::list<int> pending;
+    std::vector<bool> failed;
+    int fillSlot;
+
+    std::atomic<bool> threadShouldEnd;//decodeSlot不持有mutex时读取
+    std::thread* thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+
+};
+
+
+
+
+#endif // THUMBNAILSERVICE_H
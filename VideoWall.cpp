@@ -0,0 +1,699 @@
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  VideoWall.h的实现
+**/
+
+#include"VideoWall.h"
+#include<QTimer>
+#include<QImage>
+#include<QMouseEvent>
+#include<QOpenGLContext>
+#include<QOpenGLFunctions_3_0>
+#include<QOpenGLShaderProgram>
+
+#include<cmath>
+#include<cstring>
+#include<chrono>
+#include<sstream>
+#include<iomanip>
+#include<algorithm>
+
+using namespace MediaUse;
+
+
+//顶点直接使用标准化设备坐标，纹理坐标的第三个分量为纹理数组的层
+static const char* videoWallVertexShader =
+    "#version 130\n"
+    "out vec3 coord;\n"
+    "void main(){\n"
+    "    coord = gl_MultiTexCoord0.xyz;\n"
+    "    gl_Position = gl_Vertex;\n"
+    "}\n";
+
+static const char* videoWallFragmentShader =
+    "#version 130\n"
+    "uniform sampler2DArray frames;\n"
+    "in vec3 coord;\n"
+    "void main(){\n"
+    "    gl_FragColor = texture(frames, coord);\n"
+    "}\n";
+
+
+//垂直同步，每次刷新最多交换一次
+static QGLFormat videoWallFormat(){
+    QGLFormat format = QGLFormat::defaultFormat();
+    format.setSwapInterval(1);
+    return format;
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        构造函数，垂直同步（每次刷新最多一次交换），定时检查是否有新帧
+* @Param:        @parent (QWidget *)
+* @Return:       void
+**/
+VideoWall::VideoWall(QWidget* parent):
+    QGLWidget(videoWallFormat(), parent){
+    this->columns = 0;
+    this->audioFocus = -1;
+    this->fastStart = false;
+    this->dirty = false;
+    this->textureArray = 0;
+    this->layerWidth = 0;
+    this->layerHeight = 0;
+    this->layerCount = 0;
+    this->openGL_funcs = nullptr;
+    this->program = nullptr;
+    this->paintCount = 0;
+    this->uploadCount = 0;
+    this->drawCalls = 0;
+    this->paintUs = 0;
+
+    this->refreshTimer = new QTimer(this);
+    connect(this->refreshTimer, &QTimer::timeout, this, [this](){ this->refresh(); });
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构函数，先结束所有引擎再释放OpenGL资源
+* @Param:        void
+* @Return:       void
+**/
+VideoWall::~VideoWall(){
+    this->stop();
+    for(Stream* stream : this->streams){
+        delete stream;
+    }
+    this->streams.clear();
+    if(this->openGL_funcs){
+        this->makeCurrent();
+        delete this->program;
+        this->program = nullptr;
+        if(this->textureArray) glDeleteTextures(1, &this->textureArray);
+        this->doneCurrent();
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        添加一路画面并打开文件，引擎使用共享解码调度器，画面默认静音，需要在start之前调用
+* @Param:        @path (const std::string&) 文件路径或URL
+* @Return:       int 画面序号，打开失败返回-1
+**/
+int VideoWall::addStream(const std::string& path){
+    int index = (int)this->streams.size();
+    Stream* stream = new Stream(this);
+    stream->slot.width = 0;
+    stream->slot.height = 0;
+    stream->slot.active = false;
+    stream->slot.resized = false;
+    stream->slot.ready = -1;
+    stream->engine.setVideoSink(&stream->sink);
+    stream->engine.setAudioSink(&stream->audio);
+    stream->engine.setDecoderPool(&DecoderPool::global());
+    stream->engine.setFastStart(this->fastStart);
+    stream->engine.setPath(path);
+    AudioMixer::global().setChannelName(stream->audio.getMixerChannel(), path);
+    AudioMixer::global().setMute(stream->audio.getMixerChannel(), true);
+    if(!stream->engine.avOpen()){
+        stream->engine.messagePrint("ERROR::VIDEOWALL::OPEN_FAILED", CPPPLAYER_COLOR_RED);
+        delete stream;
+        return -1;
+    }
+    this->streams.push_back(stream);
+    return index;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        画面数
+* @Param:        void
+* @Return:       int
+**/
+int VideoWall::streamCount(){
+    return (int)this->streams.size();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        返回某一路画面的引擎，用于跳转、暂停、调整优先级等操作
+* @Param:        @index int 画面序号
+* @Return:       MediaUse::PlayerEngine&
+**/
+MediaUse::PlayerEngine& VideoWall::getEngine(int index){
+    return this->streams[index]->engine;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        开始播放所有画面
+* @Param:        void
+* @Return:       bool 没有画面返回false
+**/
+bool VideoWall::start(){
+    if(this->streams.empty()) return false;
+    for(Stream* stream : this->streams){
+        if(!stream->engine.isRunning()) stream->engine.avStart();
+    }
+    this->refreshTimer->start(VIDEOWALL_REFRESH_MS);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        结束播放所有画面
+* @Param:        void
+* @Return:       void
+**/
+void VideoWall::stop(){
+    this->refreshTimer->stop();
+    for(Stream* stream : this->streams){
+        if(stream->engine.isRunning()) stream->engine.avStop();
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置网格列数
+* @Param:        @columns int 列数，0表示按画面数自动排列
+* @Return:       void
+**/
+void VideoWall::setColumns(int columns){
+    this->columns = columns < 0 ? 0 : columns;
+    this->dirty = true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置之后添加的画面是否快速启动（见PlayerEngine::setFastStart），需要在addStream之前调用
+* @Param:        @fast bool 是否开启，默认关闭
+* @Return:       void
+**/
+void VideoWall::setFastStart(bool fast){
+    this->fastStart = fast;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        设置有声音的画面：该画面取消静音并成为混音焦点，其他画面静音（音频解码随之挂起）
+* @Param:        @index int 画面序号，-1表示全部静音
+* @Return:       void
+**/
+void VideoWall::setAudioFocus(int index){
+    if(index >= (int)this->streams.size()) index = -1;
+    for(int i = 0; i < (int)this->streams.size(); i++){
+        AudioMixer::global().setMute(this->streams[i]->audio.getMixerChannel(), i != index);
+    }
+    AudioMixer::global().setFocus(index >= 0 ? this->streams[index]->audio.getMixerChannel() : -1);
+    this->audioFocus = index;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        有声音的画面
+* @Param:        void
+* @Return:       int -1表示全部静音
+**/
+int VideoWall::getAudioFocus(){
+    return this->audioFocus;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        把当前所有画面合成到width*height的离屏FBO并回读，不依赖窗口是否显示，
+*                可在QT_QPA_PLATFORM=offscreen和Mesa软件渲染下检查合成结果
+* @Param:        @width int
+*                @height int
+* @Return:       QImage RGB888图像，OpenGL 3.0不可用或FBO不完整时返回空图像
+**/
+QImage VideoWall::grabComposite(int width, int height){
+    QImage image;
+    GLuint fbo = 0;
+    GLuint target = 0;
+    std::vector<unsigned char> readback((size_t)width * height * 3);
+    size_t line = (size_t)width * 3;
+    this->makeCurrent();
+    if(!this->openGL_funcs || !this->program || width <= 0 || height <= 0){
+        this->doneCurrent();
+        return image;
+    }
+    glGenTextures(1, &target);
+    glBindTexture(GL_TEXTURE_2D, target);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    this->openGL_funcs->glGenFramebuffers(1, &fbo);
+    this->openGL_funcs->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    this->openGL_funcs->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+    if(this->openGL_funcs->glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE){
+        this->uploadFrames();
+        glViewport(0, 0, width, height);
+        this->drawTiles(width, height);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, readback.data());
+        for(int i = 0; i < height / 2; i++){//OpenGL的行自下而上
+            std::swap_ranges(readback.begin() + i * line, readback.begin() + (i + 1) * line, readback.begin() + (height - 1 - i) * line);
+        }
+        image = QImage(readback.data(), width, height, (int)line, QImage::Format_RGB888).copy();
+    }
+    this->openGL_funcs->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    this->openGL_funcs->glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &target);
+    glViewport(0, 0, this->width(), this->height());
+    this->doneCurrent();
+    return image;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        合成统计：重绘次数、每次重绘的上传数和绘制调用数、每次重绘的平均耗时
+* @Param:        void
+* @Return:       std::string
+**/
+std::string VideoWall::getCompositorReport(){
+    std::ostringstream out;
+    double paints = this->paintCount ? (double)this->paintCount : 1.0;
+    out << std::fixed << std::setprecision(2)
+        << "compositor " << this->streams.size() << " streams " << this->layerWidth << "x" << this->layerHeight
+        << " layers, paints " << this->paintCount
+        << ", uploads/paint " << this->uploadCount / paints
+        << ", draws/paint " << this->drawCalls / paints
+        << ", paint " << this->paintUs / paints / 1000.0 << "ms";
+    return out.str();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        重绘时上传到纹理数组的帧数（所有画面之和），只在界面线程调用
+* @Param:        void
+* @Return:       uint64_t
+**/
+uint64_t VideoWall::getUploadCount(){
+    return this->uploadCount;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        重写初始化OpenGL函数，获取OpenGL 3.0函数并编译纹理数组着色器
+* @Param:        void
+* @Return:       void
+**/
+void VideoWall::initializeGL(){
+    this->openGL_funcs = QOpenGLContext::currentContext()->versionFunctions<QOpenGLFunctions_3_0>();
+    if(!this->openGL_funcs || !this->openGL_funcs->initializeOpenGLFunctions()){
+        qWarning("ERROR::OPENGL::VERSION_3_0_UNAVAILABLE");
+        this->openGL_funcs = nullptr;
+        return;
+    }
+    this->program = new QOpenGLShaderProgram();
+    this->program->addShaderFromSourceCode(QOpenGLShader::Vertex, videoWallVertexShader);
+    this->program->addShaderFromSourceCode(QOpenGLShader::Fragment, videoWallFragmentShader);
+    if(!this->program->link()){
+        qWarning("ERROR::OPENGL::SHADER_LINK_FAILED");
+        delete this->program;
+        this->program = nullptr;
+        return;
+    }
+    this->program->bind();
+    this->program->setUniformValue("frames", 0);
+    this->program->release();
+    glGenTextures(1, &this->textureArray);
+    glClearColor(0.0f,0.0f,0.0f,0.0f);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        重写渲染函数，上传新帧后一次画出所有画面
+* @Param:        void
+* @Return:       void
+**/
+void VideoWall::paintGL(){
+    auto begin = std::chrono::steady_clock::now();
+    glClear(GL_COLOR_BUFFER_BIT);
+    if(!this->openGL_funcs || !this->program) return;
+    this->uploadCount += this->uploadFrames();
+    this->drawTiles(this->width(), this->height());
+    this->paintCount++;
+    this->paintUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        重写窗口大小变换函数，画面比例在drawTiles中按网格单元保持
+* @Param:        @width int
+*                @height int
+* @Return:       void
+**/
+void VideoWall::resizeGL(int width, int height){
+    glViewport(0, 0, width, height);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        点击画面切换声音焦点，再次点击焦点画面全部静音
+* @Param:        @e (QMouseEvent *)
+* @Return:       void
+**/
+void VideoWall::mousePressEvent(QMouseEvent* e){
+    int count = (int)this->streams.size();
+    int cols = this->gridColumns(count);
+    int rows = 0;
+    int index = -1;
+    if(count <= 0 || this->width() <= 0 || this->height() <= 0) return;
+    rows = (count + cols - 1) / cols;
+    index = (e->y() * rows / this->height()) * cols + e->x() * cols / this->width();
+    if(index >= count) return;
+    this->setAudioFocus(index == this->audioFocus ? -1 : index);
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        网格列数：设置了列数时使用设置值，否则取接近正方形的排列
+* @Param:        @count int 画面数
+* @Return:       int
+**/
+int VideoWall::gridColumns(int count){
+    if(this->columns > 0) return this->columns;
+    return count > 0 ? (int)std::ceil(std::sqrt((double)count)) : 1;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        按所有画面的最大尺寸重新分配纹理数组，每路画面一层
+* @Param:        void
+* @Return:       bool 纹理数组可用返回true
+**/
+bool VideoWall::textureArrayCreate(){
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    this->layerCount = std::min((int)this->streams.size(), (int)maxLayers);
+    if(this->layerCount <= 0 || this->layerWidth <= 0 || this->layerHeight <= 0) return false;
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->textureArray);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    this->openGL_funcs->glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGB8, this->layerWidth, this->layerHeight, this->layerCount, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        把各路画面已显示的新帧上传到纹理数组中对应的层（只传图像大小的区域），
+*                有画面尺寸改变时先重新分配纹理数组。上传时持有该路的锁，上传完的缓冲归还空闲列表
+* @Param:        void
+* @Return:       int 上传的帧数
+**/
+int VideoWall::uploadFrames(){
+    int uploads = 0;
+    int width = this->layerWidth;
+    int height = this->layerHeight;
+    bool recreate = this->layerCount < (int)this->streams.size();
+    for(Stream* stream : this->streams){
+        std::lock_guard<std::mutex> lock(stream->slot.mutex);
+        if(stream->slot.resized || recreate){
+            width = std::max(width, stream->slot.width);
+            height = std::max(height, stream->slot.height);
+        }
+        if(stream->slot.resized && (stream->slot.width > this->layerWidth || stream->slot.height > this->layerHeight)){
+            recreate = true;
+        }
+    }
+    if(recreate && width > 0 && height > 0){
+        this->layerWidth = width;
+        this->layerHeight = height;
+        if(!this->textureArrayCreate()) return 0;
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->textureArray);
+    for(int i = 0; i < this->layerCount; i++){
+        Slot& slot = this->streams[i]->slot;
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.resized = false;
+        if(slot.ready < 0) continue;
+        if(slot.active){
+            this->openGL_funcs->glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, slot.width, slot.height, 1, GL_RGB, GL_UNSIGNED_BYTE, slot.buffers[slot.ready].data());
+            uploads++;
+        }
+        slot.freeList.push_back(slot.ready);
+        slot.ready = -1;
+    }
+    return uploads;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        按网格画出所有画面，每个画面在单元格内保持比例居中，所有画面在一次glBegin/glEnd中绘制
+* @Param:        @width int 目标宽
+*                @height int 目标高
+* @Return:       void
+**/
+void VideoWall::drawTiles(int width, int height){
+    int count = this->layerCount;
+    if(count <= 0 || width <= 0 || height <= 0) return;
+    int cols = this->gridColumns(count);
+    int rows = (count + cols - 1) / cols;
+    float cellW = (float)width / cols;
+    float cellH = (float)height / rows;
+
+    this->program->bind();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->textureArray);
+    glBegin(GL_QUADS);
+    for(int i = 0; i < count; i++){
+        int w = 0;
+        int h = 0;
+        {
+            std::lock_guard<std::mutex> lock(this->streams[i]->slot.mutex);
+            if(this->streams[i]->slot.active){
+                w = this->streams[i]->slot.width;
+                h = this->streams[i]->slot.height;
+            }
+        }
+        if(w <= 0 || h <= 0) continue;
+        //单元格内保持比例，换算为标准化设备坐标（y向上）
+        float scale = std::min(cellW / w, cellH / h);
+        float left = (i % cols) * cellW + (cellW - w * scale) / 2;
+        float top = (i / cols) * cellH + (cellH - h * scale) / 2;
+        float x0 = left / width * 2.0f - 1.0f;
+        float x1 = (left + w * scale) / width * 2.0f - 1.0f;
+        float y0 = 1.0f - top / height * 2.0f;
+        float y1 = 1.0f - (top + h * scale) / height * 2.0f;
+        float s = (float)w / this->layerWidth;
+        float t = (float)h / this->layerHeight;
+        glTexCoord3f(0.0f, 0.0f, (float)i);
+        glVertex2f(x0, y0);
+        glTexCoord3f(s, 0.0f, (float)i);
+        glVertex2f(x1, y0);
+        glTexCoord3f(s, t, (float)i);
+        glVertex2f(x1, y1);
+        glTexCoord3f(0.0f, t, (float)i);
+        glVertex2f(x0, y1);
+    }
+    glEnd();
+    this->program->release();
+    this->drawCalls++;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        定时器回调，有新帧时重绘（交换受垂直同步限制，多路同时出帧也只交换一次）
+* @Param:        void
+* @Return:       void
+**/
+void VideoWall::refresh(){
+    if(this->dirty.exchange(false)){
+        this->updateGL();
+    }
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        开始视频输出（视频线程），按图像大小分配CPU缓冲
+* @Param:        @width int
+*                @height int
+* @Return:       bool
+**/
+bool VideoWall::SlotSink::open(int width, int height){
+    Slot& slot = *this->slot;
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    slot.width = width;
+    slot.height = height;
+    slot.freeList.clear();
+    for(int i = 0; i < VIDEOWALL_SLOT_BUFFERS; i++){
+        slot.buffers[i].resize((size_t)width * height * 3);
+        slot.freeList.push_back(i);
+    }
+    slot.staged.clear();
+    slot.ready = -1;
+    slot.active = true;
+    slot.resized = true;
+    this->wall->dirty = true;
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        结束视频输出，该画面不再绘制
+* @Param:        void
+* @Return:       void
+**/
+void VideoWall::SlotSink::close(){
+    Slot& slot = *this->slot;
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    slot.active = false;
+    this->wall->dirty = true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        最多暂存两帧，且需要有空闲缓冲
+* @Param:        void
+* @Return:       bool
+**/
+bool VideoWall::SlotSink::canStage(){
+    Slot& slot = *this->slot;
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    return slot.staged.size() < 2 && !slot.freeList.empty();
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        把一帧拷贝到空闲缓冲，拷贝时不持有锁
+* @Param:        @frame (const MediaUse::AVDataInfo&)
+* @Return:       bool 没有空闲缓冲返回false
+**/
+bool VideoWall::SlotSink::stage(const MediaUse::AVDataInfo& frame){
+    Slot& slot = *this->slot;
+    int buffer = -1;
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if(slot.freeList.empty()) return false;
+        buffer = slot.freeList.back();
+        slot.freeList.pop_back();
+    }
+    std::memcpy(slot.buffers[buffer].data(), frame.data, slot.buffers[buffer].size());
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    slot.staged.push_back(buffer);
+    return true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        最早暂存的一帧成为待上传帧，上一帧还没来得及上传则直接丢弃（界面刷新慢于视频帧率）
+* @Param:        @pts int64_t
+* @Return:       void
+**/
+void VideoWall::SlotSink::present(int64_t pts){
+    (void)pts;
+    Slot& slot = *this->slot;
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if(slot.staged.empty()) return;
+    if(slot.ready >= 0) slot.freeList.push_back(slot.ready);
+    slot.ready = slot.staged.front();
+    slot.staged.pop_front();
+    this->wall->dirty = true;
+}
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        跳转时丢弃暂存的帧
+* @Param:        void
+* @Return:       void
+**/
+void VideoWall::SlotSink::flush(){
+    Slot& slot = *this->slot;
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    while(!slot.staged.empty()){
+        slot.freeList.push_back(slot.staged.front());
+        slot.staged.pop_front();
+    }
+}
@@ -0,0 +1,163 @@
+#ifndef _VIDEOWALL_H_
+#define _VIDEOWALL_H_
+
+/**
+* @File name:    VideoWall.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  多画面监控墙：所有画面在同一个OpenGL上下文中合成，每次刷新一次交换，
+*                各路视频作为纹理数组的一层，一次绘制调用画出所有画面
+**/
+
+
+#include<QWidget>
+#include<QGL>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include"PlayerEngine.h"
+#include"OpenALAudioSink.h"
+
+class QTimer;
+class QMouseEvent;
+class QImage;
+class QOpenGLFunctions_3_0;
+class QOpenGLShaderProgram;
+
+
+#define VIDEOWALL_SLOT_BUFFERS      (4)//每路画面的CPU缓冲数：2个暂存、1个待上传、1个备用
+#define VIDEOWALL_REFRESH_MS        (16)//检查是否有新帧的间隔，有新帧才重绘
+
+
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  多画面合成窗口。每路画面一个PlayerEngine（默认使用共享解码调度器），视频线程只把帧拷贝到
+*                CPU缓冲，不做任何OpenGL操作；界面线程每次刷新把所有新帧用glTexSubImage3D上传到纹理数组，
+*                再用一个着色器、一次glBegin/glEnd画出所有画面，OpenGL开销与画面数基本无关。需要OpenGL 3.0。
+*                默认所有画面静音（不解码音频），点击画面切换为有声音的焦点画面
+**/
+class VideoWall:public QGLWidget{
+    Q_OBJECT
+public:
+
+    VideoWall(QWidget* parent = nullptr);
+    ~VideoWall();
+
+    int addStream(const std::string& path);
+    int streamCount();
+    MediaUse::PlayerEngine& getEngine(int index);
+    bool start();
+    void stop();
+    void setColumns(int columns);
+    void setFastStart(bool fast);
+    void setAudioFocus(int index);
+    int getAudioFocus();
+    QImage grabComposite(int width, int height);
+    std::string getCompositorReport();
+    uint64_t getUploadCount();
+
+protected:
+
+    void initializeGL();
+    void paintGL();
+    void resizeGL(int width, int height);
+    void mousePressEvent(QMouseEvent* e);
+
+private:
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  一路画面的帧缓冲，视频线程写入、界面线程读取，由mutex保护。
+    *                freeList为空闲缓冲，staged为已暂存等待显示的缓冲，ready为已显示等待上传的缓冲（-1表示没有）
+    **/
+    struct Slot {
+        std::mutex mutex;
+        int width;
+        int height;
+        bool active;
+        bool resized;//尺寸改变，需要重新分配纹理数组
+        std::vector<unsigned char> buffers[VIDEOWALL_SLOT_BUFFERS];
+        std::vector<int> freeList;
+        std::deque<int> staged;
+        int ready;
+    };
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  一路画面的视频输出，只操作Slot的CPU缓冲
+    **/
+    class SlotSink :public MediaUse::VideoSink {
+    public:
+        SlotSink(VideoWall* wall, Slot* slot) :wall(wall), slot(slot) {}
+        bool open(int width, int height) override;
+        void close() override;
+        bool canStage() override;
+        bool stage(const MediaUse::AVDataInfo& frame) override;
+        void present(int64_t pts) override;
+        void flush() override;
+    private:
+        VideoWall* wall;
+        Slot* slot;
+    };
+
+    //一路画面：帧缓冲、输出和引擎，输出需要在engine之前构造、之后析构
+    struct Stream {
+        Stream(VideoWall* wall) :sink(wall, &slot) {}
+        Slot slot;
+        SlotSink sink;
+        MediaUse::OpenALAudioSink audio;
+        MediaUse::PlayerEngine engine;
+    };
+
+    bool textureArrayCreate();
+    int uploadFrames();
+    int gridColumns(int count);
+    void drawTiles(int width, int height);
+    void refresh();
+
+    std::vector<Stream*> streams;
+
+    //网格列数，0表示按画面数自动取接近正方形的排列
+    int columns;
+
+    //有声音的画面（-1表示全部静音），其他画面在混音中静音并挂起音频解码
+    int audioFocus;
+
+    //之后添加的画面是否快速启动
+    bool fastStart;
+
+    //有新帧或尺寸改变，需要重绘
+    std::atomic<bool> dirty;
+
+    //纹理数组，每层为layerWidth*layerHeight，每路画面占一层的左上角
+    GLuint textureArray;
+    int layerWidth;
+    int layerHeight;
+    int layerCount;
+    QOpenGLFunctions_3_0* openGL_funcs;
+    QOpenGLShaderProgram* program;
+    QTimer* refreshTimer;
+
+    //合成统计（界面线程）
+    uint64_t paintCount;
+    uint64_t uploadCount;
+    uint64_t drawCalls;
+    double paintUs;
+
+};
+
+
+
+#endif//_VIDEOWALL_H_
@@ -0,0 +1,147 @@
+#include "WavWriter.h"
+
+/**
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  WavWriter.h的实现
+**/
+
+using namespace MediaUse;
+
+
+namespace {
+
+    //按小端写入整数
+    void putLE(std::ofstream& file, uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            file.put((char)((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        默认构造函数
+* @Param:        void
+* @Return:       void
+**/
+WavWriter::WavWriter() :sampleRate(0), channels(0), dataSize(0) {
+
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        析构函数，未close时回填文件头
+* @Param:        void
+* @Return:       void
+**/
+WavWriter::~WavWriter() {
+    this->close();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        创建文件并写入文件头
+* @Param:        @path const std::string& 文件路径
+* @Param:        @sampleRate int 采样率
+* @Param:        @channels int 声道数
+* @Return:       bool 创建失败返回false
+**/
+bool WavWriter::open(const std::string& path, int sampleRate, int channels) {
+    this->close();
+    this->file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!this->file.is_open()) return false;
+    this->sampleRate = sampleRate;
+    this->channels = channels;
+    this->dataSize = 0;
+    this->writeHeader(0);
+    return this->file.good();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        追加PCM数据
+* @Param:        @data const unsigned char* S16交错PCM
+* @Param:        @size size_t 字节数
+* @Return:       bool 写入失败返回false
+**/
+bool WavWriter::write(const unsigned char* data, size_t size) {
+    if (!this->file.is_open()) return false;
+    this->file.write((const char*)data, size);
+    this->dataSize += size;
+    return this->file.good();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        回填文件头中的长度并关闭文件，超过4GB的部分长度按上限填写
+* @Param:        void
+* @Return:       void
+**/
+void WavWriter::close() {
+    if (!this->file.is_open()) return;
+    this->file.seekp(0, std::ios::beg);
+    this->writeHeader(this->dataSize > 0xFFFFFFFFull - 36 ? (uint32_t)(0xFFFFFFFFull - 36) : (uint32_t)this->dataSize);
+    this->file.close();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        是否已打开
+* @Param:        void
+* @Return:       bool
+**/
+bool WavWriter::isOpen() {
+    return this->file.is_open();
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        已写入的采样数（每声道）
+* @Param:        void
+* @Return:       uint64_t
+**/
+uint64_t WavWriter::samples() {
+    return this->channels ? this->dataSize / (2 * this->channels) : 0;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        写入44字节的RIFF/WAVE文件头
+* @Param:        @dataSize uint32_t data块的长度
+* @Return:       void
+**/
+void WavWriter::writeHeader(uint32_t dataSize) {
+    this->file.write("RIFF", 4);
+    putLE(this->file, 36 + dataSize, 4);
+    this->file.write("WAVEfmt ", 8);
+    putLE(this->file, 16, 4);
+    putLE(this->file, 1, 2);//PCM
+    putLE(this->file, this->channels, 2);
+    putLE(this->file, this->sampleRate, 4);
+    putLE(this->file, this->sampleRate * this->channels * 2, 4);
+    putLE(this->file, this->channels * 2, 2);
+    putLE(this->file, 16, 2);
+    this->file.write("data", 4);
+    putLE(this->file, dataSize, 4);
+}
@@ -0,0 +1,50 @@
+#ifndef _WAVWRITER_H_
+#define _WAVWRITER_H_
+
+/**
+* @File name:    WavWriter.h
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  把S16交错PCM写为WAV文件，离线模式的音频输出使用
+**/
+
+
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+
+
+namespace MediaUse {
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  WAV文件写入，open时写入占位的文件头，close时回填数据长度，非线程安全
+    **/
+    class WavWriter {
+    public:
+        WavWriter();
+        ~WavWriter();
+        bool open(const std::string& path, int sampleRate, int channels);
+        bool write(const unsigned char* data, size_t size);
+        void close();
+        bool isOpen();
+        uint64_t samples();
+    private:
+        void writeHeader(uint32_t dataSize);
+
+        std::ofstream file;
+        int sampleRate;
+        int channels;
+        uint64_t dataSize;
+    };
+
+
+};
+
+
+#endif//_WAVWRITER_H_
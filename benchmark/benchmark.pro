@@ -0,0 +1,42 @@
+TEMPLATE = app
+TARGET = CppPlayerBenchmark
+
+CONFIG += console c++11
+CONFIG -= app_bundle qt
+
+SOURCES += \
+    main.cpp \
+    ../AsyncLogger.cpp \
+    ../DecoderPool.cpp \
+    ../FrameCache.cpp \
+    ../FrameConverter.cpp \
+    ../MediaIO.cpp \
+    ../MediaSink.cpp \
+    ../MediaUse.cpp \
+    ../PipelineTrace.cpp \
+    ../PlaybackStats.cpp \
+    ../PlayerEngine.cpp \
+    ../QualityController.cpp \
+    ../SubtitleDecoder.cpp \
+    ../WavWriter.cpp
+
+HEADERS += \
+    ../AsyncLogger.h \
+    ../DecoderPool.h \
+    ../FrameCache.h \
+    ../FrameConverter.h \
+    ../MediaIO.h \
+    ../MediaSink.h \
+    ../MediaUse.h \
+    ../PipelineTrace.h \
+    ../PlaybackStats.h \
+    ../PlayerEngine.h \
+    ../QualityController.h \
+    ../SubtitleDecoder.h \
+    ../WavWriter.h
+
+INCLUDEPATH += $$PWD/.. $$PWD/../ffmpeg/include
+LIBS += -L$$PWD/../ffmpeg/lib -lavcodec -lavutil -lavformat -lswresample -lswscale
+
+unix: LIBS += -lpthread
+win32: LIBS += -lpsapi
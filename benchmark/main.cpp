@@ -0,0 +1,584 @@
+/**
+* @File name:    main.cpp
+* @Author:       Li
+* @Version:      1.0
+* @Date:         2026-10-19
+* @Description:  CppPlayer解码基准测试（无界面、不限速）：用PlayerEngine的离线模式播放，视频和音频输出为计数的空输出，
+*                统计每个片段的帧率、CPU时间、堆分配次数和峰值内存，结果输出为JSON
+*                用法：CppPlayerBenchmark [--out result.json] [--frames N] [--instances M] [--pool T]
+*                                         [--io default|cache|mmap] [--throttle latencyUs,bytesPerSec] clip...
+*                --instances同时播放M个实例（模拟多画面监控墙），--pool使用T个线程的共享解码调度器（0为CPU核心数），
+*                --io选择本地文件的IO模式，--throttle给读取附加固定延迟和带宽限制（模拟NFS等慢速存储），
+*                两者用于比较块缓存的命中率和系统调用次数
+*                测试片段由同目录下的make_clips.sh生成
+**/
+
+
+#include <new>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cinttypes>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libavutil/avutil.h"
+}
+#include "PlayerEngine.h"
+
+using namespace MediaUse;
+
+
+
+namespace {
+
+    //C++堆分配计数（FFmpeg内部的av_malloc不经过operator new，不计入）
+    std::atomic<uint64_t> allocCount(0);
+    std::atomic<uint64_t> allocBytes(0);
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  命令行参数
+    **/
+    struct Options {
+        std::string out;//为空时输出到stdout
+        int64_t maxFrames;//每个片段最多输出的视频帧数，0表示全部
+        int instances;//每个片段同时播放的实例数
+        int poolThreads;//共享解码调度器的线程数，-1表示不使用调度器
+        uint8_t ioMode;//MEDIAIO_MODE_xxx
+        int throttleLatencyUs;//限速读取的固定延迟，0表示没有
+        int64_t throttleBytesPerSecond;//限速读取的带宽，0表示不限
+        std::vector<std::string> clips;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  丢弃视频帧并计数，记录图像尺寸和pts范围
+    **/
+    class CountingVideoSink :public NullVideoSink {
+    public:
+        CountingVideoSink() :width(0), height(0), frames(0), firstPts(INT64_MAX), lastPts(0) {}
+        bool open(int width, int height) override {
+            this->width = width;
+            this->height = height;
+            return NullVideoSink::open(width, height);
+        }
+        void present(int64_t pts) override {
+            NullVideoSink::present(pts);
+            if (pts < this->firstPts) this->firstPts = pts;
+            if (pts > this->lastPts) this->lastPts = pts;
+            this->frames++;
+        }
+        int width;
+        int height;
+        std::atomic<int64_t> frames;
+        int64_t firstPts;
+        int64_t lastPts;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  不限速地丢弃音频帧并计数，记录pts范围
+    **/
+    class CountingAudioSink :public WavAudioSink {
+    public:
+        CountingAudioSink() :frames(0), firstPts(INT64_MAX), lastPts(0) {}
+        bool write(const AVDataInfo& frame) override {
+            if (frame.pts < this->firstPts) this->firstPts = frame.pts;
+            if (frame.pts > this->lastPts) this->lastPts = frame.pts;
+            this->frames++;
+            return WavAudioSink::write(frame);
+        }
+        int64_t frames;
+        int64_t firstPts;
+        int64_t lastPts;
+    };
+
+
+    /**
+    * @Author:       Li
+    * @Version:      1.0
+    * @Date:         2026-10-19
+    * @Description:  单个片段的测试结果
+    **/
+    struct ClipResult {
+        std::string path;
+        std::string videoCodec;
+        std::string audioCodec;
+        int width;
+        int height;
+        double mediaSeconds;//已处理的媒体时长
+        int64_t videoFrames;
+        int64_t audioFrames;
+        double wallSeconds;
+        double cpuSeconds;
+        uint64_t allocations;
+        uint64_t allocatedBytes;
+        int64_t peakRssKB;//进程峰值常驻内存，需要每个片段单独的数据请每个进程只测一个片段
+        int peakThreads;//播放期间进程的最大线程数（仅Linux）
+        std::vector<double> instanceFps;//每个实例的视频帧率
+        std::vector<double> instanceUnits;//每个实例在调度器中的吞吐量（packet+帧/s），未使用调度器时为空
+        AVIOStats io;//所有实例的自定义IO统计之和，未使用自定义IO时全为0
+        bool ok;
+    };
+
+}
+
+
+void* operator new(size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        进程已消耗的CPU时间（用户态+内核态，所有线程）
+* @Param:        void
+* @Return:       double 秒
+**/
+static double processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME create, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &create, &exit, &kernel, &user)) return 0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) / 1e7;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        进程峰值常驻内存
+* @Param:        void
+* @Return:       int64_t KB
+**/
+static int64_t peakRssKB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return (int64_t)(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;//macOS单位为字节
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        进程当前的线程数，读取/proc/self/status，其他平台返回0
+* @Param:        void
+* @Return:       int
+**/
+static int threadCount() {
+    int count = 0;
+#ifdef __linux__
+    char line[256] = { 0 };
+    FILE* file = fopen("/proc/self/status", "r");
+    if (!file) return 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "Threads:", 8) == 0) {
+            count = atoi(line + 8);
+            break;
+        }
+    }
+    fclose(file);
+#endif
+    return count;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        读取片段的音视频编码名（不计入测试时间）
+* @Param:        @path const std::string& 片段路径
+* @Param:        @result ClipResult& 结果
+* @Return:       void
+**/
+static void probeCodecs(const std::string& path, ClipResult& result) {
+    AVFormatContext* formatContext = nullptr;
+    int index = -1;
+    if (avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr) != 0) return;
+    if (avformat_find_stream_info(formatContext, nullptr) >= 0) {
+        index = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        if (index >= 0) result.videoCodec = avcodec_get_name(formatContext->streams[index]->codecpar->codec_id);
+        index = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+        if (index >= 0) result.audioCodec = avcodec_get_name(formatContext->streams[index]->codecpar->codec_id);
+    }
+    avformat_close_input(&formatContext);
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        测试一个片段：同时启动options.instances个PlayerEngine，离线模式不限速播放，直到全部播放结束或达到帧数上限
+* @Param:        @path const std::string& 片段路径
+* @Param:        @options const Options& 参数
+* @Param:        @result ClipResult& 结果
+* @Return:       bool 打开失败返回false
+**/
+static bool benchmarkClip(const std::string& path, const Options& options, ClipResult& result) {
+    int count = options.instances;
+    std::vector<PlayerEngine*> engines;
+    std::vector<CountingVideoSink*> videoSinks;
+    std::vector<CountingAudioSink*> audioSinks;
+    std::vector<std::atomic<bool>*> ended;
+    std::vector<PlaybackStats> lastStats;
+    std::vector<double> wallSeconds;
+    bool opened = true;
+    bool running = true;
+    int64_t firstPts = INT64_MAX;
+    int64_t lastPts = 0;
+    uint64_t allocStart = 0;
+    uint64_t allocBytesStart = 0;
+    double cpuStart = 0;
+    std::chrono::steady_clock::time_point wallStart;
+
+    result = ClipResult();
+    result.path = path;
+    result.ok = false;
+    result.peakThreads = 0;
+    probeCodecs(path, result);
+
+    for (int i = 0; i < count; i++) {
+        engines.push_back(new PlayerEngine);
+        videoSinks.push_back(new CountingVideoSink);
+        audioSinks.push_back(new CountingAudioSink);
+        ended.push_back(new std::atomic<bool>(false));
+        std::atomic<bool>* flag = ended[i];
+        engines[i]->setOfflineMode(true);
+        engines[i]->setVideoSink(videoSinks[i]);
+        engines[i]->setAudioSink(audioSinks[i]);
+        engines[i]->setEndCallback([flag]() { *flag = true; });
+        if (options.poolThreads >= 0) {
+            DecoderPool::global().start(options.poolThreads);
+            engines[i]->setDecoderPool(&DecoderPool::global());
+        }
+        engines[i]->setIOMode(options.ioMode);
+        engines[i]->setIOThrottle(options.throttleLatencyUs, options.throttleBytesPerSecond);
+        engines[i]->setPath(path);
+        engines[i]->setLogLevel(ASYNCLOGGER_LEVEL_ERROR);
+        if (!engines[i]->avOpen()) opened = false;
+    }
+    lastStats.resize(count);
+    wallSeconds.resize(count, 0);
+
+    if (opened) {
+        allocStart = allocCount.load();
+        allocBytesStart = allocBytes.load();
+        cpuStart = processCpuSeconds();
+        wallStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            engines[i]->avStart();
+        }
+        while (running) {
+            running = false;
+            for (int i = 0; i < count; i++) {
+                if (wallSeconds[i] > 0) continue;
+                if (*ended[i] || engines[i]->getPlayStatus() == CPPPLAYER_AV_STOP ||//出错时引擎直接停止，不会调用结束回调
+                    (options.maxFrames > 0 && videoSinks[i]->frames >= options.maxFrames)) {
+                    wallSeconds[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+                    lastStats[i] = engines[i]->getStats();//调度器统计在avStop后注销
+                    continue;
+                }
+                running = true;
+            }
+            result.peakThreads = std::max(result.peakThreads, threadCount());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        result.cpuSeconds = processCpuSeconds() - cpuStart;
+        for (int i = 0; i < count; i++) {
+            engines[i]->avStop();
+        }
+        result.allocations = allocCount.load() - allocStart;
+        result.allocatedBytes = allocBytes.load() - allocBytesStart;
+        result.peakRssKB = peakRssKB();
+        result.ok = true;
+        for (int i = 0; i < count; i++) {
+            result.width = videoSinks[i]->width;
+            result.height = videoSinks[i]->height;
+            result.videoFrames += videoSinks[i]->frames;
+            result.audioFrames += audioSinks[i]->frames;
+            firstPts = std::min(videoSinks[i]->firstPts, audioSinks[i]->firstPts);
+            lastPts = std::max(videoSinks[i]->lastPts, audioSinks[i]->lastPts);
+            if (firstPts != INT64_MAX) {
+                result.mediaSeconds += (lastPts - firstPts) / (double)AV_TIME_BASE;
+            }
+            result.instanceFps.push_back(wallSeconds[i] > 0 ? videoSinks[i]->frames / wallSeconds[i] : 0);
+            if (options.poolThreads >= 0) {
+                result.instanceUnits.push_back(lastStats[i].poolThroughput);
+            }
+            result.ok = result.ok && (*ended[i] || (options.maxFrames > 0 && videoSinks[i]->frames >= options.maxFrames));
+            AVIOStats io = engines[i]->getIOStats();//avStop后为最后一次的统计
+            result.io.bytesRead += io.bytesRead;
+            result.io.bytesDelivered += io.bytesDelivered;
+            result.io.syscalls += io.syscalls;
+            result.io.cacheHits += io.cacheHits;
+            result.io.cacheMisses += io.cacheMisses;
+            result.io.prefetched += io.prefetched;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        delete engines[i];
+        delete videoSinks[i];
+        delete audioSinks[i];
+        delete ended[i];
+    }
+    return opened;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        转义JSON字符串中的引号、反斜杠和控制字符
+* @Param:        @str const std::string& 原字符串
+* @Return:       std::string
+**/
+static std::string jsonEscape(const std::string& str) {
+    std::string out;
+    char buf[8] = { 0 };
+    for (size_t i = 0; i < str.size(); i++) {
+        unsigned char c = (unsigned char)str[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        }
+        else if (c < 0x20) {
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        }
+        else {
+            out += (char)c;
+        }
+    }
+    return out;
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        把测试结果写为JSON
+* @Param:        @file FILE* 输出
+* @Param:        @options const Options& 参数
+* @Param:        @results const std::vector<ClipResult>& 结果
+* @Return:       void
+**/
+static void writeJson(FILE* file, const Options& options, const std::vector<ClipResult>& results) {
+    fprintf(file, "{\n  \"ffmpeg\": \"%s\",\n  \"maxFrames\": %" PRId64 ",\n  \"instances\": %d,\n  \"poolThreads\": %d,\n",
+        jsonEscape(av_version_info()).c_str(), options.maxFrames, options.instances, options.poolThreads);
+    fprintf(file, "  \"ioMode\": %d,\n  \"throttleLatencyUs\": %d,\n  \"throttleBytesPerSecond\": %" PRId64 ",\n  \"clips\": [",
+        options.ioMode, options.throttleLatencyUs, options.throttleBytesPerSecond);
+    for (size_t i = 0; i < results.size(); i++) {
+        const ClipResult& r = results[i];
+        double videoFps = r.wallSeconds > 0 ? r.videoFrames / r.wallSeconds : 0;
+        double realtime = r.wallSeconds > 0 ? r.mediaSeconds / r.wallSeconds : 0;
+        fprintf(file, "%s\n    {\n", i ? "," : "");
+        fprintf(file, "      \"path\": \"%s\",\n      \"ok\": %s,\n", jsonEscape(r.path).c_str(), r.ok ? "true" : "false");
+        fprintf(file, "      \"videoCodec\": \"%s\",\n      \"audioCodec\": \"%s\",\n      \"width\": %d,\n      \"height\": %d,\n",
+            jsonEscape(r.videoCodec).c_str(), jsonEscape(r.audioCodec).c_str(), r.width, r.height);
+        fprintf(file, "      \"mediaSeconds\": %.3f,\n      \"videoFrames\": %" PRId64 ",\n      \"audioFrames\": %" PRId64 ",\n",
+            r.mediaSeconds, r.videoFrames, r.audioFrames);
+        fprintf(file, "      \"wallSeconds\": %.3f,\n      \"cpuSeconds\": %.3f,\n      \"videoFps\": %.2f,\n      \"realtimeFactor\": %.2f,\n",
+            r.wallSeconds, r.cpuSeconds, videoFps, realtime);
+        fprintf(file, "      \"cpuSecondsPerMediaSecond\": %.4f,\n", r.mediaSeconds > 0 ? r.cpuSeconds / r.mediaSeconds : 0);
+        fprintf(file, "      \"allocations\": %" PRIu64 ",\n      \"allocatedBytes\": %" PRIu64 ",\n      \"allocationsPerFrame\": %.2f,\n",
+            r.allocations, r.allocatedBytes, r.videoFrames + r.audioFrames ? (double)r.allocations / (r.videoFrames + r.audioFrames) : 0);
+        fprintf(file, "      \"peakRssKB\": %" PRId64 ",\n      \"peakThreads\": %d,\n", r.peakRssKB, r.peakThreads);
+        fprintf(file, "      \"ioBytesRead\": %" PRIu64 ",\n      \"ioSyscalls\": %" PRIu64 ",\n      \"ioCacheHits\": %" PRIu64 ",\n"
+            "      \"ioCacheMisses\": %" PRIu64 ",\n      \"ioPrefetched\": %" PRIu64 ",\n      \"ioHitRate\": %.4f,\n",
+            r.io.bytesRead, r.io.syscalls, r.io.cacheHits, r.io.cacheMisses, r.io.prefetched, r.io.hitRate());
+        fprintf(file, "      \"instanceFps\": [");
+        for (size_t j = 0; j < r.instanceFps.size(); j++) {
+            fprintf(file, "%s%.2f", j ? ", " : "", r.instanceFps[j]);
+        }
+        fprintf(file, "],\n      \"instanceUnitsPerSecond\": [");
+        for (size_t j = 0; j < r.instanceUnits.size(); j++) {
+            fprintf(file, "%s%.1f", j ? ", " : "", r.instanceUnits[j]);
+        }
+        fprintf(file, "]\n    }");
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+/**
+* @Author:       Li
+* @Date:         2026-10-19
+* @Version:      1.0
+* @Brief:        解析命令行参数
+* @Param:        @argc int
+* @Param:        @argv char**
+* @Param:        @options Options& 输出
+* @Return:       bool 参数错误返回false
+**/
+static bool parseOptions(int argc, char** argv, Options& options) {
+    options.maxFrames = 0;
+    options.instances = 1;
+    options.poolThreads = -1;
+    options.ioMode = MEDIAIO_MODE_DEFAULT;
+    options.throttleLatencyUs = 0;
+    options.throttleBytesPerSecond = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        }
+        else if (arg == "--frames" && hasValue) {
+            options.maxFrames = strtoll(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--instances" && hasValue) {
+            options.instances = atoi(argv[++i]);
+            if (options.instances < 1) return false;
+        }
+        else if (arg == "--pool" && hasValue) {
+            options.poolThreads = atoi(argv[++i]);
+            if (options.poolThreads < 0) return false;
+        }
+        else if (arg == "--io" && hasValue) {
+            std::string mode = argv[++i];
+            if (mode == "default") options.ioMode = MEDIAIO_MODE_DEFAULT;
+            else if (mode == "cache") options.ioMode = MEDIAIO_MODE_CACHE;
+            else if (mode == "mmap") options.ioMode = MEDIAIO_MODE_MMAP;
+            else return false;
+        }
+        else if (arg == "--throttle" && hasValue) {//latencyUs,bytesPerSec
+            char* end = nullptr;
+            options.throttleLatencyUs = (int)strtol(argv[++i], &end, 10);
+            if (*end != ',') return false;
+            options.throttleBytesPerSecond = strtoll(end + 1, &end, 10);
+            if (*end != '\0' || options.throttleLatencyUs < 0 || options.throttleBytesPerSecond < 0) return false;
+        }
+        else if (arg.size() > 1 && arg[0] == '-') {
+            return false;
+        }
+        else {
+            options.clips.push_back(arg);
+        }
+    }
+    return !options.clips.empty();
+}
+
+
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::vector<ClipResult> results;
+    FILE* file = stdout;
+
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--out result.json] [--frames N] [--instances M] [--pool T] [--io default|cache|mmap] "
+            "[--throttle latencyUs,bytesPerSec] clip...\n", argv[0]);
+        return 2;
+    }
+    av_log_set_level(AV_LOG_ERROR);
+    for (size_t i = 0; i < options.clips.size(); i++) {
+        ClipResult result;
+        if (!benchmarkClip(options.clips[i], options, result)) {
+            fprintf(stderr, "failed to open %s\n", options.clips[i].c_str());
+        }
+        else {
+            fprintf(stderr, "%s: %" PRId64 " video frames in %.2f s (%.1f fps)\n", options.clips[i].c_str(),
+                result.videoFrames, result.wallSeconds, result.wallSeconds > 0 ? result.videoFrames / result.wallSeconds : 0.0);
+            if (result.io.syscalls > 0) {
+                fprintf(stderr, "    io: %" PRIu64 " syscalls  %" PRIu64 " bytes read  cache hit rate %.1f%%\n",
+                    result.io.syscalls, result.io.bytesRead, result.io.hitRate() * 100);
+            }
+        }
+        results.push_back(result);
+    }
+    if (!options.out.empty()) {
+        file = fopen(options.out.c_str(), "w");
+        if (!file) {
+            fprintf(stderr, "can not write %s\n", options.out.c_str());
+            return 1;
+        }
+    }
+    writeJson(file, options, results);
+    if (file != stdout) fclose(file);
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!results[i].ok) return 1;
+    }
+    return 0;
+}
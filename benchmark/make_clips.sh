@@ -0,0 +1,52 @@
+#!/bin/sh
+# 生成基准测试片段并逐个运行CppPlayerBenchmark（每个片段一个进程，峰值内存按片段统计）
+# 用法：make_clips.sh [片段目录] [结果目录] [时长(秒)]
+# 需要PATH中的ffmpeg；CppPlayerBenchmark默认在当前目录，可用BENCHMARK环境变量指定
+# 缺少的编码器（libx265、libvpx-vp9、libsvtav1/libaom-av1、libopus）会跳过对应片段
+
+CLIPS=${1:-clips}
+RESULTS=${2:-results}
+SECONDS_=${3:-10}
+BENCHMARK=${BENCHMARK:-./CppPlayerBenchmark}
+
+mkdir -p "$CLIPS" "$RESULTS" || exit 1
+ENCODERS=$(ffmpeg -hide_banner -encoders 2>/dev/null)
+
+has_encoder() {
+    echo "$ENCODERS" | grep -q " $1 "
+}
+
+av1_encoder() {
+    if has_encoder libsvtav1; then echo "libsvtav1 -preset 10"
+    elif has_encoder libaom-av1; then echo "libaom-av1 -cpu-used 8 -row-mt 1"
+    fi
+}
+
+# 名字 视频编码器及参数 音频编码器及参数 容器
+make_clip() {
+    name=$1; size=$2; vcodec=$3; acodec=$4; ext=$5
+    out="$CLIPS/$name.$ext"
+    [ -f "$out" ] && return 0
+    echo "generating $out"
+    ffmpeg -hide_banner -loglevel error -y \
+        -f lavfi -i "testsrc2=size=$size:rate=30:duration=$SECONDS_" \
+        -f lavfi -i "sine=frequency=440:sample_rate=48000:duration=$SECONDS_" \
+        -ac 2 -pix_fmt yuv420p -g 60 -c:v $vcodec -c:a $acodec "$out"
+}
+
+for res in 854x480:480p 1280x720:720p 1920x1080:1080p 3840x2160:2160p; do
+    size=${res%%:*}; tag=${res##*:}
+    has_encoder libx264 && make_clip "h264_aac_$tag" $size "libx264 -preset veryfast" "aac -b:a 128k" mp4
+    has_encoder libx265 && make_clip "hevc_flac_$tag" $size "libx265 -preset veryfast -tag:v hvc1" "flac" mkv
+    has_encoder libvpx-vp9 && has_encoder libopus && \
+        make_clip "vp9_opus_$tag" $size "libvpx-vp9 -deadline realtime -cpu-used 8 -row-mt 1" "libopus -b:a 128k" webm
+    av1=$(av1_encoder)
+    [ -n "$av1" ] && has_encoder libopus && make_clip "av1_opus_$tag" $size "$av1" "libopus -b:a 128k" mkv
+done
+
+status=0
+for clip in "$CLIPS"/*; do
+    name=$(basename "$clip")
+    "$BENCHMARK" --out "$RESULTS/${name%.*}.json" "$clip" || status=1
+done
+exit $status
@@ -2,10 +2,17 @@
 #include<QMessageBox>
 #include<QDir>
 #include<QFileDialog>
+#include<QTimer>
+#include<QImage>
 #include<string>
+#include<vector>
+#include<chrono>
+#include<cstdlib>
+#include<iostream>
 
 #include"CppPlayer.h"
 #include"AVPlayer.h"
+#include"VideoWall.h"
 
 int main(int argc, char *argv[])
 {
@@ -13,13 +20,85 @@ int main(int argc, char *argv[])
     QApplication a(argc, argv);
 
     //资源初始化
-    CppPlayer::resourceInit();
+    MediaUse::OpenALAudioSink::resourceInit();
+
+    //离线处理：test --offline 文件 [--wav 音频输出.wav]，不显示窗口，处理完毕后输出吞吐量并退出
+    std::string offlinePath;
+    std::string wavPath;
+    std::vector<std::string> wallPaths;
+    std::string grabPath;
+    long long grabFrames = 0;
+    bool fastStart = false;
+    for(int i = 1; i < argc; i++){
+        if(std::string(argv[i]) == "--offline" && i + 1 < argc) offlinePath = argv[++i];
+        else if(std::string(argv[i]) == "--wav" && i + 1 < argc) wavPath = argv[++i];
+        else if(std::string(argv[i]) == "--grab" && i + 1 < argc) grabPath = argv[++i];//多画面截图：--wall ... --grab 输出.png [--frames N]
+        else if(std::string(argv[i]) == "--frames" && i + 1 < argc) grabFrames = strtoll(argv[++i], nullptr, 10);
+        else if(std::string(argv[i]) == "--fast-start") fastStart = true;//多画面快速启动：--wall ... --fast-start
+        else if(std::string(argv[i]) == "--wall"){//多画面：test --wall 文件1 文件2 ...
+            while(i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0) wallPaths.push_back(argv[++i]);
+        }
+    }
+    if(!offlinePath.empty()){
+        CppPlayer player;
+        player.setOfflineMode(true, wavPath);
+        player.getEngine().setPath(offlinePath);
+        if(!player.getEngine().avOpen()){
+            std::cerr << "can not open " << offlinePath << std::endl;
+            return 1;
+        }
+        QObject::connect(&player, &CppPlayer::playerEnd, &player, [&player](){
+            std::cout << player.getEngine().getOfflineReport() << std::endl;
+            player.getEngine().avStop();
+            QApplication::quit();
+        }, Qt::QueuedConnection);
+        player.getEngine().avStart();
+        int ret = a.exec();
+        MediaUse::OpenALAudioSink::releaseResource();
+        return ret;
+    }
+
+    if(!wallPaths.empty()){
+        VideoWall wall;
+        wall.setFastStart(fastStart);
+        for(const std::string& path : wallPaths){
+            if(wall.addStream(path) < 0) std::cerr << "can not open " << path << std::endl;
+        }
+        wall.resize(1280, 720);
+        wall.show();
+        wall.start();
+        //截图：合成上传了N帧（默认每路一帧）或等待10s后，把所有画面合成到离屏FBO保存，输出合成统计并退出
+        QTimer grabTimer;
+        int grabRet = 1;
+        std::chrono::steady_clock::time_point grabStart = std::chrono::steady_clock::now();
+        if(!grabPath.empty()){
+            if(grabFrames <= 0) grabFrames = wall.streamCount();
+            QObject::connect(&grabTimer, &QTimer::timeout, &wall, [&](){
+                if(wall.getUploadCount() < (uint64_t)grabFrames){
+                    if(std::chrono::steady_clock::now() - grabStart < std::chrono::seconds(10)) return;
+                    std::cerr << "only " << wall.getUploadCount() << " frames composited before timeout" << std::endl;
+                }
+                grabTimer.stop();
+                QImage image = wall.grabComposite(wall.width(), wall.height());
+                if(image.isNull() || !image.save(QString::fromStdString(grabPath))) std::cerr << "can not grab " << grabPath << std::endl;
+                else grabRet = 0;
+                QApplication::quit();
+            });
+            grabTimer.start(20);
+        }
+        int ret = a.exec();
+        if(!grabPath.empty()) ret = grabRet;
+        std::cout << wall.getCompositorReport() << std::endl;
+        wall.stop();
+        MediaUse::OpenALAudioSink::releaseResource();
+        return ret;
+    }
 
     AVPlayer w;
     w.show();
 
     //资源释放
-    CppPlayer::releaseResource();
+    MediaUse::OpenALAudioSink::releaseResource();
 
 
     return a.exec();
@@ -10,14 +10,50 @@ CONFIG += c++11
 
 SOURCES += \
     AVPlayer.cpp \
+    AsyncLogger.cpp \
+    AudioAnalyzer.cpp \
+    AudioMixer.cpp \
+    ClipExporter.cpp \
     CppPlayer.cpp \
+    DecoderPool.cpp \
+    FrameCache.cpp \
+    FrameConverter.cpp \
+    MediaIO.cpp \
+    MediaSink.cpp \
     MediaUse.cpp \
+    OpenALAudioSink.cpp \
+    PipelineTrace.cpp \
+    PlaybackStats.cpp \
+    PlayerEngine.cpp \
+    QualityController.cpp \
+    SubtitleDecoder.cpp \
+    ThumbnailService.cpp \
+    VideoWall.cpp \
+    WavWriter.cpp \
     main.cpp
 
 HEADERS += \
     AVPlayer.h \
+    AsyncLogger.h \
+    AudioAnalyzer.h \
+    AudioMixer.h \
+    ClipExporter.h \
     CppPlayer.h \
-    MediaUse.h
+    DecoderPool.h \
+    FrameCache.h \
+    FrameConverter.h \
+    MediaIO.h \
+    MediaSink.h \
+    MediaUse.h \
+    OpenALAudioSink.h \
+    PipelineTrace.h \
+    PlaybackStats.h \
+    PlayerEngine.h \
+    QualityController.h \
+    SubtitleDecoder.h \
+    ThumbnailService.h \
+    VideoWall.h \
+    WavWriter.h
 
 FORMS +=
 